@@ -31,6 +31,9 @@
 #include "HomeMaticCentral.h"
 #include "Interfaces.h"
 #include "BidCoSDeviceTypes.h"
+#include "BidCoSLatencyStatistics.h"
+#include "BidCoSSendExecutor.h"
+#include "BidCoSVariableJournal.h"
 #include <homegear-base/BaseLib.h>
 #include "GD.h"
 
@@ -46,6 +49,15 @@ BidCoS::BidCoS(BaseLib::SharedObjects* bl, BaseLib::Systems::IFamilyEventSink* e
 	GD::out.printDebug("Debug: Loading module...");
     GD::interfaces = std::make_shared<Interfaces>(bl, _settings->getPhysicalInterfaceSettings());
     _physicalInterfaces = GD::interfaces;
+	int32_t sendExecutorThreads = GD::settings->getNumber("sendexecutorthreads");
+	if(sendExecutorThreads <= 0) sendExecutorThreads = 4;
+	int32_t sendExecutorMaxThreads = GD::settings->getNumber("sendexecutormaxthreads");
+	if(sendExecutorMaxThreads <= 0) sendExecutorMaxThreads = 32;
+	GD::sendExecutor = std::make_shared<BidCoSSendExecutor>(sendExecutorThreads, sendExecutorMaxThreads);
+	int32_t journalFlushInterval = GD::settings->getNumber("journalflushinterval");
+	if(journalFlushInterval <= 0) journalFlushInterval = 1000;
+	GD::variableJournal = std::make_shared<BidCoSVariableJournal>(journalFlushInterval);
+	GD::latencyStatistics = std::make_shared<BidCoSLatencyStatistics>();
 }
 
 BidCoS::~BidCoS()
@@ -56,8 +68,12 @@ BidCoS::~BidCoS()
 void BidCoS::dispose()
 {
 	if(_disposed) return;
+	//Write journaled peer variables while the peers are still available. Peers write their variables directly afterwards.
+	if(GD::variableJournal) GD::variableJournal->dispose();
 	DeviceFamily::dispose();
 	_central.reset();
+	//Queues still referencing the executor keep it alive, but no tasks are executed anymore.
+	if(GD::sendExecutor) GD::sendExecutor->dispose();
     GD::interfaces.reset();
     _physicalInterfaces.reset();
 }
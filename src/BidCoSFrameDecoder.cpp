@@ -0,0 +1,153 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "BidCoSFrameDecoder.h"
+#include "GD.h"
+
+#include <cmath>
+#include <map>
+
+namespace BidCoS
+{
+std::mutex BidCoSFrameDecoder::_decodersMutex;
+std::unordered_map<BaseLib::DeviceDescription::HomegearDevice*, std::shared_ptr<BidCoSFrameDecoder>> BidCoSFrameDecoder::_decoders;
+
+std::shared_ptr<BidCoSFrameDecoder> BidCoSFrameDecoder::get(const BaseLib::DeviceDescription::PHomegearDevice& device)
+{
+	if(!device) return std::shared_ptr<BidCoSFrameDecoder>();
+	std::lock_guard<std::mutex> decodersGuard(_decodersMutex);
+	auto decoderIterator = _decoders.find(device.get());
+	if(decoderIterator != _decoders.end() && decoderIterator->second->isDecoderFor(device)) return decoderIterator->second;
+
+	//Device descriptions are only replaced on reload, so this is a good time to remove decoders of deleted descriptions.
+	for(auto i = _decoders.begin(); i != _decoders.end();)
+	{
+		if(i->second->_device.expired()) i = _decoders.erase(i);
+		else ++i;
+	}
+
+	auto decoder = std::make_shared<BidCoSFrameDecoder>(device);
+	_decoders[device.get()] = decoder;
+	return decoder;
+}
+
+BidCoSFrameDecoder::BidCoSFrameDecoder(const BaseLib::DeviceDescription::PHomegearDevice& device)
+{
+	try
+	{
+		_device = device;
+		_devicePointer = device.get();
+		if(!device) return;
+		if(!device->functions.empty()) _lastChannel = device->functions.rbegin()->first;
+
+		//Frames with the same message type are compiled in the same order as they are returned by "packetsByMessageType.equal_range".
+		for(auto& packet : device->packetsByMessageType)
+		{
+			if(packet.first == 0 || packet.first > 255 || !packet.second) continue;
+			std::vector<Frame>& frames = _framesByMessageType[packet.first];
+			frames.emplace_back();
+			compileFrame(device, packet.second, frames.back());
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSFrameDecoder::compileFrame(const BaseLib::DeviceDescription::PHomegearDevice& device, const BaseLib::DeviceDescription::PPacket& packet, Frame& frame)
+{
+	frame.frame = packet;
+	frame.subtype = packet->subtype;
+	if(packet->subtype > -1 && packet->subtypeIndex >= 9) frame.subtypePayloadIndex = packet->subtypeIndex - 9;
+	if(packet->channelIndex >= 9) frame.channelPayloadIndex = packet->channelIndex - 9;
+	if(packet->channelSize < 1.0) frame.channelMask = 0xFF >> (8 - std::lround(packet->channelSize * 10) % 10);
+	frame.fixedChannel = packet->channel;
+	frame.length = packet->length;
+
+	//Assign slots in the order of the parameter IDs, so values are processed in the same order as before.
+	std::map<std::string, uint32_t> slots;
+	for(auto& binaryPayload : packet->binaryPayloads)
+	{
+		for(auto& variable : packet->associatedVariables)
+		{
+			if(variable->physical->groupId == binaryPayload->parameterId) slots.emplace(variable->id, 0);
+		}
+	}
+	for(auto& slot : slots)
+	{
+		slot.second = frame.slotCount++;
+	}
+
+	for(auto& binaryPayload : packet->binaryPayloads)
+	{
+		BinaryPayload compiledPayload;
+		if(binaryPayload->size > 0 && binaryPayload->index > 0)
+		{
+			compiledPayload.fromPacket = true;
+			compiledPayload.minPayloadSize = ((int32_t)binaryPayload->index) - 8;
+			compiledPayload.position = BidCoSPacketPosition(binaryPayload->index, binaryPayload->size, -1);
+		}
+		else if(binaryPayload->constValueInteger > -1) GD::bl->hf.memcpyBigEndian(compiledPayload.constValue, binaryPayload->constValueInteger);
+		else continue;
+		compiledPayload.constValueInteger = binaryPayload->constValueInteger;
+
+		compiledPayload.variablesBegin = frame.variables.size();
+		for(auto& variable : packet->associatedVariables)
+		{
+			if(variable->physical->groupId != binaryPayload->parameterId || !variable->parent()) continue;
+			frame.variables.emplace_back();
+			Variable& compiledVariable = frame.variables.back();
+			compiledVariable.parameter = variable;
+			compiledVariable.symbol = BidCoSParameterSymbols::get(variable->id);
+			compiledVariable.parameterSetType = variable->parent()->type();
+			compiledVariable.slot = slots.at(variable->id);
+			for(int32_t channel = 0; channel <= _lastChannel && channel < (signed)maxStaticChannels; channel++)
+			{
+				BaseLib::DeviceDescription::PParameterGroup parameterGroup = getStaticParameterGroup(device, channel, compiledVariable.parameterSetType);
+				if(!parameterGroup) continue;
+				compiledVariable.staticChannels.set(channel);
+				if(parameterGroup->parameters.find(variable->id) != parameterGroup->parameters.end()) compiledVariable.channelsWithVariable.set(channel);
+			}
+		}
+		compiledPayload.variablesEnd = frame.variables.size();
+		frame.binaryPayloads.push_back(std::move(compiledPayload));
+	}
+}
+
+BaseLib::DeviceDescription::PParameterGroup BidCoSFrameDecoder::getStaticParameterGroup(const BaseLib::DeviceDescription::PHomegearDevice& device, uint32_t channel, BaseLib::DeviceDescription::ParameterGroup::Type::Enum type)
+{
+	//Channels with alternative functions, unknown channels and missing parameter sets are resolved by the peer, which also logs the warnings.
+	auto functionIterator = device->functions.find(channel);
+	if(functionIterator == device->functions.end() || !functionIterator->second) return BaseLib::DeviceDescription::PParameterGroup();
+	if(functionIterator->second->parameterGroupSelector && !functionIterator->second->alternativeFunctions.empty()) return BaseLib::DeviceDescription::PParameterGroup();
+	return functionIterator->second->getParameterGroup(type);
+}
+
+}
@@ -0,0 +1,170 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef BIDCOSFRAMEDECODER_H_
+#define BIDCOSFRAMEDECODER_H_
+
+#include <cstdint>
+
+#include <homegear-base/BaseLib.h>
+#include "BidCoSPacket.h"
+#include "BidCoSParameterSymbols.h"
+
+#include <array>
+#include <bitset>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace BidCoS
+{
+
+/**
+ * Decode program for the received packets of one device description. The frames of the device description are compiled once when the decoder
+ * is created: Frames are grouped by message type, the bit positions of all binary payloads are resolved and the associated variables of each
+ * binary payload are looked up. Decoding a packet then only walks flat vectors and needs neither string lookups nor map insertions.
+ * Decoders are shared between all peers using the same device description.
+ */
+class BidCoSFrameDecoder
+{
+public:
+	/**
+	 * The number of channels of which parameter sets are resolved in advance. Higher channels are resolved on each packet.
+	 */
+	static constexpr uint32_t maxStaticChannels = 256;
+	typedef std::bitset<maxStaticChannels> ChannelMask;
+
+	/**
+	 * A variable set by a binary payload.
+	 */
+	struct Variable
+	{
+		BaseLib::DeviceDescription::PParameter parameter;
+
+		/**
+		 * The ID of the parameter name assigned by BidCoSParameterSymbols.
+		 */
+		uint32_t symbol = 0;
+		BaseLib::DeviceDescription::ParameterGroup::Type::Enum parameterSetType = BaseLib::DeviceDescription::ParameterGroup::Type::Enum::none;
+
+		/**
+		 * Index of the variable's value in "FrameValues::values". Slots are sorted by parameter ID and variables with the same ID share one slot.
+		 */
+		uint32_t slot = 0;
+
+		/**
+		 * Channels with a parameter set that doesn't depend on the configuration of the peer. For all other channels the parameter set needs to be
+		 * looked up using the peer.
+		 */
+		ChannelMask staticChannels;
+
+		/**
+		 * Static channels which have the variable in their parameter set.
+		 */
+		ChannelMask channelsWithVariable;
+	};
+
+	struct BinaryPayload
+	{
+		/**
+		 * True when the value is read from the packet, false when the constant value is used.
+		 */
+		bool fromPacket = false;
+
+		/**
+		 * The packet is skipped when the payload has less bytes than this.
+		 */
+		int32_t minPayloadSize = 0;
+		BidCoSPacketPosition position;
+		int32_t constValueInteger = -1;
+
+		/**
+		 * The constant value in big endian format.
+		 */
+		std::vector<uint8_t> constValue;
+
+		/**
+		 * The range of this payload's variables in "Frame::variables".
+		 */
+		uint32_t variablesBegin = 0;
+		uint32_t variablesEnd = 0;
+	};
+
+	struct Frame
+	{
+		BaseLib::DeviceDescription::PPacket frame;
+		int32_t subtype = -1;
+		int32_t subtypePayloadIndex = -1;
+		int32_t channelPayloadIndex = -1;
+		int32_t channelMask = 0xFF;
+		int32_t fixedChannel = -1;
+		int32_t length = -1;
+		uint32_t slotCount = 0;
+		std::vector<BinaryPayload> binaryPayloads;
+		std::vector<Variable> variables;
+	};
+
+	/**
+	 * Returns the decoder for a device description. The decoder is created on first use.
+	 */
+	static std::shared_ptr<BidCoSFrameDecoder> get(const BaseLib::DeviceDescription::PHomegearDevice& device);
+
+	BidCoSFrameDecoder(const BaseLib::DeviceDescription::PHomegearDevice& device);
+	virtual ~BidCoSFrameDecoder() = default;
+
+	/**
+	 * Checks if this decoder was created for the given device description.
+	 */
+	bool isDecoderFor(const BaseLib::DeviceDescription::PHomegearDevice& device) { return device && _devicePointer == device.get() && !_device.expired(); }
+
+	/**
+	 * Returns all frames with the given message type in the order of the device description.
+	 */
+	const std::vector<Frame>& getFrames(uint8_t messageType) const { return _framesByMessageType[messageType]; }
+
+	/**
+	 * Returns the highest channel of the device description.
+	 */
+	int32_t lastChannel() const { return _lastChannel; }
+private:
+	static std::mutex _decodersMutex;
+	static std::unordered_map<BaseLib::DeviceDescription::HomegearDevice*, std::shared_ptr<BidCoSFrameDecoder>> _decoders;
+
+	std::weak_ptr<BaseLib::DeviceDescription::HomegearDevice> _device;
+	BaseLib::DeviceDescription::HomegearDevice* _devicePointer = nullptr;
+	int32_t _lastChannel = 0;
+	std::array<std::vector<Frame>, 256> _framesByMessageType;
+
+	void compileFrame(const BaseLib::DeviceDescription::PHomegearDevice& device, const BaseLib::DeviceDescription::PPacket& packet, Frame& frame);
+	BaseLib::DeviceDescription::PParameterGroup getStaticParameterGroup(const BaseLib::DeviceDescription::PHomegearDevice& device, uint32_t channel, BaseLib::DeviceDescription::ParameterGroup::Type::Enum type);
+};
+
+}
+#endif
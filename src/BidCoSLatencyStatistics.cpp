@@ -0,0 +1,199 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "BidCoSLatencyStatistics.h"
+#include "GD.h"
+
+#include <chrono>
+
+namespace BidCoS
+{
+int32_t BidCoSLatencyStatistics::Histogram::getBucket(int64_t value)
+{
+	if(value < 2 * _subBucketCount) return value < 0 ? 0 : (int32_t)value;
+	if(value >= (1ll << (_maxExponent + 1))) value = (1ll << (_maxExponent + 1)) - 1;
+	int32_t exponent = 63 - __builtin_clzll((uint64_t)value);
+	int32_t subBucket = (int32_t)(value >> (exponent - _subBucketBits)) & (_subBucketCount - 1);
+	return 2 * _subBucketCount + (exponent - _subBucketBits - 1) * _subBucketCount + subBucket;
+}
+
+int64_t BidCoSLatencyStatistics::Histogram::getUpperBound(int32_t bucket)
+{
+	if(bucket < 2 * _subBucketCount) return bucket;
+	int32_t shift = (bucket - 2 * _subBucketCount) / _subBucketCount + 1;
+	int64_t subBucket = (bucket - 2 * _subBucketCount) % _subBucketCount;
+	return ((_subBucketCount + subBucket) << shift) + (1ll << shift) - 1;
+}
+
+void BidCoSLatencyStatistics::Histogram::record(int64_t value)
+{
+	if(value < 0) value = 0;
+	_buckets[getBucket(value)].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(value, std::memory_order_relaxed);
+	int64_t max = _max.load(std::memory_order_relaxed);
+	while(value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+BidCoSLatencyStatistics::Histogram::Snapshot BidCoSLatencyStatistics::Histogram::getSnapshot()
+{
+	Snapshot snapshot;
+	//The buckets are read one by one while values are recorded, so the bucket counts are used as total instead of "_count".
+	std::array<uint64_t, _bucketCount> buckets;
+	for(int32_t i = 0; i < _bucketCount; i++)
+	{
+		buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+		snapshot.count += buckets[i];
+	}
+	if(snapshot.count == 0) return snapshot;
+	uint64_t count = _count.load(std::memory_order_relaxed);
+	snapshot.average = count > 0 ? _sum.load(std::memory_order_relaxed) / (int64_t)count : 0;
+	snapshot.max = _max.load(std::memory_order_relaxed);
+
+	std::array<std::pair<double, int64_t*>, 3> percentiles{ std::make_pair(0.5, &snapshot.p50), std::make_pair(0.9, &snapshot.p90), std::make_pair(0.99, &snapshot.p99) };
+	uint64_t cumulativeCount = 0;
+	uint32_t percentileIndex = 0;
+	for(int32_t i = 0; i < _bucketCount && percentileIndex < percentiles.size(); i++)
+	{
+		cumulativeCount += buckets[i];
+		while(percentileIndex < percentiles.size() && cumulativeCount >= (uint64_t)(percentiles[percentileIndex].first * snapshot.count + 0.5) && cumulativeCount > 0)
+		{
+			*percentiles[percentileIndex].second = std::min(getUpperBound(i), snapshot.max);
+			percentileIndex++;
+		}
+	}
+	return snapshot;
+}
+
+void BidCoSLatencyStatistics::Histogram::reset()
+{
+	for(auto& bucket : _buckets)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	_count.store(0, std::memory_order_relaxed);
+	_sum.store(0, std::memory_order_relaxed);
+	_max.store(0, std::memory_order_relaxed);
+}
+
+int64_t BidCoSLatencyStatistics::now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string BidCoSLatencyStatistics::getStageName(Stage stage)
+{
+	switch(stage)
+	{
+		case Stage::interfaceReceive: return "interfaceReceive";
+		case Stage::dispatch: return "dispatch";
+		case Stage::processingStart: return "processingStart";
+		case Stage::messageHandler: return "messageHandler";
+		case Stage::peerDecode: return "peerDecode";
+		case Stage::databaseSave: return "databaseSave";
+		case Stage::rpcEvent: return "rpcEvent";
+		case Stage::total: return "total";
+		default: return "unknown";
+	}
+}
+
+BidCoSLatencyStatistics::Histograms& BidCoSLatencyStatistics::getHistograms(const std::string& interfaceId)
+{
+	{
+		std::shared_lock<std::shared_mutex> histogramsGuard(_histogramsMutex);
+		auto histogramsIterator = _histograms.find(interfaceId);
+		if(histogramsIterator != _histograms.end()) return *histogramsIterator->second;
+	}
+	std::unique_lock<std::shared_mutex> histogramsGuard(_histogramsMutex);
+	auto& histograms = _histograms[interfaceId];
+	if(!histograms) histograms.reset(new Histograms());
+	return *histograms;
+}
+
+void BidCoSLatencyStatistics::record(const std::string& interfaceId, Stage stage, int64_t microseconds)
+{
+	try
+	{
+		if(stage >= Stage::count) return;
+		//Histograms are never removed, so the reference stays valid after the lock is released.
+		getHistograms(interfaceId)[(size_t)stage].record(microseconds);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+std::vector<BidCoSLatencyStatistics::StageStatistics> BidCoSLatencyStatistics::getStatistics(const std::string& interfaceId)
+{
+	std::vector<StageStatistics> statistics;
+	try
+	{
+		std::shared_lock<std::shared_mutex> histogramsGuard(_histogramsMutex);
+		for(auto& histograms : _histograms)
+		{
+			if(!interfaceId.empty() && histograms.first != interfaceId) continue;
+			for(int32_t i = 0; i < (int32_t)Stage::count; i++)
+			{
+				StageStatistics stageStatistics;
+				stageStatistics.snapshot = histograms.second->at(i).getSnapshot();
+				if(stageStatistics.snapshot.count == 0) continue;
+				stageStatistics.interfaceId = histograms.first;
+				stageStatistics.stage = (Stage)i;
+				statistics.push_back(std::move(stageStatistics));
+			}
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return statistics;
+}
+
+void BidCoSLatencyStatistics::reset()
+{
+	try
+	{
+		std::shared_lock<std::shared_mutex> histogramsGuard(_histogramsMutex);
+		for(auto& histograms : _histograms)
+		{
+			for(auto& histogram : *histograms.second)
+			{
+				histogram.reset();
+			}
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+}
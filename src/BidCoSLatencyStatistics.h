@@ -0,0 +1,149 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef BIDCOSLATENCYSTATISTICS_H_
+#define BIDCOSLATENCYSTATISTICS_H_
+
+#include <cstdint>
+
+#include <homegear-base/BaseLib.h>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace BidCoS
+{
+
+/**
+ * Collects latency histograms of the stages a received packet passes, separately for each interface. All times are microseconds of a monotonic clock
+ * (see "now()"). Recording a value only uses atomic operations. Only the first value of an interface needs to lock.
+ */
+class BidCoSLatencyStatistics
+{
+public:
+	enum class Stage : int32_t
+	{
+		interfaceReceive = 0, //Reception until IBidCoSInterface::processReceivedPacket() is called
+		dispatch, //Reception until HomeMaticCentral::onPacketReceived() is called
+		processingStart, //Reception until HomeMaticCentral::processReceivedPacket() is called
+		messageHandler, //Duration of the message handler
+		peerDecode, //Duration of BidCoSPeer::packetReceived()
+		databaseSave, //Duration of saving one value
+		rpcEvent, //Duration of raising the events of one packet
+		total, //Reception until the peer processed the packet
+		count
+	};
+
+	/**
+	 * HDR style histogram with logarithmic buckets. Each power of two is divided into eight buckets, so values are stored with a maximum error of 12.5 %.
+	 */
+	class Histogram
+	{
+	public:
+		struct Snapshot
+		{
+			uint64_t count = 0;
+			int64_t average = 0;
+			int64_t max = 0;
+			int64_t p50 = 0;
+			int64_t p90 = 0;
+			int64_t p99 = 0;
+		};
+
+		void record(int64_t value);
+		Snapshot getSnapshot();
+		void reset();
+	private:
+		static constexpr int32_t _subBucketBits = 3;
+		static constexpr int32_t _subBucketCount = 1 << _subBucketBits;
+		static constexpr int32_t _maxExponent = 39;
+		static constexpr int32_t _bucketCount = 2 * _subBucketCount + (_maxExponent - _subBucketBits) * _subBucketCount;
+
+		std::array<std::atomic<uint64_t>, _bucketCount> _buckets{};
+		std::atomic<uint64_t> _count{0};
+		std::atomic<int64_t> _sum{0};
+		std::atomic<int64_t> _max{0};
+
+		static int32_t getBucket(int64_t value);
+
+		/**
+		 * Returns the largest value stored in "bucket".
+		 */
+		static int64_t getUpperBound(int32_t bucket);
+	};
+
+	struct StageStatistics
+	{
+		std::string interfaceId;
+		Stage stage = Stage::total;
+		Histogram::Snapshot snapshot;
+	};
+
+	BidCoSLatencyStatistics() = default;
+	virtual ~BidCoSLatencyStatistics() = default;
+
+	/**
+	 * Returns the current time in microseconds of the monotonic clock used by "BidCoSPacket::monotonicTimeReceived()".
+	 */
+	static int64_t now();
+
+	static std::string getStageName(Stage stage);
+
+	void record(const std::string& interfaceId, Stage stage, int64_t microseconds);
+
+	/**
+	 * Records the time since "startTime". Does nothing when "startTime" is 0, e. g. for packets not created from received data.
+	 */
+	void recordSince(const std::string& interfaceId, Stage stage, int64_t startTime) { if(startTime > 0) record(interfaceId, stage, now() - startTime); }
+
+	/**
+	 * Returns the statistics of all stages with at least one value, sorted by interface and stage.
+	 *
+	 * @param interfaceId Only return the statistics of this interface. Returns all statistics when empty.
+	 */
+	std::vector<StageStatistics> getStatistics(const std::string& interfaceId = "");
+
+	void reset();
+private:
+	typedef std::array<Histogram, (size_t)Stage::count> Histograms;
+
+	std::shared_mutex _histogramsMutex;
+	std::map<std::string, std::unique_ptr<Histograms>> _histograms;
+
+	Histograms& getHistograms(const std::string& interfaceId);
+};
+
+}
+#endif
@@ -36,7 +36,16 @@ void BidCoSMessages::add(std::shared_ptr<BidCoSMessage> message)
 {
 	try
 	{
-		_messages.push_back(message);
+		if(!message) return;
+		int32_t messageType = message->getMessageType();
+		if(messageType == -1)
+		{
+			if(!_anyTypeMessage) _anyTypeMessage = message;
+			else GD::out.printWarning("Warning: Tried to register a second message matching any message type.");
+		}
+		else if(messageType < 0 || messageType > 255) GD::out.printError("Error: Tried to register message with invalid message type " + std::to_string(messageType) + ".");
+		else if(_messagesByType[messageType]) GD::out.printWarning("Warning: Tried to register a second message with message type 0x" + BaseLib::HelperFunctions::getHexString(messageType, 2) + ".");
+		else _messagesByType[messageType] = message;
 	}
 	catch(const std::exception& ex)
 	{
@@ -49,11 +58,7 @@ std::shared_ptr<BidCoSMessage> BidCoSMessages::find(std::shared_ptr<BidCoSPacket
 	try
 	{
 		if(!packet) return std::shared_ptr<BidCoSMessage>();
-		for(uint32_t i = 0; i < _messages.size(); i++)
-		{
-			if(_messages[i]->typeIsEqual(packet)) return _messages[i];
-		}
-		return std::shared_ptr<BidCoSMessage>();
+		return _messagesByType[packet->messageType()];
 	}
 	catch(const std::exception& ex)
 	{
@@ -66,10 +71,8 @@ std::shared_ptr<BidCoSMessage> BidCoSMessages::find(int32_t messageType)
 {
 	try
 	{
-		for(uint32_t i = 0; i < _messages.size(); i++)
-		{
-			if(_messages[i]->typeIsEqual(messageType)) return _messages[i];
-		}
+		if(messageType >= 0 && messageType <= 255 && _messagesByType[messageType]) return _messagesByType[messageType];
+		return _anyTypeMessage;
 	}
 	catch(const std::exception& ex)
 	{
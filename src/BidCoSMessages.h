@@ -34,9 +34,9 @@
 
 #include "BidCoSMessage.h"
 
+#include <array>
 #include <iostream>
 #include <memory>
-#include <vector>
 
 namespace BidCoS
 {
@@ -45,12 +45,24 @@ class BidCoSMessages
     public:
         BidCoSMessages() {}
         virtual ~BidCoSMessages() {}
+        /**
+         * Registers a message in the dispatch table. Only one message can be registered per message type.
+         */
         void add(std::shared_ptr<BidCoSMessage> message);
+
+        /**
+         * Returns the message handling the packet's message type in constant time.
+         */
         std::shared_ptr<BidCoSMessage> find(std::shared_ptr<BidCoSPacket> packet);
+
+        /**
+         * Returns the message registered for "messageType". Falls back to the message matching any type (message type -1), if one is registered.
+         */
         std::shared_ptr<BidCoSMessage> find(int32_t messageType);
     protected:
     private:
-        std::vector<std::shared_ptr<BidCoSMessage>> _messages;
+        std::array<std::shared_ptr<BidCoSMessage>, 256> _messagesByType;
+        std::shared_ptr<BidCoSMessage> _anyTypeMessage;
 };
 }
 #endif
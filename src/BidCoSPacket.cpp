@@ -28,29 +28,100 @@
  */
 
 #include "BidCoSPacket.h"
+#include "BidCoSLatencyStatistics.h"
 #include "GD.h"
 
 namespace BidCoS
 {
 
-const std::array<uint8_t, 9> BidCoSPacket::_bitmask{0xFF, 0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF};
+BidCoSPacketPosition::BidCoSPacketPosition(double index, double size, int32_t mask)
+{
+	static const std::array<uint8_t, 9> bitmask{0xFF, 0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF};
+
+	this->mask = mask;
+	if(size < 0)
+	{
+		error = "Error: Negative size not allowed.";
+		return;
+	}
+	if(index < 0)
+	{
+		error = "Error: Packet index < 0 requested.";
+		return;
+	}
+	if(index < 9)
+	{
+		headerIndex = true;
+		if(size > 0.8)
+		{
+			error = "Error: Packet index < 9 and size > 1 requested.";
+			return;
+		}
+		type = Type::header;
+		byteIndex = std::lround(std::floor(index));
+		shift = std::lround(index * 10) % 10;
+		//The round is necessary, because for example (uint32_t)(0.2 * 10) is 1
+		firstByteMask = bitmask[std::lround(size * 10)];
+		return;
+	}
+	index -= 9;
+	double byteIndexDouble = std::floor(index);
+	byteIndex = byteIndexDouble;
+	if(byteIndexDouble != index || size < 0.8) //0.8 == 8 Bits
+	{
+		if(size > 1.0)
+		{
+			error = "Error: Partial byte index > 1 requested.";
+			return;
+		}
+		type = Type::partialByte;
+		uint32_t bitSize = std::lround(size * 10);
+		if(bitSize > 8) bitSize = 8;
+		shift = std::lround(index * 10) % 10;
+		firstByteMask = bitmask[bitSize];
+	}
+	else
+	{
+		type = Type::bytes;
+		bytes = (uint32_t)std::ceil(size);
+		uint32_t bitSize = std::lround(size * 10) % 10;
+		if(bitSize > 8) bitSize = 8;
+		firstByteMask = bitmask[bitSize];
+	}
+}
+
+namespace
+{
+constexpr std::array<uint8_t, 256> createHexDecodeTable()
+{
+	std::array<uint8_t, 256> table{};
+	for(int32_t i = 0; i < 10; i++) table[(uint8_t)('0' + i)] = i;
+	for(int32_t i = 0; i < 6; i++)
+	{
+		table[(uint8_t)('A' + i)] = 10 + i;
+		table[(uint8_t)('a' + i)] = 10 + i;
+	}
+	return table;
+}
+}
+
+const std::array<uint8_t, 256> BidCoSPacket::_hexDecodeTable = createHexDecodeTable();
+const std::array<char, 16> BidCoSPacket::_hexEncodeTable{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
 
 //Properties
 std::string BidCoSPacket::hexString()
 {
 	try
 	{
-		if(_payload.size() > 200) return "";
-		std::ostringstream stringStream;
-		stringStream << std::hex << std::uppercase << std::setfill('0') << std::setw(2);
-		stringStream << std::setw(2) << (9 + _payload.size());
-		stringStream << std::setw(2) << (int32_t)_messageCounter;
-		stringStream << std::setw(2) << (int32_t)_controlByte;
-		stringStream << std::setw(2) << (int32_t)_messageType;
-		stringStream << std::setw(6) << _senderAddress;
-		stringStream << std::setw(6) << _destinationAddress;
-		std::for_each(_payload.begin(), _payload.end(), [&](uint8_t element) {stringStream << std::setw(2) << (int32_t)element;});
-		return stringStream.str();
+		FrameBuffer frame;
+		uint32_t frameSize = byteArray(frame.data(), frame.size());
+		std::string hex(frameSize * 2, '0');
+		for(uint32_t i = 0; i < frameSize; i++)
+		{
+			hex[i * 2] = _hexEncodeTable[frame[i] >> 4];
+			hex[(i * 2) + 1] = _hexEncodeTable[frame[i] & 0x0F];
+		}
+		return hex;
 	}
 	catch(const std::exception& ex)
 	{
@@ -59,23 +130,30 @@ std::string BidCoSPacket::hexString()
 	return "";
 }
 
+uint32_t BidCoSPacket::byteArray(uint8_t* buffer, uint32_t bufferSize)
+{
+	uint32_t size = frameSize();
+	if(bufferSize < size) return 0;
+	buffer[0] = 9 + _payload.size();
+	buffer[1] = _messageCounter;
+	buffer[2] = _controlByte;
+	buffer[3] = _messageType;
+	buffer[4] = _senderAddress >> 16;
+	buffer[5] = (_senderAddress >> 8) & 0xFF;
+	buffer[6] = _senderAddress & 0xFF;
+	buffer[7] = _destinationAddress >> 16;
+	buffer[8] = (_destinationAddress >> 8) & 0xFF;
+	buffer[9] = _destinationAddress & 0xFF;
+	std::copy(_payload.begin(), _payload.end(), buffer + 10);
+	return size;
+}
+
 std::vector<uint8_t> BidCoSPacket::byteArray()
 {
 	try
 	{
-		std::vector<uint8_t> data;
-		if(_payload.size() > 200) return data;
-		data.push_back(9 + _payload.size());
-		data.push_back(_messageCounter);
-		data.push_back(_controlByte);
-		data.push_back(_messageType);
-		data.push_back(_senderAddress >> 16);
-		data.push_back((_senderAddress >> 8) & 0xFF);
-		data.push_back(_senderAddress & 0xFF);
-		data.push_back(_destinationAddress >> 16);
-		data.push_back((_destinationAddress >> 8) & 0xFF);
-		data.push_back(_destinationAddress & 0xFF);
-		data.insert(data.end(), _payload.begin(), _payload.end());
+		std::vector<uint8_t> data(frameSize());
+		byteArray(data.data(), data.size());
 		return data;
 	}
 	catch(const std::exception& ex)
@@ -89,19 +167,8 @@ std::vector<char> BidCoSPacket::byteArraySigned()
 {
 	try
 	{
-		std::vector<char> data;
-		if(_payload.size() > 200) return data;
-		data.push_back(9 + _payload.size());
-		data.push_back(_messageCounter);
-		data.push_back(_controlByte);
-		data.push_back(_messageType);
-		data.push_back(_senderAddress >> 16);
-		data.push_back((_senderAddress >> 8) & 0xFF);
-		data.push_back(_senderAddress & 0xFF);
-		data.push_back(_destinationAddress >> 16);
-		data.push_back((_destinationAddress >> 8) & 0xFF);
-		data.push_back(_destinationAddress & 0xFF);
-		data.insert(data.end(), _payload.begin(), _payload.end());
+		std::vector<char> data(frameSize());
+		byteArray((uint8_t*)data.data(), data.size());
 		return data;
 	}
 	catch(const std::exception& ex)
@@ -116,27 +183,43 @@ BidCoSPacket::BidCoSPacket()
 {
 }
 
-BidCoSPacket::BidCoSPacket(std::string& packet, int64_t timeReceived)
+BidCoSPacket::BidCoSPacket(std::string_view packet, int64_t timeReceived)
 {
 	_timeReceived = timeReceived;
-    import(packet, packet.front() == 'A');
+	if(timeReceived > 0) _monotonicTimeReceived = BidCoSLatencyStatistics::now();
+    import(packet, !packet.empty() && packet.front() == 'A');
 }
 
 BidCoSPacket::BidCoSPacket(const std::vector<uint8_t>& packet, bool rssiByte, int64_t timeReceived)
 {
 	_timeReceived = timeReceived;
+	if(timeReceived > 0) _monotonicTimeReceived = BidCoSLatencyStatistics::now();
 	import(packet, rssiByte);
 }
 
+BidCoSPacket::BidCoSPacket(const uint8_t* packet, uint32_t size, bool rssiByte, int64_t timeReceived)
+{
+	_timeReceived = timeReceived;
+	if(timeReceived > 0) _monotonicTimeReceived = BidCoSLatencyStatistics::now();
+	import(packet, size, rssiByte);
+}
+
 BidCoSPacket::BidCoSPacket(uint8_t messageCounter, uint8_t controlByte, uint8_t messageType, int32_t senderAddress, int32_t destinationAddress, std::vector<uint8_t>& payload, bool updatePacket)
 {
-    _length = 9 + _payload.size();
     _messageCounter = messageCounter;
     _controlByte = controlByte;
     _messageType = messageType;
     _senderAddress = senderAddress;
     _destinationAddress = destinationAddress;
-    _payload = payload;
+    try
+    {
+        _payload = payload;
+    }
+    catch(const std::exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    _length = 9 + _payload.size();
     _updatePacket = updatePacket;
 }
 
@@ -145,11 +228,16 @@ BidCoSPacket::~BidCoSPacket()
 }
 
 void BidCoSPacket::import(const std::vector<uint8_t>& packet, bool rssiByte)
+{
+	import(packet.data(), packet.size(), rssiByte);
+}
+
+void BidCoSPacket::import(const uint8_t* packet, uint32_t size, bool rssiByte)
 {
 	try
 	{
-		if(packet.size() < 10) return;
-		if(packet.size() > 200)
+		if(size < 10) return;
+		if(size > 200)
 		{
 			GD::out.printWarning("Warning: Tried to import BidCoS packet larger than 200 bytes.");
 			return;
@@ -160,16 +248,16 @@ void BidCoSPacket::import(const std::vector<uint8_t>& packet, bool rssiByte)
 		_senderAddress = (packet[4] << 16) + (packet[5] << 8) + packet[6];
 		_destinationAddress = (packet[7] << 16) + (packet[8] << 8) + packet[9];
 		_payload.clear();
-		if(packet.size() == 10)
+		if(size == 10)
 		{
-			_length = packet.size();
+			_length = size;
 		}
 		else
 		{
 			if(rssiByte)
 			{
-				_payload.insert(_payload.end(), packet.begin() + 10, packet.end() - 1);
-				int32_t rssiDevice = packet.back();
+				_payload.assign(packet + 10, size - 11);
+				int32_t rssiDevice = packet[size - 1];
 				//1) Read the RSSI status register
 				//2) Convert the reading from a hexadecimal
 				//number to a decimal number (RSSI_dec)
@@ -181,7 +269,7 @@ void BidCoSPacket::import(const std::vector<uint8_t>& packet, bool rssiByte)
 				else rssiDevice = (rssiDevice / 2) - 74;
 				_rssiDevice = rssiDevice * -1;
 			}
-			else _payload.insert(_payload.end(), packet.begin() + 10, packet.end());
+			else _payload.assign(packet + 10, size - 10);
 			_length = 9 + _payload.size();
 		}
 		if(_length != packet[0])
@@ -197,14 +285,14 @@ void BidCoSPacket::import(const std::vector<uint8_t>& packet, bool rssiByte)
 }
 
 //Packet looks like A...DATA...\r\n
-void BidCoSPacket::import(std::string& packet, bool removeFirstCharacter)
+void BidCoSPacket::import(std::string_view packet, bool removeFirstCharacter)
 {
 	try
 	{
 		uint32_t startIndex = removeFirstCharacter ? 1 : 0;
 		if(packet.size() < startIndex + 20)
 		{
-			GD::out.printError("Error: Packet is too short: " + packet);
+			GD::out.printError("Error: Packet is too short: " + std::string(packet));
 			return;
 		}
 		if(packet.size() > 400)
@@ -212,30 +300,31 @@ void BidCoSPacket::import(std::string& packet, bool removeFirstCharacter)
 			GD::out.printWarning("Warning: Tried to import BidCoS packet larger than 200 bytes.");
 			return;
 		}
-		_length = getByte(packet.substr(startIndex, 2));
-		_messageCounter = getByte(packet.substr(startIndex + 2, 2));
-		_controlByte = getByte(packet.substr(startIndex + 4, 2));
-		_messageType = getByte(packet.substr(startIndex + 6, 2));
-		_senderAddress = getInt(packet.substr(startIndex + 8, 6));
-		_destinationAddress = getInt(packet.substr(startIndex + 14, 6));
+		const char* data = packet.data();
+		_length = getByte(data + startIndex);
+		_messageCounter = getByte(data + startIndex + 2);
+		_controlByte = getByte(data + startIndex + 4);
+		_messageType = getByte(data + startIndex + 6);
+		_senderAddress = getInt(data + startIndex + 8, 6);
+		_destinationAddress = getInt(data + startIndex + 14, 6);
 
 		uint32_t tailLength = 0;
 		if(packet.back() == '\n') tailLength = 2;
 		uint32_t endIndex = startIndex + 2 + (_length * 2) - 1;
 		if(endIndex >= packet.size())
 		{
-			GD::out.printWarning("Warning: Packet is shorter than value of packet length byte: " + packet);
+			GD::out.printWarning("Warning: Packet is shorter than value of packet length byte: " + std::string(packet));
 			endIndex = packet.size() - 1;
 		}
 		_payload.clear();
 		uint32_t i;
 		for(i = startIndex + 20; i < endIndex; i+=2)
 		{
-			_payload.push_back(getByte(packet.substr(i, 2)));
+			_payload.push_back(getByte(data + i));
 		}
 		if(i < packet.size() - tailLength)
 		{
-			int32_t rssiDevice = getByte(packet.substr(i, 2));
+			int32_t rssiDevice = (i + 1 < packet.size()) ? getByte(data + i) : getInt(data + i, 1);
 			//1) Read the RSSI status register
 			//2) Convert the reading from a hexadecimal
 			//number to a decimal number (RSSI_dec)
@@ -254,86 +343,42 @@ void BidCoSPacket::import(std::string& packet, bool removeFirstCharacter)
     }
 }
 
-uint8_t BidCoSPacket::getByte(std::string hexString)
-{
-	try
-	{
-		uint8_t value = 0;
-		try	{ value = std::stoi(hexString, 0, 16); } catch(...) {}
-		return value;
-	}
-	catch(const std::exception& ex)
-    {
-    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-    }
-	return 0;
-}
-
-int32_t BidCoSPacket::getInt(std::string hexString)
+void BidCoSPacket::setPosition(double index, double size, std::vector<uint8_t>& value)
 {
-	try
-	{
-		int32_t value = 0;
-		try	{ value = std::stoll(hexString, 0, 16); } catch(...) {}
-		return value;
-	}
-	catch(const std::exception& ex)
-    {
-    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-    }
-	return 0;
+	setPosition(BidCoSPacketPosition(index, size), value);
 }
 
-void BidCoSPacket::setPosition(double index, double size, std::vector<uint8_t>& value)
+void BidCoSPacket::setPosition(const BidCoSPacketPosition& position, const std::vector<uint8_t>& value)
 {
 	try
 	{
-		if(size < 0)
+		if(position.headerIndex && position.type != BidCoSPacketPosition::Type::invalid)
 		{
-			GD::out.printError("Error: Negative size not allowed.");
+			GD::out.printError("Error: Packet index < 9 requested.");
 			return;
 		}
-		if(index < 9)
+		if(position.type == BidCoSPacketPosition::Type::invalid)
 		{
-			GD::out.printError("Error: Packet index < 9 requested.");
+			GD::out.printError(position.error ? position.error : "Error: Invalid packet position.");
 			return;
 		}
-		index -= 9;
-		double byteIndex = std::floor(index);
-		if(byteIndex != index || size < 0.8) //0.8 == 8 Bits
+		if(position.type == BidCoSPacketPosition::Type::partialByte)
 		{
-			if(value.empty()) value.push_back(0);
-			int32_t intByteIndex = byteIndex;
-			if(size > 1.0)
-			{
-				GD::out.printError("Error: Can't set partial byte index > 1.");
-				return;
-			}
-			while((signed)_payload.size() - 1 < intByteIndex)
-			{
-				_payload.push_back(0);
-			}
-			_payload.at(intByteIndex) |= value.at(value.size() - 1) << (std::lround(index * 10) % 10);
+			if(_payload.size() < position.byteIndex + 1) _payload.resize(position.byteIndex + 1);
+			_payload.at(position.byteIndex) |= (value.empty() ? 0 : value.back()) << position.shift;
 		}
 		else
 		{
-			uint32_t intByteIndex = byteIndex;
-			uint32_t bytes = (uint32_t)std::ceil(size);
-			while(_payload.size() < intByteIndex + bytes)
-			{
-				_payload.push_back(0);
-			}
+			uint32_t bytes = position.bytes;
+			if(_payload.size() < position.byteIndex + bytes) _payload.resize(position.byteIndex + bytes);
 			if(value.empty()) return;
-			uint32_t bitSize = std::lround(size * 10) % 10;
-			if(bitSize > 8) bitSize = 8;
 			if(bytes == 0) bytes = 1; //size is 0 - assume 1
-			//if(bytes > value.size()) bytes = value.size();
 			if(bytes <= value.size())
 			{
-				_payload.at(intByteIndex) |= value.at(0) & _bitmask[bitSize];
+				_payload.at(position.byteIndex) |= value.at(0) & position.firstByteMask;
 				for(uint32_t i = 1; i < bytes; i++)
 				{
-					_payload.at(intByteIndex + i) |= value.at(i);
+					_payload.at(position.byteIndex + i) |= value.at(i);
 				}
 			}
 			else
@@ -341,7 +386,7 @@ void BidCoSPacket::setPosition(double index, double size, std::vector<uint8_t>&
 				uint32_t missingBytes = bytes - value.size();
 				for(uint32_t i = 0; i < value.size(); i++)
 				{
-					_payload.at(intByteIndex + missingBytes + i) |= value.at(i);
+					_payload.at(position.byteIndex + missingBytes + i) |= value.at(i);
 				}
 			}
 		}
@@ -355,93 +400,93 @@ void BidCoSPacket::setPosition(double index, double size, std::vector<uint8_t>&
 
 std::vector<uint8_t> BidCoSPacket::getPosition(double index, double size, int32_t mask)
 {
-	std::vector<uint8_t> result;
+	BidCoSPayload result;
+	getPosition(BidCoSPacketPosition(index, size, mask), result);
+	return result.toVector();
+}
+
+void BidCoSPacket::getPosition(const BidCoSPacketPosition& position, BidCoSPayload& result)
+{
+	result.clear();
 	try
 	{
-		if(size < 0)
-		{
-			GD::out.printError("Error: Negative size not allowed.");
-			result.push_back(0);
-			return result;
-		}
-		if(index < 0)
-		{
-			GD::out.printError("Error: Packet index < 0 requested.");
-			result.push_back(0);
-			return result;
-		}
-		if(index < 9)
-		{
-			if(size > 0.8)
-			{
-				GD::out.printError("Error: Packet index < 9 and size > 1 requested.");
-				result.push_back(0);
-				return result;
-			}
-
-			uint32_t bitSize = std::lround(size * 10);
-			uint32_t intIndex = std::lround(std::floor(index));
-			if(intIndex == 0) result.push_back((_messageCounter >> (std::lround(index * 10) % 10)) & _bitmask[bitSize]);
-			else if(intIndex == 1) result.push_back((_controlByte >> (std::lround(index * 10) % 10)) & _bitmask[bitSize]);
-			else if(intIndex == 2) result.push_back((_messageType >> (std::lround(index * 10) % 10)) & _bitmask[bitSize]);
-			else if(intIndex == 3) result.push_back(((_senderAddress >> 16) >> (std::lround(index * 10) % 10)) & _bitmask[bitSize]);
-			else if(intIndex == 4) result.push_back(((_senderAddress >> 8) >> (std::lround(index * 10) % 10)) & _bitmask[bitSize]);
-			else if(intIndex == 5) result.push_back((_senderAddress >> (std::lround(index * 10) % 10)) & _bitmask[bitSize]);
-			else if(intIndex == 6) result.push_back(((_destinationAddress >> 16) >> (std::lround(index * 10) % 10)) & _bitmask[bitSize]);
-			else if(intIndex == 7) result.push_back(((_destinationAddress >> 8) >> (std::lround(index * 10) % 10)) & _bitmask[bitSize]);
-			else if(intIndex == 8) result.push_back((_destinationAddress >> (std::lround(index * 10) % 10)) & _bitmask[bitSize]);
-			return result;
-		}
-		index -= 9;
-		double byteIndex = std::floor(index);
-		int32_t intByteIndex = byteIndex;
-		if(byteIndex >= _payload.size())
-		{
-			result.push_back(0);
-			return result;
-		}
-		if(byteIndex != index || size < 0.8) //0.8 == 8 Bits
+		switch(position.type)
 		{
-			if(size > 1)
+			case BidCoSPacketPosition::Type::invalid:
+				GD::out.printError(position.error ? position.error : "Error: Invalid packet position.");
+				break;
+			case BidCoSPacketPosition::Type::header:
 			{
-				GD::out.printError("Error: Partial byte index > 1 requested.");
-				result.push_back(0);
-				return result;
+				int32_t headerValue = 0;
+				switch(position.byteIndex)
+				{
+					case 0: headerValue = _messageCounter; break;
+					case 1: headerValue = _controlByte; break;
+					case 2: headerValue = _messageType; break;
+					case 3: headerValue = _senderAddress >> 16; break;
+					case 4: headerValue = _senderAddress >> 8; break;
+					case 5: headerValue = _senderAddress; break;
+					case 6: headerValue = _destinationAddress >> 16; break;
+					case 7: headerValue = _destinationAddress >> 8; break;
+					default: headerValue = _destinationAddress; break;
+				}
+				result.push_back((headerValue >> position.shift) & position.firstByteMask);
+				return;
 			}
-			//The round is necessary, because for example (uint32_t)(0.2 * 10) is 1
-			uint32_t bitSize = std::lround(size * 10);
-			if(bitSize > 8) bitSize = 8;
-			result.push_back((_payload.at(intByteIndex) >> (std::lround(index * 10) % 10)) & _bitmask[bitSize]);
-		}
-		else
-		{
-			uint32_t bytes = (uint32_t)std::ceil(size);
-			uint32_t bitSize = std::lround(size * 10) % 10;
-			if(bitSize > 8) bitSize = 8;
-			if(bytes == 0) bytes = 1; //size is 0 - assume 1
-			uint8_t currentByte = _payload.at(intByteIndex) & _bitmask[bitSize];
-			if(mask != -1 && bytes <= 4) currentByte &= (mask >> ((bytes - 1) * 8));
-			result.push_back(currentByte);
-			for(uint32_t i = 1; i < bytes; i++)
+			case BidCoSPacketPosition::Type::partialByte:
+				if(position.byteIndex >= _payload.size()) break;
+				result.push_back((_payload[position.byteIndex] >> position.shift) & position.firstByteMask);
+				return;
+			case BidCoSPacketPosition::Type::bytes:
 			{
-				if((intByteIndex + i) >= _payload.size()) result.push_back(0);
-				else
+				if(position.byteIndex >= _payload.size()) break;
+				uint32_t bytes = position.bytes;
+				if(bytes == 0) bytes = 1; //size is 0 - assume 1
+				bool applyMask = position.mask != -1 && bytes <= 4;
+				uint8_t currentByte = _payload[position.byteIndex] & position.firstByteMask;
+				if(applyMask) currentByte &= (position.mask >> ((bytes - 1) * 8));
+				result.push_back(currentByte);
+				for(uint32_t i = 1; i < bytes; i++)
 				{
-					currentByte = _payload.at(intByteIndex + i);
-					if(mask != -1 && bytes <= 4) currentByte &= (mask >> ((bytes - i - 1) * 8));
-					result.push_back(currentByte);
+					if((position.byteIndex + i) >= _payload.size()) result.push_back(0);
+					else
+					{
+						currentByte = _payload[position.byteIndex + i];
+						if(applyMask) currentByte &= (position.mask >> ((bytes - i - 1) * 8));
+						result.push_back(currentByte);
+					}
 				}
+				return;
 			}
 		}
-		if(result.empty()) result.push_back(0);
-		return result;
 	}
 	catch(const std::exception& ex)
     {
     	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
-    result.push_back(0);
-    return result;
+	result.clear();
+	result.push_back(0);
+}
+
+int32_t BidCoSPacket::getPositionInteger(const BidCoSPacketPosition& position)
+{
+	if(position.type == BidCoSPacketPosition::Type::partialByte && position.byteIndex < _payload.size())
+	{
+		return (_payload[position.byteIndex] >> position.shift) & position.firstByteMask;
+	}
+	else if(position.type == BidCoSPacketPosition::Type::bytes && position.bytes <= 1 && position.mask == -1 && position.byteIndex < _payload.size())
+	{
+		return _payload[position.byteIndex] & position.firstByteMask;
+	}
+	BidCoSPayload data;
+	getPosition(position, data);
+	int32_t value = 0;
+	uint32_t length = data.size() > 4 ? 4 : data.size();
+	for(uint32_t i = 0; i < length; i++)
+	{
+		value = (value << 8) | data[i];
+	}
+	return value;
 }
 
 bool BidCoSPacket::equals(std::shared_ptr<BidCoSPacket>& rhs)
@@ -455,4 +500,30 @@ bool BidCoSPacket::equals(std::shared_ptr<BidCoSPacket>& rhs)
 	if(_payload == rhs->payload()) return true;
 	return false;
 }
+
+uint64_t BidCoSPacket::fingerprint()
+{
+	//FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	auto add = [&hash](uint8_t byte)
+	{
+		hash ^= byte;
+		hash *= 1099511628211ull;
+	};
+	add(_messageCounter);
+	add(_controlByte);
+	add(_messageType);
+	add(_senderAddress >> 16);
+	add(_senderAddress >> 8);
+	add(_senderAddress);
+	add(_destinationAddress >> 16);
+	add(_destinationAddress >> 8);
+	add(_destinationAddress);
+	add(_payload.size());
+	for(uint8_t byte : _payload)
+	{
+		add(byte);
+	}
+	return hash;
+}
 }
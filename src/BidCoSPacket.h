@@ -36,18 +36,127 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <array>
+#include <stdexcept>
 #include <cmath>
 
 namespace BidCoS
 {
 
+/**
+ * Fixed-capacity byte buffer with the subset of the std::vector interface used for packet payloads. The data is stored inline, so creating, copying or filling a packet doesn't touch the heap.
+ */
+class BidCoSPayload
+{
+    public:
+        static constexpr uint32_t capacity = 190;
+        typedef uint8_t* iterator;
+        typedef const uint8_t* const_iterator;
+
+        BidCoSPayload() {}
+        BidCoSPayload(const std::vector<uint8_t>& data) { assign(data.data(), data.size()); }
+        BidCoSPayload& operator=(const std::vector<uint8_t>& data) { assign(data.data(), data.size()); return *this; }
+        bool operator==(const BidCoSPayload& rhs) const { return _size == rhs._size && std::equal(begin(), end(), rhs.begin()); }
+        bool operator!=(const BidCoSPayload& rhs) const { return !(*this == rhs); }
+
+        uint32_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        uint8_t* data() { return _data.data(); }
+        const uint8_t* data() const { return _data.data(); }
+        iterator begin() { return _data.data(); }
+        iterator end() { return _data.data() + _size; }
+        const_iterator begin() const { return _data.data(); }
+        const_iterator end() const { return _data.data() + _size; }
+        uint8_t& operator[](uint32_t index) { return _data[index]; }
+        uint8_t operator[](uint32_t index) const { return _data[index]; }
+        uint8_t& at(uint32_t index) { if(index >= _size) throw std::out_of_range("Payload index out of range."); return _data[index]; }
+        uint8_t at(uint32_t index) const { if(index >= _size) throw std::out_of_range("Payload index out of range."); return _data[index]; }
+        uint8_t& front() { return at(0); }
+        uint8_t& back() { return at(_size - 1); }
+
+        void clear() { _size = 0; }
+        void resize(uint32_t size, uint8_t value = 0)
+        {
+            if(size > capacity) throw std::length_error("Payload is larger than " + std::to_string(capacity) + " bytes.");
+            if(size > _size) std::fill(_data.begin() + _size, _data.begin() + size, value);
+            _size = size;
+        }
+        void push_back(uint8_t value)
+        {
+            if(_size >= capacity) throw std::length_error("Payload is larger than " + std::to_string(capacity) + " bytes.");
+            _data[_size++] = value;
+        }
+        template<typename InputIterator> void insert(iterator position, InputIterator first, InputIterator last)
+        {
+            uint32_t count = std::distance(first, last);
+            if(_size + count > capacity) throw std::length_error("Payload is larger than " + std::to_string(capacity) + " bytes.");
+            std::move_backward(position, end(), end() + count);
+            std::copy(first, last, position);
+            _size += count;
+        }
+        void assign(const uint8_t* data, uint32_t size)
+        {
+            if(size > capacity) throw std::length_error("Payload is larger than " + std::to_string(capacity) + " bytes.");
+            std::copy(data, data + size, _data.begin());
+            _size = size;
+        }
+        std::vector<uint8_t> toVector() const { return std::vector<uint8_t>(begin(), end()); }
+    private:
+        std::array<uint8_t, capacity> _data;
+        uint32_t _size = 0;
+};
+
+/**
+ * Precompiled form of the "index", "size" and "mask" arguments of BidCoSPacket::getPosition() and setPosition(). The bit notation of device
+ * descriptions (e.g. index 10.4 and size 0.3 for bits 4 to 6 of the second payload byte) is converted to a byte index, a shift and a mask once,
+ * so reading or writing a value doesn't need any floating point math.
+ */
+class BidCoSPacketPosition
+{
+    public:
+        enum class Type : uint8_t
+        {
+            invalid,
+            header, //Bits of one of the nine header bytes (message counter to destination address)
+            partialByte, //Bits of one payload byte
+            bytes //One or more whole payload bytes
+        };
+
+        BidCoSPacketPosition() {}
+        BidCoSPacketPosition(double index, double size, int32_t mask = -1);
+
+        Type type = Type::invalid;
+
+        /**
+         * The header byte index for Type::header, the payload byte index otherwise.
+         */
+        uint32_t byteIndex = 0;
+
+        /**
+         * The number of bytes as specified by "size". Can be 0.
+         */
+        uint32_t bytes = 0;
+        uint8_t shift = 0;
+        uint8_t firstByteMask = 0xFF;
+        int32_t mask = -1;
+        bool headerIndex = false;
+        const char* error = nullptr;
+};
+
 class BidCoSPacket : public BaseLib::Systems::Packet
 {
     public:
+        /**
+         * The maximum size of a binary packet including the length byte and an optional RSSI byte.
+         */
+        static constexpr uint32_t maxFrameSize = 11 + BidCoSPayload::capacity;
+        typedef std::array<uint8_t, maxFrameSize> FrameBuffer;
+
         //Properties
         int32_t senderAddress() { return _senderAddress; }
         int32_t destinationAddress() { return _destinationAddress; }
@@ -61,25 +170,67 @@ class BidCoSPacket : public BaseLib::Systems::Packet
         void setValidAesAck(bool value) { _validAesAck = value; }
         uint8_t controlByte() { return _controlByte; }
         void setControlByte(uint8_t value) { _controlByte = value; }
-        std::vector<uint8_t>& payload() { return _payload; }
+        BidCoSPayload& payload() { return _payload; }
+
+        /**
+         * The time of reception in microseconds of a monotonic clock (see BidCoSLatencyStatistics::now()). 0 for packets not created from received data.
+         */
+        int64_t monotonicTimeReceived() { return _monotonicTimeReceived; }
+
+        /**
+         * The size of the binary packet including the length byte.
+         */
+        uint32_t frameSize() { return 10 + _payload.size(); }
         std::string hexString();
         std::vector<uint8_t> byteArray();
         std::vector<char> byteArraySigned();
 
+        /**
+         * Writes the binary packet including the length byte into a caller provided buffer.
+         *
+         * @param buffer The buffer to write to.
+         * @param bufferSize The size of the buffer. Needs to be at least frameSize().
+         * @return Returns the number of bytes written or 0 if the buffer is too small.
+         */
+        uint32_t byteArray(uint8_t* buffer, uint32_t bufferSize);
+
         BidCoSPacket();
-        BidCoSPacket(std::string& packet, int64_t timeReceived = 0);
+        BidCoSPacket(std::string_view packet, int64_t timeReceived = 0);
         BidCoSPacket(const std::vector<uint8_t>& packet, bool rssiByte, int64_t timeReceived = 0);
+        BidCoSPacket(const uint8_t* packet, uint32_t size, bool rssiByte, int64_t timeReceived = 0);
         BidCoSPacket(uint8_t messageCounter, uint8_t controlByte, uint8_t messageType, int32_t senderAddress, int32_t destinationAddress, std::vector<uint8_t>& payload, bool updatePacket = false);
         virtual ~BidCoSPacket();
-        void import(std::string& packet, bool removeFirstCharacter = true);
+        void import(std::string_view packet, bool removeFirstCharacter = true);
         void import(const std::vector<uint8_t>& packet, bool rssiByte);
+        void import(const uint8_t* packet, uint32_t size, bool rssiByte);
         virtual std::vector<uint8_t> getPosition(double index, double size, int32_t mask);
         virtual void setPosition(double index, double size, std::vector<uint8_t>& value);
 
+        /**
+         * Reads the data at "position" into "result" without allocating memory. Behaves exactly like getPosition(double, double, int32_t).
+         */
+        void getPosition(const BidCoSPacketPosition& position, BidCoSPayload& result);
+
+        /**
+         * Reads the data at "position" as big endian integer of at most four bytes. This is the fast path for comparing constant values.
+         */
+        int32_t getPositionInteger(const BidCoSPacketPosition& position);
+
+        /**
+         * Writes "value" to "position". Behaves exactly like setPosition(double, double, std::vector<uint8_t>&).
+         */
+        void setPosition(const BidCoSPacketPosition& position, const std::vector<uint8_t>& value);
+
         bool equals(std::shared_ptr<BidCoSPacket>& rhs);
+
+        /**
+         * Returns a 64 bit hash of all fields compared by equals(). Packets with different fingerprints are never equal.
+         */
+        uint64_t fingerprint();
     protected:
     private:
-        static const std::array<uint8_t, 9> _bitmask;
+        static const std::array<uint8_t, 256> _hexDecodeTable;
+        static const std::array<char, 16> _hexEncodeTable;
 
         int32_t _senderAddress = 0;
         int32_t _destinationAddress = 0;
@@ -88,12 +239,25 @@ class BidCoSPacket : public BaseLib::Systems::Packet
         uint8_t _messageCounter = 0;
         uint8_t _messageType = 0;
         uint8_t _rssiDevice = 0;
-        std::vector<uint8_t> _payload;
+        BidCoSPayload _payload;
         bool _updatePacket = false;
         bool _validAesAck = false;
+        int64_t _monotonicTimeReceived = 0;
+
+        /**
+         * Decodes two hex characters. Invalid characters are decoded as 0.
+         */
+        uint8_t getByte(const char* hex) { return (_hexDecodeTable[(uint8_t)hex[0]] << 4) | _hexDecodeTable[(uint8_t)hex[1]]; }
 
-        uint8_t getByte(std::string);
-        int32_t getInt(std::string);
+        /**
+         * Decodes "length" hex characters. Invalid characters are decoded as 0.
+         */
+        int32_t getInt(const char* hex, uint32_t length)
+        {
+            int32_t value = 0;
+            for(uint32_t i = 0; i < length; i++) value = (value << 4) | _hexDecodeTable[(uint8_t)hex[i]];
+            return value;
+        }
 };
 
 }
@@ -60,58 +60,64 @@ BidCoSPacketManager::~BidCoSPacketManager()
 void BidCoSPacketManager::dispose(bool wait)
 {
 	_disposing = true;
+	std::lock_guard<std::mutex> deadlinesGuard(_deadlinesMutex);
 	_stopWorkerThread = true;
+	_workerConditionVariable.notify_one();
 }
 
 void BidCoSPacketManager::worker()
 {
 	try
 	{
-		std::chrono::milliseconds sleepingTime(1000);
-		uint32_t counter = 0;
-		int32_t lastPacket;
-		lastPacket = 0;
+		std::unique_lock<std::mutex> deadlinesGuard(_deadlinesMutex);
 		while(!_stopWorkerThread)
 		{
 			try
 			{
-				std::this_thread::sleep_for(sleepingTime);
-				if(_stopWorkerThread) return;
-				if(counter > 100)
+				if(_deadlines.empty())
 				{
-					counter = 0;
-					_packetMutex.lock();
-					if(_packets.size() > 0)
-					{
-						int32_t packetsPerSecond = (_packets.size() * 1000) / sleepingTime.count();
-						if(packetsPerSecond <= 0) packetsPerSecond = 1;
-						int32_t timePerPacket = (GD::bl->settings.workerThreadWindow() * 10) / packetsPerSecond;
-						if(timePerPacket < 10) timePerPacket = 10;
-						sleepingTime = std::chrono::milliseconds(timePerPacket);
-					}
-					_packetMutex.unlock();
+					//Nothing to do until the next packet is set.
+					_workerConditionVariable.wait(deadlinesGuard, [&] { return _stopWorkerThread || !_deadlines.empty(); });
+					continue;
 				}
-				_packetMutex.lock();
-				if(!_packets.empty())
+
+				int64_t now = BaseLib::HelperFunctions::getTime();
+				Deadline deadline = _deadlines.top();
+				if(deadline.time > now)
 				{
-					std::unordered_map<int32_t, std::shared_ptr<BidCoSPacketInfo>>::iterator nextPacket = _packets.find(lastPacket);
-					if(nextPacket != _packets.end())
+					_workerConditionVariable.wait_for(deadlinesGuard, std::chrono::milliseconds(deadline.time - now));
+					continue;
+				}
+				_deadlines.pop();
+				deadlinesGuard.unlock();
+
+				int64_t expirationTime = 0;
+				{
+					Shard& shard = getShard(deadline.address);
+					std::lock_guard<std::shared_mutex> shardGuard(shard.mutex);
+					auto packetIterator = shard.packets.find(deadline.address);
+					if(packetIterator != shard.packets.end() && packetIterator->second && packetIterator->second->id == deadline.id)
 					{
-						nextPacket++;
-						if(nextPacket == _packets.end()) nextPacket = _packets.begin();
+						//"time" is increased by keepAlive() and by the central while waiting for the response delay.
+						expirationTime = packetIterator->second->time + _maxAge;
+						if(now > expirationTime)
+						{
+							shard.packets.erase(packetIterator);
+							expirationTime = 0;
+						}
 					}
-					else nextPacket = _packets.begin();
-					lastPacket = nextPacket->first;
 				}
-				std::shared_ptr<BidCoSPacketInfo> packet;
-				if(_packets.find(lastPacket) != _packets.end()) packet = _packets.at(lastPacket);
-				_packetMutex.unlock();
-				if(packet) deletePacket(lastPacket, packet->id);
-				counter++;
+
+				deadlinesGuard.lock();
+				if(expirationTime > 0)
+				{
+					deadline.time = expirationTime + 1;
+					_deadlines.push(deadline);
+				}
 			}
 			catch(const std::exception& ex)
 			{
-				_packetMutex.unlock();
+				if(!deadlinesGuard.owns_lock()) deadlinesGuard.lock();
 				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
 			}
 		}
@@ -122,36 +128,46 @@ void BidCoSPacketManager::worker()
     }
 }
 
+void BidCoSPacketManager::addDeadline(int32_t address, uint32_t id, int64_t time)
+{
+	Deadline deadline;
+	deadline.time = time + _maxAge + 1;
+	deadline.address = address;
+	deadline.id = id;
+	std::lock_guard<std::mutex> deadlinesGuard(_deadlinesMutex);
+	//Only wake up the worker when it is waiting for a later deadline.
+	bool notify = _deadlines.empty() || deadline.time < _deadlines.top().time;
+	_deadlines.push(deadline);
+	if(notify) _workerConditionVariable.notify_one();
+}
+
 bool BidCoSPacketManager::set(int32_t address, std::shared_ptr<BidCoSPacket>& packet, int64_t time)
 {
 	try
 	{
-		if(_disposing) return false;
-		_packetMutex.lock();
-		if(_packets.find(address) != _packets.end())
+		if(_disposing || !packet) return false;
+		uint64_t fingerprint = packet->fingerprint();
+		std::shared_ptr<BidCoSPacketInfo> info;
 		{
-			std::shared_ptr<BidCoSPacket> oldPacket = _packets.at(address)->packet;
-			if(oldPacket->equals(packet))
-			{
-				_packetMutex.unlock();
-				return true;
-			}
-			_packets.erase(_packets.find(address));
+			Shard& shard = getShard(address);
+			std::lock_guard<std::shared_mutex> shardGuard(shard.mutex);
+			std::shared_ptr<BidCoSPacketInfo>& entry = shard.packets[address];
+			//Different fingerprints can only belong to different packets. Equal fingerprints are verified, so a hash collision can't drop a packet.
+			if(entry && entry->fingerprint == fingerprint && entry->packet->equals(packet)) return true;
+
+			info = std::make_shared<BidCoSPacketInfo>();
+			info->packet = packet;
+			info->fingerprint = fingerprint;
+			info->id = _id++;
+			if(time > 0) info->time = time;
+			entry = info;
 		}
-		_packetMutex.unlock();
-
-		std::shared_ptr<BidCoSPacketInfo> info(new BidCoSPacketInfo());
-		info->packet = packet;
-		info->id = _id++;
-		if(time > 0) info->time = time;
-		_packetMutex.lock();
-		_packets.insert(std::pair<int32_t, std::shared_ptr<BidCoSPacketInfo>>(address, info));
+		addDeadline(address, info->id, info->time);
 	}
 	catch(const std::exception& ex)
     {
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
-    _packetMutex.unlock();
     return false;
 }
 
@@ -160,22 +176,19 @@ void BidCoSPacketManager::deletePacket(int32_t address, uint32_t id)
 	try
 	{
 		if(_disposing) return;
-		_packetMutex.lock();
-		if(_packets.find(address) != _packets.end() && _packets.at(address) && _packets.at(address)->id == id)
+		Shard& shard = getShard(address);
+		std::lock_guard<std::shared_mutex> shardGuard(shard.mutex);
+		auto packetIterator = shard.packets.find(address);
+		if(packetIterator != shard.packets.end() && packetIterator->second && packetIterator->second->id == id)
 		{
-			if(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count() <= _packets.at(address)->time + 2000)
-			{
-				_packetMutex.unlock();
-				return;
-			}
-			_packets.erase(address);
+			if(BaseLib::HelperFunctions::getTime() <= packetIterator->second->time + _maxAge) return;
+			shard.packets.erase(packetIterator);
 		}
 	}
 	catch(const std::exception& ex)
     {
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
-    _packetMutex.unlock();
 }
 
 std::shared_ptr<BidCoSPacket> BidCoSPacketManager::get(int32_t address)
@@ -183,17 +196,17 @@ std::shared_ptr<BidCoSPacket> BidCoSPacketManager::get(int32_t address)
 	try
 	{
 		if(_disposing) return std::shared_ptr<BidCoSPacket>();
-		_packetMutex.lock();
+		Shard& shard = getShard(address);
+		std::shared_lock<std::shared_mutex> shardGuard(shard.mutex);
 		//Make a copy to make sure, the element exists
-		std::shared_ptr<BidCoSPacket> packet((_packets.find(address) != _packets.end()) ? _packets[address]->packet : nullptr);
-		_packetMutex.unlock();
-		return packet;
+		auto packetIterator = shard.packets.find(address);
+		if(packetIterator == shard.packets.end() || !packetIterator->second) return std::shared_ptr<BidCoSPacket>();
+		return packetIterator->second->packet;
 	}
 	catch(const std::exception& ex)
     {
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
-    _packetMutex.unlock();
     return std::shared_ptr<BidCoSPacket>();
 }
 
@@ -202,17 +215,17 @@ std::shared_ptr<BidCoSPacketInfo> BidCoSPacketManager::getInfo(int32_t address)
 	try
 	{
 		if(_disposing) return std::shared_ptr<BidCoSPacketInfo>();
+		Shard& shard = getShard(address);
+		std::shared_lock<std::shared_mutex> shardGuard(shard.mutex);
 		//Make a copy to make sure, the element exists
-		_packetMutex.lock();
-		std::shared_ptr<BidCoSPacketInfo> info((_packets.find(address) != _packets.end()) ? _packets[address] : nullptr);
-		_packetMutex.unlock();
-		return info;
+		auto packetIterator = shard.packets.find(address);
+		if(packetIterator == shard.packets.end()) return std::shared_ptr<BidCoSPacketInfo>();
+		return packetIterator->second;
 	}
 	catch(const std::exception& ex)
     {
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
-    _packetMutex.unlock();
     return std::shared_ptr<BidCoSPacketInfo>();
 }
 
@@ -221,13 +234,14 @@ void BidCoSPacketManager::keepAlive(int32_t address)
 	try
 	{
 		if(_disposing) return;
-		_packetMutex.lock();
-		if(_packets.find(address) != _packets.end()) _packets[address]->time = BaseLib::HelperFunctions::getTime();
+		Shard& shard = getShard(address);
+		std::lock_guard<std::shared_mutex> shardGuard(shard.mutex);
+		auto packetIterator = shard.packets.find(address);
+		if(packetIterator != shard.packets.end() && packetIterator->second) packetIterator->second->time = BaseLib::HelperFunctions::getTime();
 	}
 	catch(const std::exception& ex)
     {
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
-    _packetMutex.unlock();
 }
 }
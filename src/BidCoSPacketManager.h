@@ -42,6 +42,11 @@
 #include <unordered_map>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <array>
+#include <queue>
+#include <vector>
 
 namespace BidCoS
 {
@@ -54,6 +59,11 @@ public:
 	uint32_t id = 0;
 	int64_t time;
 	std::shared_ptr<BidCoSPacket> packet;
+
+	/**
+	 * The value of "packet->fingerprint()" when the packet was set.
+	 */
+	uint64_t fingerprint = 0;
 };
 
 class BidCoSPacketManager
@@ -69,13 +79,52 @@ public:
 	void keepAlive(int32_t address);
 	void dispose(bool wait = true);
 protected:
+	/**
+	 * Packets are deleted when they weren't updated for longer than this (in milliseconds).
+	 */
+	static constexpr int64_t _maxAge = 2000;
+
+	struct Deadline
+	{
+		int64_t time = 0;
+		int32_t address = 0;
+		uint32_t id = 0;
+
+		bool operator>(const Deadline& other) const { return time > other.time; }
+	};
+
+	/**
+	 * Number of independently locked parts of the packet map. Must be a power of two.
+	 */
+	static constexpr uint32_t _shardCount = 16;
+
+	struct alignas(64) Shard
+	{
+		std::shared_mutex mutex;
+		std::unordered_map<int32_t, std::shared_ptr<BidCoSPacketInfo>> packets;
+	};
+
 	std::atomic_bool _disposing;
 	std::atomic_bool _stopWorkerThread;
     std::thread _workerThread;
-	uint32_t _id = 0;
-	std::unordered_map<int32_t, std::shared_ptr<BidCoSPacketInfo>> _packets;
-	std::mutex _packetMutex;
+	std::atomic<uint32_t> _id{0};
+
+	/**
+	 * The packets are distributed by address, so lookups for different peers don't block each other. "get()" and "getInfo()" only need a
+	 * shared lock.
+	 */
+	std::array<Shard, _shardCount> _shards;
+
+	/**
+	 * Deadlines of all packets, earliest first. Entries of replaced packets are skipped when they are due. Never lock a shard while holding
+	 * "_deadlinesMutex".
+	 */
+	std::mutex _deadlinesMutex;
+	std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> _deadlines;
+	std::condition_variable _workerConditionVariable;
 
+	Shard& getShard(int32_t address) { return _shards[(address ^ (address >> 8) ^ (address >> 16)) & (_shardCount - 1)]; }
+	void addDeadline(int32_t address, uint32_t id, int64_t time);
 	void worker();
 };
 
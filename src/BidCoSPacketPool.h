@@ -0,0 +1,121 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef BIDCOSPACKETPOOL_H_
+#define BIDCOSPACKETPOOL_H_
+
+#include <cstdint>
+
+#include "BidCoSPacket.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace BidCoS
+{
+
+/**
+ * Recycles the memory of packets. Packets are created with std::allocate_shared, so each packet and its shared_ptr control block live in one memory block.
+ * When the last reference to a packet is released, that block is put back into the pool instead of being freed. The pool state is reference counted
+ * by the packets themselves, so packets may outlive the pool.
+ */
+class BidCoSPacketPool
+{
+public:
+	BidCoSPacketPool(uint32_t maxFreeBlocks = 100);
+	virtual ~BidCoSPacketPool() = default;
+
+	/**
+	 * Creates a packet. Takes the same arguments as the constructors of BidCoSPacket.
+	 */
+	template<typename... Args>
+	std::shared_ptr<BidCoSPacket> create(Args&&... args)
+	{
+		return std::allocate_shared<BidCoSPacket>(Allocator<BidCoSPacket>(_storage), std::forward<Args>(args)...);
+	}
+
+	/**
+	 * The number of packets that were created using a recycled memory block.
+	 */
+	uint64_t hits() { return _storage->hits; }
+
+	/**
+	 * The number of packets that needed a new memory block.
+	 */
+	uint64_t misses() { return _storage->misses; }
+
+	/**
+	 * The number of memory blocks currently waiting to be reused.
+	 */
+	uint32_t freeBlocks();
+private:
+	class Storage
+	{
+	public:
+		Storage(uint32_t maxFreeBlocks);
+		virtual ~Storage();
+
+		void* allocate(std::size_t size);
+		void deallocate(void* block, std::size_t size);
+		uint32_t freeBlocks();
+
+		std::atomic<uint64_t> hits{0};
+		std::atomic<uint64_t> misses{0};
+	private:
+		std::mutex _freeBlocksMutex;
+		std::size_t _blockSize = 0;
+		uint32_t _maxFreeBlocks = 0;
+		std::vector<void*> _freeBlocks;
+	};
+
+	template<typename T>
+	class Allocator
+	{
+	public:
+		typedef T value_type;
+
+		Allocator(std::shared_ptr<Storage> storage) : storage(storage) {}
+		template<typename U> Allocator(const Allocator<U>& other) : storage(other.storage) {}
+
+		T* allocate(std::size_t n) { return static_cast<T*>(storage->allocate(n * sizeof(T))); }
+		void deallocate(T* block, std::size_t n) { storage->deallocate(block, n * sizeof(T)); }
+
+		template<typename U> bool operator==(const Allocator<U>& rhs) const { return storage == rhs.storage; }
+		template<typename U> bool operator!=(const Allocator<U>& rhs) const { return storage != rhs.storage; }
+
+		std::shared_ptr<Storage> storage;
+	};
+
+	std::shared_ptr<Storage> _storage;
+};
+
+}
+#endif /* BIDCOSPACKETPOOL_H_ */
@@ -0,0 +1,53 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "BidCoSParameterSymbols.h"
+
+namespace BidCoS
+{
+std::mutex BidCoSParameterSymbols::_symbolsMutex;
+std::unordered_map<std::string, uint32_t> BidCoSParameterSymbols::_symbols{ { "PRESS_LONG", pressLong }, { "PRESS_LONG_RELEASE", pressLongRelease } };
+
+uint32_t BidCoSParameterSymbols::get(const std::string& name)
+{
+	std::lock_guard<std::mutex> symbolsGuard(_symbolsMutex);
+	auto symbolIterator = _symbols.find(name);
+	if(symbolIterator != _symbols.end()) return symbolIterator->second;
+	uint32_t symbol = _symbols.size();
+	_symbols.emplace(name, symbol);
+	return symbol;
+}
+
+uint32_t BidCoSParameterSymbols::count()
+{
+	std::lock_guard<std::mutex> symbolsGuard(_symbolsMutex);
+	return _symbols.size();
+}
+
+}
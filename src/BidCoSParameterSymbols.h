@@ -0,0 +1,75 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef BIDCOSPARAMETERSYMBOLS_H_
+#define BIDCOSPARAMETERSYMBOLS_H_
+
+#include <cstdint>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace BidCoS
+{
+
+/**
+ * Assigns a dense integer ID to each parameter name. IDs are assigned when device descriptions are compiled, so the receive path can index
+ * values by integer instead of hashing and comparing parameter names. IDs are never reused and are only valid while the module is loaded.
+ */
+class BidCoSParameterSymbols
+{
+public:
+	/**
+	 * Parameters the receive path handles specially.
+	 */
+	enum Reserved : uint32_t
+	{
+		pressLong = 0,
+		pressLongRelease = 1
+	};
+
+	/**
+	 * Returns the ID of a parameter name. A new ID is assigned when the name is unknown.
+	 */
+	static uint32_t get(const std::string& name);
+
+	/**
+	 * Returns the number of assigned IDs.
+	 */
+	static uint32_t count();
+private:
+	static std::mutex _symbolsMutex;
+	static std::unordered_map<std::string, uint32_t> _symbols;
+
+	BidCoSParameterSymbols() = delete;
+};
+
+}
+#endif
@@ -0,0 +1,147 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "BidCoSParameterWriter.h"
+#include "GD.h"
+#include "HomeMaticCentral.h"
+
+namespace BidCoS
+{
+BidCoSParameterWriter::BidCoSParameterWriter(HomeMaticCentral* central, Durability durability, int64_t flushInterval, uint32_t bufferSize) : BidCoSWriteBehind(flushInterval)
+{
+	_central = central;
+	_durability = durability;
+	if(bufferSize > 0) _bufferSize = bufferSize;
+	if(_durability == Durability::buffered) start();
+}
+
+BidCoSParameterWriter::~BidCoSParameterWriter()
+{
+	dispose();
+}
+
+BidCoSParameterWriter::Durability BidCoSParameterWriter::parseDurability(const std::string& value)
+{
+	std::string durability = BaseLib::HelperFunctions::toLower(value);
+	if(durability == "immediate") return Durability::immediate;
+	return Durability::buffered;
+}
+
+bool BidCoSParameterWriter::write(uint64_t peerId, uint64_t databaseId, const std::vector<uint8_t>& value)
+{
+	try
+	{
+		if(_durability == Durability::immediate || databaseId == 0) return false;
+		std::lock_guard<std::mutex> bufferGuard(_bufferMutex);
+		if(_disposing) return false;
+		_bufferedWrites++;
+		auto bufferIterator = _buffer.find(databaseId);
+		if(bufferIterator != _buffer.end())
+		{
+			//Keep the time of the first write, so a constantly changing value is still written every flush interval.
+			bufferIterator->second.value = value;
+			_coalescedWrites++;
+			return true;
+		}
+		Entry& entry = _buffer[databaseId];
+		entry.peerId = peerId;
+		entry.value = value;
+		entry.time = BaseLib::HelperFunctions::getTime();
+		if(_buffer.size() >= _bufferSize) requestFlush();
+		return true;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return false;
+}
+
+bool BidCoSParameterWriter::writeBuffer()
+{
+	try
+	{
+		std::unordered_map<uint64_t, Entry> buffer;
+		{
+			std::lock_guard<std::mutex> bufferGuard(_bufferMutex);
+			if(_buffer.empty()) return false;
+			buffer.swap(_buffer);
+		}
+
+		int64_t startTime = BaseLib::HelperFunctions::getTime();
+		int64_t oldestTime = startTime;
+		std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, std::vector<uint8_t>>>> parametersByPeer;
+		for(auto& element : buffer)
+		{
+			if(element.second.time < oldestTime) oldestTime = element.second.time;
+			parametersByPeer[element.second.peerId].emplace_back(element.first, std::move(element.second.value));
+		}
+
+		for(auto& element : parametersByPeer)
+		{
+			std::shared_ptr<BidCoSPeer> peer = _central->getPeer(element.first);
+			if(!peer) continue; //Peer was deleted
+			peer->saveBufferedParameters(element.second);
+			_writtenParameters += element.second.size();
+		}
+
+		int64_t endTime = BaseLib::HelperFunctions::getTime();
+		int64_t latency = endTime - oldestTime;
+		_lastFlushLatency = latency;
+		_totalFlushLatency += latency;
+		if(latency > _maxFlushLatency) _maxFlushLatency = latency;
+		_lastFlushDuration = endTime - startTime;
+		return true;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return false;
+}
+
+BidCoSParameterWriter::Statistics BidCoSParameterWriter::getStatistics()
+{
+	Statistics statistics;
+	statistics.durability = _durability;
+	statistics.writtenParameters = _writtenParameters;
+	statistics.flushes = _flushes;
+	statistics.fullBufferFlushes = _requestedFlushes;
+	statistics.lastFlushLatency = _lastFlushLatency;
+	statistics.maxFlushLatency = _maxFlushLatency;
+	statistics.averageFlushLatency = statistics.flushes > 0 ? _totalFlushLatency / (int64_t)statistics.flushes : 0;
+	statistics.lastFlushDuration = _lastFlushDuration;
+	std::lock_guard<std::mutex> bufferGuard(_bufferMutex);
+	statistics.bufferedWrites = _bufferedWrites;
+	statistics.coalescedWrites = _coalescedWrites;
+	statistics.pendingParameters = _buffer.size();
+	return statistics;
+}
+
+}
@@ -0,0 +1,136 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef BIDCOSPARAMETERWRITER_H_
+#define BIDCOSPARAMETERWRITER_H_
+
+#include <cstdint>
+
+#include <homegear-base/BaseLib.h>
+#include "BidCoSWriteBehind.h"
+
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+namespace BidCoS
+{
+class HomeMaticCentral;
+
+/**
+ * Write-behind buffer for the values of the peers of one central. Values are stored in the buffer instead of being written to the database
+ * immediately. Repeated writes to the same parameter replace the buffered value. A background thread writes the buffer every flush interval
+ * or as soon as it is full.
+ */
+class BidCoSParameterWriter : public BidCoSWriteBehind
+{
+public:
+	enum class Durability
+	{
+		/**
+		 * Values are written to the database before "write()" returns.
+		 */
+		immediate,
+
+		/**
+		 * Values are written within one flush interval. Changes of the last interval are lost on a crash.
+		 */
+		buffered
+	};
+
+	struct Statistics
+	{
+		Durability durability = Durability::buffered;
+		uint64_t bufferedWrites = 0;
+		uint64_t coalescedWrites = 0;
+		uint64_t writtenParameters = 0;
+		uint64_t flushes = 0;
+		uint64_t fullBufferFlushes = 0;
+		uint32_t pendingParameters = 0;
+		int64_t lastFlushLatency = 0;
+		int64_t averageFlushLatency = 0;
+		int64_t maxFlushLatency = 0;
+		int64_t lastFlushDuration = 0;
+	};
+
+	/**
+	 * @param central The central owning the peers.
+	 * @param durability See "Durability".
+	 * @param flushInterval The maximum time in milliseconds a value stays in the buffer.
+	 * @param bufferSize The number of buffered parameters which triggers a flush.
+	 */
+	BidCoSParameterWriter(HomeMaticCentral* central, Durability durability, int64_t flushInterval, uint32_t bufferSize);
+	virtual ~BidCoSParameterWriter();
+
+	/**
+	 * Buffers the new value of a parameter already stored in the database.
+	 *
+	 * @param peerId The ID of the peer the parameter belongs to.
+	 * @param databaseId The database ID of the parameter.
+	 * @param value The new value.
+	 * @return Returns false when the value was not buffered. The caller needs to write the value itself in this case.
+	 */
+	bool write(uint64_t peerId, uint64_t databaseId, const std::vector<uint8_t>& value);
+
+	/**
+	 * Returns the current counters. Flush latencies are the times in milliseconds the oldest value of a flush was buffered.
+	 */
+	Statistics getStatistics();
+
+	static Durability parseDurability(const std::string& value);
+private:
+	struct Entry
+	{
+		uint64_t peerId = 0;
+		std::vector<uint8_t> value;
+		int64_t time = 0;
+	};
+
+	HomeMaticCentral* _central = nullptr;
+	Durability _durability = Durability::buffered;
+	uint32_t _bufferSize = 500;
+
+	/**
+	 * The buffered values by database ID. Protected by "_bufferMutex".
+	 */
+	std::unordered_map<uint64_t, Entry> _buffer;
+
+	uint64_t _bufferedWrites = 0;
+	uint64_t _coalescedWrites = 0;
+	std::atomic<uint64_t> _writtenParameters{0};
+	std::atomic<int64_t> _lastFlushLatency{0};
+	std::atomic<int64_t> _totalFlushLatency{0};
+	std::atomic<int64_t> _maxFlushLatency{0};
+	std::atomic<int64_t> _lastFlushDuration{0};
+
+	bool writeBuffer() override;
+};
+
+}
+#endif
@@ -33,6 +33,9 @@ class CallbackFunctionParameter;
 #include "BidCoSQueue.h"
 #include "PendingBidCoSQueues.h"
 #include "HomeMaticCentral.h"
+#include "BidCoSLatencyStatistics.h"
+#include "BidCoSParameterSymbols.h"
+#include "BidCoSVariableJournal.h"
 #include <homegear-base/BaseLib.h>
 #include "GD.h"
 #include "VirtualPeers/HmCcTc.h"
@@ -143,6 +146,7 @@ void BidCoSPeer::applyConfigFunction(int32_t channel, int32_t peerAddress, int32
 
 BidCoSPeer::~BidCoSPeer() {
   try {
+    if (pendingBidCoSQueues) pendingBidCoSQueues->setChangedCallback(std::function<void(bool)>());
     dispose();
     _pingThreadMutex.lock();
     if (_pingThread.joinable()) _pingThread.join();
@@ -215,7 +219,7 @@ void BidCoSPeer::setPhysicalInterface(std::shared_ptr<IBidCoSInterface> interfac
 BidCoSPeer::BidCoSPeer(uint32_t parentID, IPeerEventSink *eventHandler) : Peer(GD::bl, parentID, eventHandler) {
   try {
     _team.address = 0;
-    pendingBidCoSQueues.reset(new PendingBidCoSQueues());
+    createPendingQueues();
     setPhysicalInterface(GD::interfaces->getDefaultInterface());
     _lastPing = BaseLib::HelperFunctions::getTime() - (BaseLib::HelperFunctions::getRandomNumber(1, 60) * 10000);
     _bestInterfaceCurrent = std::tuple<int32_t, int32_t, std::string>(-1, 0, "");
@@ -235,56 +239,9 @@ BidCoSPeer::BidCoSPeer(int32_t id, int32_t address, std::string serialNumber, ui
 
 void BidCoSPeer::worker() {
   if (_disposing) return;
-  std::vector<std::pair<int32_t, std::string>> positionsToDelete;
-  std::map<std::int32_t, std::map<std::string, std::shared_ptr<VariableToReset>>> variablesToReset;
   int64_t time;
   try {
     time = BaseLib::HelperFunctions::getTime();
-    if (!_variablesToReset.empty()) {
-      _variablesToResetMutex.lock();
-      for (std::map<std::int32_t, std::map<std::string, std::shared_ptr<VariableToReset>>>::iterator i = _variablesToReset.begin(); i != _variablesToReset.end(); ++i) {
-        for (std::map<std::string, std::shared_ptr<VariableToReset>>::iterator j = i->second.begin(); j != i->second.end(); ++j) {
-          if (j->second->resetTime <= time) {
-            variablesToReset[i->first][j->first] = j->second;
-            positionsToDelete.push_back(std::pair<int32_t, std::string>(i->first, j->first));
-          }
-        }
-      }
-      _variablesToResetMutex.unlock();
-      for (std::map<std::int32_t, std::map<std::string, std::shared_ptr<VariableToReset>>>::iterator i = variablesToReset.begin(); i != variablesToReset.end(); ++i) {
-        for (std::map<std::string, std::shared_ptr<VariableToReset>>::iterator j = i->second.begin(); j != i->second.end(); ++j) {
-          if (j->second->isDominoEvent) {
-            BaseLib::Systems::RpcConfigurationParameter &parameter = valuesCentral.at(j->second->channel).at(j->second->key);
-            parameter.setBinaryData(j->second->data);
-            if (parameter.databaseId > 0) saveParameter(parameter.databaseId, j->second->data);
-            else saveParameter(0, ParameterGroup::Type::Enum::variables, j->second->channel, j->second->key, j->second->data);
-            std::shared_ptr<std::vector<std::string>> valueKeys(new std::vector<std::string>{j->second->key});
-            std::shared_ptr<std::vector<PVariable>> rpcValues(new std::vector<PVariable>{valuesCentral.at(j->second->channel).at(j->second->key).rpcParameter->convertFromPacket(j->second->data, parameter.mainRole(), false)});
-            GD::out.printInfo("Info: Domino event: " + j->second->key + " of peer " + std::to_string(_peerID) + " with serial number " + _serialNumber + ":" + std::to_string(j->second->channel) + " was reset.");
-            std::string eventSource = "device-" + std::to_string(_peerID);
-            std::string address(_serialNumber + ":" + std::to_string(j->second->channel));
-            raiseEvent(eventSource, _peerID, j->second->channel, valueKeys, rpcValues);
-            raiseRPCEvent(eventSource, _peerID, j->second->channel, address, valueKeys, rpcValues);
-          } else {
-            if (!_disposing && !deleting && _lastPing < time) //Check that _lastPing wasn't set in putParamset after locking the mutex
-            {
-              std::lock_guard<std::mutex> pingGuard(_pingThreadMutex);
-              _lastPing = time; //Set here to avoid race condition between worker thread and ping thread
-              _bl->threadManager.join(_pingThread);
-              _bl->threadManager.start(_pingThread, false, &BidCoSPeer::pingThread, this);
-            }
-          }
-        }
-      }
-      _variablesToResetMutex.lock();
-      for (std::vector<std::pair<int32_t, std::string>>::reverse_iterator i = positionsToDelete.rbegin(); i != positionsToDelete.rend(); ++i) {
-        _variablesToReset[i->first].erase(i->second);
-        if (_variablesToReset[i->first].empty()) _variablesToReset.erase(i->first);
-      }
-      _variablesToResetMutex.unlock();
-      positionsToDelete.clear();
-      variablesToReset.clear();
-    }
     if (_rpcDevice) {
       serviceMessages->checkUnreach(_rpcDevice->timeout, getLastPacketReceived());
       if (serviceMessages->getUnreach()) {
@@ -299,26 +256,16 @@ void BidCoSPeer::worker() {
         }
       } else {
         if (configCentral[0].find("POLLING") != configCentral[0].end()) {
-          BaseLib::Systems::RpcConfigurationParameter &parameter = configCentral[0]["POLLING"];
-          std::vector<uint8_t> parameterData = parameter.getBinaryData();
-          if (parameterData.size() > 0 && parameterData.at(0) > 0 && configCentral[0].find("POLLING_INTERVAL") != configCentral[0].end()) {
-            //Polling is enabled
-            BaseLib::Systems::RpcConfigurationParameter &parameter = configCentral[0]["POLLING_INTERVAL"];
-            parameterData = parameter.getBinaryData();
-            int32_t data = 0;
-            _bl->hf.memcpyBigEndian(data, parameterData); //Shortcut to save resources. The normal way would be to call "convertFromPacket".
-            int64_t pollingInterval = data * 60000;
-            if (pollingInterval < 600000) pollingInterval = 600000;
-            if (time - _lastPing >= pollingInterval && (getRXModes() & HomegearDevice::ReceiveModes::Enum::always)) {
-              int64_t timeSinceLastPacket = time - ((int64_t)_lastPacketReceived * 1000);
-              if (timeSinceLastPacket > 0 && timeSinceLastPacket >= pollingInterval) {
-                if (!_disposing && !deleting && _lastPing < time) //Check that _lastPing wasn't set in putParamset after locking the mutex
-                {
-                  std::lock_guard<std::mutex> pingGuard(_pingThreadMutex);
-                  _lastPing = time; //Set here to avoid race condition between worker thread and ping thread
-                  _bl->threadManager.join(_pingThread);
-                  _bl->threadManager.start(_pingThread, false, &BidCoSPeer::pingThread, this);
-                }
+          int64_t pollingInterval = getPollingInterval();
+          if (pollingInterval > 0 && time - _lastPing >= pollingInterval && (getRXModes() & HomegearDevice::ReceiveModes::Enum::always)) {
+            int64_t timeSinceLastPacket = time - ((int64_t)_lastPacketReceived * 1000);
+            if (timeSinceLastPacket > 0 && timeSinceLastPacket >= pollingInterval) {
+              if (!_disposing && !deleting && _lastPing < time) //Check that _lastPing wasn't set in putParamset after locking the mutex
+              {
+                std::lock_guard<std::mutex> pingGuard(_pingThreadMutex);
+                _lastPing = time; //Set here to avoid race condition between worker thread and ping thread
+                _bl->threadManager.join(_pingThread);
+                _bl->threadManager.start(_pingThread, false, &BidCoSPeer::pingThread, this);
               }
             }
           }
@@ -338,7 +285,6 @@ void BidCoSPeer::worker() {
   }
   catch (const std::exception &ex) {
     GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-    _variablesToResetMutex.unlock();
   }
 }
 
@@ -756,9 +702,9 @@ void BidCoSPeer::serializeVariablesToReset(std::vector<uint8_t> &encodedData) {
   try {
     BaseLib::BinaryEncoder encoder(_bl);
     _variablesToResetMutex.lock();
-    encoder.encodeInteger(encodedData, _variablesToReset.size());
-    for (std::map<std::int32_t, std::map<std::string, std::shared_ptr<VariableToReset>>>::iterator i = _variablesToReset.begin(); i != _variablesToReset.end(); ++i) {
-      for (std::map<std::string, std::shared_ptr<VariableToReset>>::iterator j = i->second.begin(); j != i->second.end(); ++j) {
+    encoder.encodeInteger(encodedData, _variablesToResetCount);
+    for (std::map<std::int32_t, std::map<uint32_t, std::shared_ptr<VariableToReset>>>::iterator i = _variablesToReset.begin(); i != _variablesToReset.end(); ++i) {
+      for (std::map<uint32_t, std::shared_ptr<VariableToReset>>::iterator j = i->second.begin(); j != i->second.end(); ++j) {
         encoder.encodeInteger(encodedData, j->second->channel);
         encoder.encodeString(encodedData, j->second->key);
         encoder.encodeInteger(encodedData, j->second->data.size());
@@ -778,6 +724,7 @@ void BidCoSPeer::unserializeVariablesToReset(std::shared_ptr<std::vector<char>>
   try {
     _variablesToResetMutex.lock();
     _variablesToReset.clear();
+    _variablesToResetCount = 0;
     _variablesToResetMutex.unlock();
     BaseLib::BinaryDecoder decoder(_bl);
     uint32_t position = 0;
@@ -791,9 +738,13 @@ void BidCoSPeer::unserializeVariablesToReset(std::shared_ptr<std::vector<char>>
       position += dataSize;
       variable->resetTime = ((int64_t)decoder.decodeInteger(*serializedData, position)) * 1000;
       variable->isDominoEvent = decoder.decodeBoolean(*serializedData, position);
+      variable->symbol = BidCoSParameterSymbols::get(variable->key);
       try {
         _variablesToResetMutex.lock();
-        _variablesToReset[variable->channel][variable->key] = variable;
+        variable->generation = ++_variablesToResetGeneration;
+        std::shared_ptr<VariableToReset> &element = _variablesToReset[variable->channel][variable->symbol];
+        if (!element) _variablesToResetCount++;
+        element = variable;
       }
       catch (const std::exception &ex) {
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
@@ -882,6 +833,244 @@ void BidCoSPeer::savePendingQueues() {
   }
 }
 
+int64_t BidCoSPeer::getPollingInterval() {
+  try {
+    auto pollingIterator = configCentral[0].find("POLLING");
+    if (pollingIterator == configCentral[0].end()) return 0;
+    std::vector<uint8_t> parameterData = pollingIterator->second.getBinaryData();
+    if (parameterData.empty() || parameterData.at(0) == 0) return 0;
+    auto intervalIterator = configCentral[0].find("POLLING_INTERVAL");
+    if (intervalIterator == configCentral[0].end()) return 0;
+    parameterData = intervalIterator->second.getBinaryData();
+    int32_t data = 0;
+    _bl->hf.memcpyBigEndian(data, parameterData); //Shortcut to save resources. The normal way would be to call "convertFromPacket".
+    int64_t pollingInterval = data * 60000;
+    if (pollingInterval < 600000) pollingInterval = 600000;
+    return pollingInterval;
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+  return 0;
+}
+
+int64_t BidCoSPeer::getNextWorkerTime() {
+  int64_t time = BaseLib::HelperFunctions::getTime();
+  try {
+    //Resets of variables have their own reset tokens in the scheduler of the central.
+    //Deadlines which can't be handled right now (e. g. a ping which is skipped because the device doesn't always listen) are checked again after
+    //one second at the earliest.
+    int64_t nextTime = time + _maxWorkerInterval;
+    if (_rpcDevice) {
+      bool alwaysListening = getRXModes() & HomegearDevice::ReceiveModes::Enum::always;
+      if (!serviceMessages->getUnreach()) {
+        if (_rpcDevice->timeout > 0) nextTime = std::min(nextTime, ((int64_t)getLastPacketReceived() + (int64_t)_rpcDevice->timeout + 1) * 1000);
+        int64_t pollingInterval = getPollingInterval();
+        if (pollingInterval > 0 && alwaysListening) nextTime = std::min(nextTime, std::max((int64_t)_lastPing, (int64_t)_lastPacketReceived * 1000) + pollingInterval);
+      } else if (alwaysListening) nextTime = std::min(nextTime, (int64_t)_lastPing + 600001);
+    }
+    if (serviceMessages->getConfigPending() || _valuePending) nextTime = std::min(nextTime, time + _pendingCheckInterval);
+    if (nextTime < time + 1000) nextTime = time + 1000;
+    return nextTime;
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+  return time + _pendingCheckInterval;
+}
+
+void BidCoSPeer::addVariableToReset(std::shared_ptr<VariableToReset> variable) {
+  try {
+    variable->symbol = BidCoSParameterSymbols::get(variable->key);
+    {
+      std::lock_guard<std::mutex> variablesToResetGuard(_variablesToResetMutex);
+      variable->generation = ++_variablesToResetGeneration;
+      std::shared_ptr<VariableToReset> &element = _variablesToReset[variable->channel][variable->symbol];
+      if (!element) _variablesToResetCount++;
+      element = variable;
+    }
+    std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(getCentral());
+    if (central && central->getPeerScheduler()) scheduleVariableToReset(central->getPeerScheduler(), *variable);
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void BidCoSPeer::scheduleVariableToReset(BidCoSPeerScheduler *scheduler, const VariableToReset &variable) {
+  BidCoSPeerScheduler::ResetToken token;
+  token.time = variable.resetTime;
+  token.peerId = _peerID;
+  token.channel = variable.channel;
+  token.symbol = variable.symbol;
+  token.generation = variable.generation;
+  scheduler->scheduleReset(token);
+}
+
+void BidCoSPeer::scheduleVariablesToReset(BidCoSPeerScheduler *scheduler) {
+  try {
+    if (!scheduler) return;
+    std::lock_guard<std::mutex> variablesToResetGuard(_variablesToResetMutex);
+    for (auto &channel : _variablesToReset) {
+      for (auto &variable : channel.second) {
+        scheduleVariableToReset(scheduler, *variable.second);
+      }
+    }
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void BidCoSPeer::cancelVariableToReset(uint32_t channel, uint32_t symbol, const std::vector<uint8_t> *data) {
+  try {
+    if (_variablesToResetCount == 0) return;
+    std::lock_guard<std::mutex> variablesToResetGuard(_variablesToResetMutex);
+    auto channelIterator = _variablesToReset.find(channel);
+    if (channelIterator == _variablesToReset.end()) return;
+    auto variableIterator = channelIterator->second.find(symbol);
+    if (variableIterator == channelIterator->second.end()) return;
+    if (data && variableIterator->second->data != *data) return;
+    if (GD::bl->debugLevel >= 5) GD::out.printDebug("Debug: Deleting element " + variableIterator->second->key + " from _variablesToReset. Peer: " + std::to_string(_peerID) + " Serial number: " + _serialNumber, 5);
+    channelIterator->second.erase(variableIterator);
+    if (channelIterator->second.empty()) _variablesToReset.erase(channelIterator);
+    _variablesToResetCount--;
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void BidCoSPeer::resetVariable(uint32_t channel, uint32_t symbol, uint64_t generation) {
+  try {
+    if (_disposing || deleting) return;
+    std::shared_ptr<VariableToReset> variable;
+    {
+      std::lock_guard<std::mutex> variablesToResetGuard(_variablesToResetMutex);
+      auto channelIterator = _variablesToReset.find(channel);
+      if (channelIterator == _variablesToReset.end()) return;
+      auto variableIterator = channelIterator->second.find(symbol);
+      if (variableIterator == channelIterator->second.end() || variableIterator->second->generation != generation) return; //Cancelled or replaced
+      variable = variableIterator->second;
+      channelIterator->second.erase(variableIterator);
+      if (channelIterator->second.empty()) _variablesToReset.erase(channelIterator);
+      _variablesToResetCount--;
+    }
+
+    if (variable->isDominoEvent) {
+      BaseLib::Systems::RpcConfigurationParameter &parameter = valuesCentral.at(variable->channel).at(variable->key);
+      parameter.setBinaryData(variable->data);
+      saveValue(variable->channel, variable->key, parameter, variable->data);
+      std::shared_ptr<std::vector<std::string>> valueKeys(new std::vector<std::string>{variable->key});
+      std::shared_ptr<std::vector<PVariable>> rpcValues(new std::vector<PVariable>{parameter.rpcParameter->convertFromPacket(variable->data, parameter.mainRole(), false)});
+      GD::out.printInfo("Info: Domino event: " + variable->key + " of peer " + std::to_string(_peerID) + " with serial number " + _serialNumber + ":" + std::to_string(variable->channel) + " was reset.");
+      std::string eventSource = "device-" + std::to_string(_peerID);
+      std::string address(_serialNumber + ":" + std::to_string(variable->channel));
+      raiseEvent(eventSource, _peerID, variable->channel, valueKeys, rpcValues);
+      raiseRPCEvent(eventSource, _peerID, variable->channel, address, valueKeys, rpcValues);
+    } else {
+      int64_t time = BaseLib::HelperFunctions::getTime();
+      if (!_disposing && !deleting && _lastPing < time) //Check that _lastPing wasn't set in putParamset after locking the mutex
+      {
+        std::lock_guard<std::mutex> pingGuard(_pingThreadMutex);
+        _lastPing = time; //Set here to avoid race condition between worker thread and ping thread
+        _bl->threadManager.join(_pingThread);
+        _bl->threadManager.start(_pingThread, false, &BidCoSPeer::pingThread, this);
+      }
+    }
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void BidCoSPeer::saveVariableLater(uint32_t index) {
+  try {
+    if (_peerID != 0 && GD::variableJournal && GD::variableJournal->append(_peerID, index)) return;
+    //Pending queues are written by "save()" when the journal is not available.
+    if (index != 16) saveJournaledVariables(1u << index);
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void BidCoSPeer::saveJournaledVariables(uint32_t variables) {
+  try {
+    if (variables & (1u << 5)) saveVariable(5, (int32_t)_messageCounter);
+    if (variables & (1u << 16)) savePendingQueues();
+    if (variables & (1u << 20)) saveVariable(20, (int32_t)_valuePending);
+    if (variables & (1u << 22)) saveVariable(22, (int32_t)_generalCounter);
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void BidCoSPeer::createPendingQueues() {
+  try {
+    if (pendingBidCoSQueues) pendingBidCoSQueues->setChangedCallback(std::function<void(bool)>());
+    pendingBidCoSQueues.reset(new PendingBidCoSQueues());
+    pendingBidCoSQueues->setChangedCallback(std::bind(&BidCoSPeer::pendingQueuesChanged, this, std::placeholders::_1));
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void BidCoSPeer::pendingQueuesChanged(bool empty) {
+  saveVariableLater(16);
+  schedulePendingCheck(empty);
+}
+
+void BidCoSPeer::schedulePendingCheck(bool queuesEmpty) {
+  try {
+    if (_peerID == 0 || _disposing) return;
+    std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(getCentral());
+    if (!central || !central->getPeerScheduler()) return;
+    int64_t time = BaseLib::HelperFunctions::getTime();
+    //Check right away when nothing is pending anymore, so the flags are reset without delay.
+    central->getPeerScheduler()->schedule(_peerID, queuesEmpty ? time : time + _pendingCheckInterval);
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void BidCoSPeer::saveValue(uint32_t channel, const std::string &name, BaseLib::Systems::RpcConfigurationParameter &parameter, std::vector<uint8_t> &value) {
+  try {
+    std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(getCentral());
+    saveValue(central ? central->getParameterWriter() : nullptr, channel, name, parameter, value);
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void BidCoSPeer::saveValue(BidCoSParameterWriter *writer, uint32_t channel, const std::string &name, BaseLib::Systems::RpcConfigurationParameter &parameter, std::vector<uint8_t> &value) {
+  try {
+    int64_t startTime = BidCoSLatencyStatistics::now();
+    if (parameter.databaseId > 0) {
+      if (!writer || !writer->write(_peerID, parameter.databaseId, value)) saveParameter(parameter.databaseId, value);
+    } else saveParameter(0, ParameterGroup::Type::Enum::variables, channel, name, value); //Inserts are never buffered, so "databaseId" is set when this returns.
+    if (GD::latencyStatistics) GD::latencyStatistics->recordSince(getPhysicalInterfaceID(), BidCoSLatencyStatistics::Stage::databaseSave, startTime);
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void BidCoSPeer::saveBufferedParameters(std::vector<std::pair<uint64_t, std::vector<uint8_t>>> &parameters) {
+  try {
+    for (auto &parameter : parameters) {
+      saveParameter(parameter.first, parameter.second);
+    }
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
 bool BidCoSPeer::pendingQueuesEmpty() {
   if (!pendingBidCoSQueues) return true;
   return pendingBidCoSQueues->empty();
@@ -935,7 +1124,7 @@ void BidCoSPeer::loadVariables(BaseLib::Systems::ICentral *device, std::shared_p
           break;
         case 16:
           if (device) {
-            pendingBidCoSQueues.reset(new PendingBidCoSQueues());
+            createPendingQueues();
             pendingBidCoSQueues->unserialize(row->second.at(5)->binaryValue, this);
           }
           break;
@@ -953,7 +1142,7 @@ void BidCoSPeer::loadVariables(BaseLib::Systems::ICentral *device, std::shared_p
           break;
       }
     }
-    if (!pendingBidCoSQueues) pendingBidCoSQueues.reset(new PendingBidCoSQueues());
+    if (!pendingBidCoSQueues) createPendingQueues();
   }
   catch (const std::exception &ex) {
     GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
@@ -1239,7 +1428,8 @@ void BidCoSPeer::onConfigPending(bool configPending) {
 void BidCoSPeer::setValuePending(bool value) {
   try {
     _valuePending = value;
-    saveVariable(20, value);
+    saveVariableLater(20);
+    if (value) schedulePendingCheck(!pendingBidCoSQueues || pendingBidCoSQueues->empty());
 
     HomegearDevice::ReceiveModes::Enum rxModes = getRXModes();
     if (value) {
@@ -1320,106 +1510,111 @@ bool BidCoSPeer::firmwareUpdateAvailable() {
   return false;
 }
 
-void BidCoSPeer::getValuesFromPacket(std::shared_ptr<BidCoSPacket> packet, std::vector<FrameValues> &frameValues) {
+uint32_t BidCoSPeer::getValuesFromPacket(std::shared_ptr<BidCoSPacket> packet, std::vector<FrameValues> &frameValues) {
+  uint32_t frameCount = 0;
   try {
-    if (!_rpcDevice) return;
-    //equal_range returns all elements with "0" or an unknown element as argument
-    if (packet->messageType() == 0 || _rpcDevice->packetsByMessageType.find(packet->messageType()) == _rpcDevice->packetsByMessageType.end()) return;
-    std::pair<PacketsByMessageType::iterator, PacketsByMessageType::iterator> range = _rpcDevice->packetsByMessageType.equal_range((uint32_t)packet->messageType());
-    if (range.first == _rpcDevice->packetsByMessageType.end()) return;
-    PacketsByMessageType::iterator i = range.first;
-    do {
-      FrameValues currentFrameValues;
-      PPacket frame(i->second);
-      if (!frame) continue;
-      if (frame->direction == Packet::Direction::Enum::toCentral && packet->senderAddress() != _address && (!hasTeam() || packet->senderAddress() != _team.address)) continue;
-      if (frame->direction == Packet::Direction::Enum::fromCentral && packet->destinationAddress() != _address) continue;
-      if (packet->payload().empty()) break;
-      if (frame->subtype > -1 && frame->subtypeIndex >= 9 && (signed)packet->payload().size() > (frame->subtypeIndex - 9) && packet->payload().at(frame->subtypeIndex - 9) != (unsigned)frame->subtype) continue;
-      int32_t channelIndex = frame->channelIndex;
+    if (!_rpcDevice) return 0;
+    if (packet->messageType() == 0) return 0;
+    std::shared_ptr<BidCoSFrameDecoder> frameDecoder = std::atomic_load(&_frameDecoder);
+    if (!frameDecoder || !frameDecoder->isDecoderFor(_rpcDevice)) {
+      frameDecoder = BidCoSFrameDecoder::get(_rpcDevice);
+      if (!frameDecoder) return 0;
+      std::atomic_store(&_frameDecoder, frameDecoder);
+    }
+
+    auto hasVariable = [&](const BidCoSFrameDecoder::Variable &variable, int32_t channel) {
+      if (channel >= 0 && channel < (signed)BidCoSFrameDecoder::maxStaticChannels && variable.staticChannels.test(channel)) return variable.channelsWithVariable.test(channel);
+      PParameterGroup parameterGroup = getParameterSet(channel, variable.parameterSetType);
+      return parameterGroup && parameterGroup->parameters.find(variable.parameter->id) != parameterGroup->parameters.end();
+    };
+
+    BidCoSPayload &payload = packet->payload();
+    BidCoSPayload dataBuffer;
+    for (const BidCoSFrameDecoder::Frame &frame : frameDecoder->getFrames(packet->messageType())) {
+      if (frame.frame->direction == Packet::Direction::Enum::toCentral && packet->senderAddress() != _address && (!hasTeam() || packet->senderAddress() != _team.address)) continue;
+      if (frame.frame->direction == Packet::Direction::Enum::fromCentral && packet->destinationAddress() != _address) continue;
+      if (payload.empty()) break;
+      if (frame.subtypePayloadIndex > -1 && (signed)payload.size() > frame.subtypePayloadIndex && payload[frame.subtypePayloadIndex] != (unsigned)frame.subtype) continue;
       int32_t channel = -1;
-      if (channelIndex >= 9 && (signed)packet->payload().size() > (channelIndex - 9)) channel = packet->payload().at(channelIndex - 9);
-      if (channel > -1 && frame->channelSize < 1.0) channel &= (0xFF >> (8 - std::lround(frame->channelSize * 10) % 10));
-      if (frame->channel > -1) channel = frame->channel;
-      if (frame->length > 0 && packet->length() != frame->length) continue;
-      currentFrameValues.frameID = frame->id;
-
-      for (BinaryPayloads::iterator j = frame->binaryPayloads.begin(); j != frame->binaryPayloads.end(); ++j) {
-        std::vector<uint8_t> data;
-        if ((*j)->size > 0 && (*j)->index > 0) {
-          if (((int32_t)(*j)->index) - 9 >= (signed)packet->payload().size()) continue;
-          data = packet->getPosition((*j)->index, (*j)->size, -1);
-
-          if ((*j)->constValueInteger > -1) {
-            int32_t intValue = 0;
-            _bl->hf.memcpyBigEndian(intValue, data);
-            if (intValue != (*j)->constValueInteger) break; else continue;
+      if (frame.channelPayloadIndex > -1 && (signed)payload.size() > frame.channelPayloadIndex) channel = payload[frame.channelPayloadIndex] & frame.channelMask;
+      if (frame.fixedChannel > -1) channel = frame.fixedChannel;
+      if (frame.length > 0 && packet->length() != frame.length) continue;
+
+      if (frameValues.size() <= frameCount) frameValues.emplace_back();
+      FrameValues &currentFrameValues = frameValues[frameCount];
+      currentFrameValues.frame = frame.frame;
+      currentFrameValues.paramsetChannels.clear();
+      currentFrameValues.valueCount = 0;
+      if (currentFrameValues.values.size() < frame.slotCount) currentFrameValues.values.resize(frame.slotCount);
+      for (FrameValue &value : currentFrameValues.values) {
+        value.isSet = false;
+        value.channels.clear();
+      }
+
+      for (const BidCoSFrameDecoder::BinaryPayload &binaryPayload : frame.binaryPayloads) {
+        if (binaryPayload.fromPacket) {
+          if ((signed)payload.size() < binaryPayload.minPayloadSize) continue;
+          if (binaryPayload.constValueInteger > -1) {
+            if (packet->getPositionInteger(binaryPayload.position) != binaryPayload.constValueInteger) break; else continue;
           }
-        } else if ((*j)->constValueInteger > -1) {
-          _bl->hf.memcpyBigEndian(data, (*j)->constValueInteger);
-        } else continue;
-        for (std::vector<PParameter>::iterator k = frame->associatedVariables.begin(); k != frame->associatedVariables.end(); ++k) {
-          if ((*k)->physical->groupId != (*j)->parameterId) continue;
-          currentFrameValues.parameterSetType = (*k)->parent()->type();
+          packet->getPosition(binaryPayload.position, dataBuffer);
+        }
+        for (uint32_t k = binaryPayload.variablesBegin; k < binaryPayload.variablesEnd; k++) {
+          const BidCoSFrameDecoder::Variable &variable = frame.variables[k];
+          FrameValue &value = currentFrameValues.values[variable.slot];
+          currentFrameValues.parameterSetType = variable.parameterSetType;
           bool setValues = false;
           if (currentFrameValues.paramsetChannels.empty()) //Fill paramsetChannels
           {
             int32_t startChannel = (channel < 0) ? 0 : channel;
             int32_t endChannel;
             //When fixedChannel is -2 (means '*') cycle through all channels
-            if (frame->channel == -2) {
+            if (frame.fixedChannel == -2) {
               startChannel = 0;
-              endChannel = _rpcDevice->functions.rbegin()->first;
+              endChannel = frameDecoder->lastChannel();
             } else endChannel = startChannel;
             for (int32_t l = startChannel; l <= endChannel; l++) {
-              PParameterGroup parameterGroup = getParameterSet(l, currentFrameValues.parameterSetType);
-              if (!parameterGroup || parameterGroup->parameters.find((*k)->id) == parameterGroup->parameters.end()) continue;
+              if (!hasVariable(variable, l)) continue;
               currentFrameValues.paramsetChannels.push_back(l);
-              currentFrameValues.values[(*k)->id].channels.insert(l);
+              value.addChannel(l);
               setValues = true;
             }
           } else //Use paramsetChannels
           {
-            for (std::list<uint32_t>::const_iterator l = currentFrameValues.paramsetChannels.begin(); l != currentFrameValues.paramsetChannels.end(); ++l) {
-              PParameterGroup parameterGroup = getParameterSet(*l, currentFrameValues.parameterSetType);
-              if (!parameterGroup || parameterGroup->parameters.find((*k)->id) == parameterGroup->parameters.end()) continue;
-              currentFrameValues.values[(*k)->id].channels.insert(*l);
+            for (uint32_t l : currentFrameValues.paramsetChannels) {
+              if (!hasVariable(variable, l)) continue;
+              value.addChannel(l);
               setValues = true;
             }
           }
-          if (setValues) currentFrameValues.values[(*k)->id].value = data;
+          if (setValues) {
+            value.parameter = variable.parameter;
+            value.symbol = variable.symbol;
+            if (binaryPayload.fromPacket) value.value.assign(dataBuffer.begin(), dataBuffer.end());
+            else value.value = binaryPayload.constValue;
+            if (!value.isSet) {
+              value.isSet = true;
+              currentFrameValues.valueCount++;
+            }
+          }
         }
       }
-      if (!currentFrameValues.values.empty()) frameValues.push_back(currentFrameValues);
-    } while (++i != range.second && i != _rpcDevice->packetsByMessageType.end());
+      if (currentFrameValues.valueCount > 0) frameCount++;
+    }
   }
   catch (const std::exception &ex) {
     GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
   }
+  return frameCount;
 }
 
-void BidCoSPeer::handleDominoEvent(PParameter parameter, std::string &frameID, uint32_t channel) {
+void BidCoSPeer::handleDominoEvent(PParameter parameter, uint32_t symbol, std::string &frameID, uint32_t channel) {
   try {
     if (!parameter || !parameter->hasDelayedAutoResetParameters) return;
     for (std::vector<std::shared_ptr<Parameter::Packet>>::iterator j = parameter->eventPackets.begin(); j != parameter->eventPackets.end(); ++j) {
       if ((*j)->id != frameID) continue;
       if ((*j)->delayedAutoReset.first.empty()) continue;
-      if (!_variablesToReset.empty()) {
-        bool breakLoop = false;
-        _variablesToResetMutex.lock();
-        for (std::map<std::int32_t, std::map<std::string, std::shared_ptr<VariableToReset>>>::iterator k = _variablesToReset.begin(); k != _variablesToReset.end(); ++k) {
-          for (std::map<std::string, std::shared_ptr<VariableToReset>>::iterator l = k->second.begin(); l != k->second.end(); ++l) {
-            if (l->second->channel == channel && l->second->key == parameter->id) {
-              GD::out.printDebug("Debug: Deleting element " + parameter->id + " from _variablesToReset. Peer: " + std::to_string(_peerID) + " Serial number: " + _serialNumber + " Frame: " + frameID);
-              _variablesToReset.erase(k);
-              breakLoop = true;
-              break; //The key should only be once in the vector, so breaking is ok and we can't continue as the iterator is invalidated.
-            }
-          }
-          if (breakLoop) break;
-        }
-        _variablesToResetMutex.unlock();
-      }
+      cancelVariableToReset(channel, symbol);
       PParameterGroup parameterGroup = getParameterSet(channel, ParameterGroup::Type::Enum::variables);
       if (!parameterGroup) continue;
       PParameter delayParameter = parameterGroup->parameters.at((*j)->delayedAutoReset.first);
@@ -1435,9 +1630,7 @@ void BidCoSPeer::handleDominoEvent(PParameter parameter, std::string &frameID, u
       variable->resetTime = time + (delay * 1000);
       variable->key = parameter->id;
       variable->isDominoEvent = true;
-      _variablesToResetMutex.lock();
-      _variablesToReset[variable->channel][variable->key] = variable;
-      _variablesToResetMutex.unlock();
+      addVariableToReset(variable);
       GD::out.printDebug("Debug: " + parameter->id + " will be reset in " + std::to_string((variable->resetTime - time) / 1000) + "s.", 5);
     }
   }
@@ -1585,8 +1778,7 @@ PVariable BidCoSPeer::getValueFromDevice(PParameter &parameter, int32_t channel,
     std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(getCentral());
     if (responseFrame) queue->push(std::shared_ptr<BidCoSMessage>(new BidCoSMessage(responseFrame->type, 0, nullptr)));
     else queue->push(std::shared_ptr<BidCoSMessage>(new BidCoSMessage(-1, 0, nullptr)));
-    pendingBidCoSQueues->remove(BidCoSQueueType::GETVALUE, parameter->id, channel);
-    pendingBidCoSQueues->push(queue);
+    pendingBidCoSQueues->push(queue); //Replaces an unsent GETVALUE queue for the same parameter
 
     //Assign the queue managers queue to "queue".
     queue = central->enqueuePendingQueues(_address);
@@ -1660,6 +1852,36 @@ PParameterGroup BidCoSPeer::getParameterSet(int32_t channel, ParameterGroup::Typ
   return PParameterGroup();
 }
 
+BaseLib::Systems::RpcConfigurationParameter &BidCoSPeer::getValueSlot(uint32_t channel, uint32_t symbol, const std::string &name) {
+  if (channel > 255) return valuesCentral[channel][name];
+  std::lock_guard<std::mutex> valueSlotsGuard(_valueSlotsMutex);
+  if (channel >= _valueSlots.size()) _valueSlots.resize(channel + 1);
+  ValueSlots &valueSlots = _valueSlots[channel];
+  if (valueSlots.generation != _valuesCentralGeneration) {
+    valueSlots.generation = _valuesCentralGeneration;
+    std::fill(valueSlots.slots.begin(), valueSlots.slots.end(), nullptr);
+  }
+  if (symbol >= valueSlots.slots.size()) valueSlots.slots.resize(std::max(BidCoSParameterSymbols::count(), symbol + 1), nullptr);
+  BaseLib::Systems::RpcConfigurationParameter *&slot = valueSlots.slots[symbol];
+  if (!slot) slot = &valuesCentral[channel][name]; //Inserting into "valuesCentral" never moves existing elements.
+  return *slot;
+}
+
+void BidCoSPeer::invalidateValueSlots() {
+  std::lock_guard<std::mutex> valueSlotsGuard(_valueSlotsMutex);
+  _valuesCentralGeneration++;
+}
+
+void BidCoSPeer::initializeCentralConfig() {
+  try {
+    Peer::initializeCentralConfig();
+    invalidateValueSlots();
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
 void BidCoSPeer::packetReceived(std::shared_ptr<BidCoSPacket> packet) {
   try {
     if (!packet) return;
@@ -1668,6 +1890,7 @@ void BidCoSPeer::packetReceived(std::shared_ptr<BidCoSPacket> packet) {
     if (!_rpcDevice) return;
     std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(getCentral());
     if (!central) return;
+    BidCoSParameterWriter *parameterWriter = central->getParameterWriter();
     setLastPacketReceived();
     setRSSIDevice(packet->rssiDevice());
     serviceMessages->endUnreach();
@@ -1676,39 +1899,43 @@ void BidCoSPeer::packetReceived(std::shared_ptr<BidCoSPacket> packet) {
       else _bl->out.printInfo("Info: Ignoring broadcast packet from peer " + std::to_string(_peerID) + " to other peer, because AES handshakes are enabled for this peer.");
       return;
     }
+    //The buffer is taken from the thread and given back after processing, so its memory is reused for the next packet.
+    static thread_local std::vector<FrameValues> frameValuesBuffer;
     std::vector<FrameValues> frameValues;
-    getValuesFromPacket(packet, frameValues);
+    frameValues.swap(frameValuesBuffer);
+    uint32_t frameCount = getValuesFromPacket(packet, frameValues);
+    bool variablesToReset = _variablesToResetCount > 0; //Checked once, so packets without pending resets don't touch "_variablesToResetMutex"
     std::map<uint32_t, std::shared_ptr<std::vector<std::string>>> valueKeys;
     std::map<uint32_t, std::shared_ptr<std::vector<PVariable>>> rpcValues;
     //Loop through all matching frames
-    for (std::vector<FrameValues>::iterator a = frameValues.begin(); a != frameValues.end(); ++a) {
-      PPacket frame;
-      if (!a->frameID.empty()) frame = _rpcDevice->packetsById.at(a->frameID);
+    for (uint32_t frameIndex = 0; frameIndex < frameCount; frameIndex++) {
+      FrameValues *a = &frameValues[frameIndex];
+      PPacket &frame = a->frame;
 
       //Check for low battery
       //If values is not empty, packet is valid
-      if (_rpcDevice->hasBattery && !a->values.empty() && !packet->payload().empty() && frame && hasLowbatBit(frame)) {
+      if (_rpcDevice->hasBattery && a->valueCount > 0 && !packet->payload().empty() && frame && hasLowbatBit(frame)) {
         if (packet->payload().at(0) & 0x80) serviceMessages->set("LOWBAT", true);
         else serviceMessages->set("LOWBAT", false);
       }
 
-      for (std::map<std::string, FrameValue>::iterator i = a->values.begin(); i != a->values.end(); ++i) {
-        for (std::list<uint32_t>::const_iterator j = a->paramsetChannels.begin(); j != a->paramsetChannels.end(); ++j) {
+      for (std::vector<FrameValue>::iterator i = a->values.begin(); i != a->values.end(); ++i) {
+        if (!i->isSet) continue;
+        for (std::vector<uint32_t>::const_iterator j = a->paramsetChannels.begin(); j != a->paramsetChannels.end(); ++j) {
           if (packet->messageType() == 0x02 && aesEnabled(*j) && !packet->validAesAck()) continue;
-          if (std::find(i->second.channels.begin(), i->second.channels.end(), *j) == i->second.channels.end()) continue;
-          if (pendingBidCoSQueues->exists(BidCoSQueueType::PEER, i->first, *j)) continue; //Don't set queued values
+          if (std::find(i->channels.begin(), i->channels.end(), *j) == i->channels.end()) continue;
+          if (pendingBidCoSQueues->exists(BidCoSQueueType::PEER, i->parameter->id, *j)) continue; //Don't set queued values
           if (!valueKeys[*j] || !rpcValues[*j]) {
             valueKeys[*j].reset(new std::vector<std::string>());
             rpcValues[*j].reset(new std::vector<PVariable>());
           }
 
-          BaseLib::Systems::RpcConfigurationParameter &parameter = valuesCentral[*j][i->first];
-          parameter.setBinaryData(i->second.value);
-          if (parameter.databaseId > 0) saveParameter(parameter.databaseId, i->second.value);
-          else saveParameter(0, ParameterGroup::Type::Enum::variables, *j, i->first, i->second.value);
+          BaseLib::Systems::RpcConfigurationParameter &parameter = getValueSlot(*j, i->symbol, i->parameter->id);
+          parameter.setBinaryData(i->value);
+          saveValue(parameterWriter, *j, i->parameter->id, parameter, i->value);
 
           // {{{ Only set PRESS_LONG of remotes once on continuous pressing
-          if (i->first == "PRESS_LONG") {
+          if (i->symbol == BidCoSParameterSymbols::pressLong) {
             if (BaseLib::HelperFunctions::getTime() - _lastPressLong < 1000) {
               _lastPressLong = BaseLib::HelperFunctions::getTime();
               GD::out.printInfo("Info: Ignoring PRESS_LONG.");
@@ -1716,46 +1943,34 @@ void BidCoSPeer::packetReceived(std::shared_ptr<BidCoSPacket> packet) {
             }
             _lastPressLong = BaseLib::HelperFunctions::getTime();
           }
-          if (i->first == "PRESS_LONG_RELEASE") _lastPressLong = 0;
+          if (i->symbol == BidCoSParameterSymbols::pressLongRelease) _lastPressLong = 0;
           // }}}
           if (_bl->debugLevel >= 4)
             GD::out.printInfo(
-                "Info: " + i->first + " on channel " + std::to_string(*j) + " of HomeMatic BidCoS peer " + std::to_string(_peerID) + " with serial number " + _serialNumber + " was set to 0x" + BaseLib::HelperFunctions::getHexString(i->second.value)
+                "Info: " + i->parameter->id + " on channel " + std::to_string(*j) + " of HomeMatic BidCoS peer " + std::to_string(_peerID) + " with serial number " + _serialNumber + " was set to 0x" + BaseLib::HelperFunctions::getHexString(i->value)
                     + ".");
 
           /// {{{ Remove parameter from _variablesToReset
-          _variablesToResetMutex.lock();
-          std::map<std::int32_t, std::map<std::string, std::shared_ptr<VariableToReset>>>::iterator resetIterator1 = _variablesToReset.find(*j);
-          if (resetIterator1 != _variablesToReset.end()) {
-            std::map<std::string, std::shared_ptr<VariableToReset>>::iterator resetIterator2 = resetIterator1->second.find(i->first);
-            if (resetIterator2 != resetIterator1->second.end()) {
-              if (parameter.equals(resetIterator2->second->data)) {
-                if (GD::bl->debugLevel >= 5) GD::out.printDebug("Debug: Deleting element from _variablesToReset. Peer: " + std::to_string(_peerID) + " Serial number: " + _serialNumber + " Frame: " + frame->id, 5);
-                resetIterator1->second.erase(resetIterator2);
-                if (resetIterator1->second.empty()) _variablesToReset.erase(resetIterator1);
-              }
-            }
-          }
-          _variablesToResetMutex.unlock();
+          if (variablesToReset) cancelVariableToReset(*j, i->symbol, &i->value);
           /// }}}
 
           if (parameter.rpcParameter) {
             //Process service messages
-            if (parameter.rpcParameter->service && !i->second.value.empty()) {
+            if (parameter.rpcParameter->service && !i->value.empty()) {
               if (parameter.rpcParameter->logical->type == ILogical::Type::Enum::tEnum) {
                 LogicalEnumeration *logical = (LogicalEnumeration *)parameter.rpcParameter->logical.get();
-                int32_t value = i->second.value.at(0);
+                int32_t value = i->value.at(0);
                 if (value >= 0 && (unsigned)value < logical->values.size() && logical->values.at(value).id == "LOWBAT") {
                   serviceMessages->set("LOWBAT", true);
                 }
-                serviceMessages->set(i->first, value, *j);
+                serviceMessages->set(i->parameter->id, value, *j);
               } else if (parameter.rpcParameter->logical->type == ILogical::Type::Enum::tBoolean) {
-                serviceMessages->set(i->first, (bool)i->second.value.at(0));
+                serviceMessages->set(i->parameter->id, (bool)i->value.at(0));
               }
             }
 
-            valueKeys[*j]->push_back(i->first);
-            rpcValues[*j]->push_back(parameter.rpcParameter->convertFromPacket(i->second.value, parameter.mainRole(), true));
+            valueKeys[*j]->push_back(i->parameter->id);
+            rpcValues[*j]->push_back(parameter.rpcParameter->convertFromPacket(i->value, parameter.mainRole(), true));
           }
         }
       }
@@ -1766,11 +1981,11 @@ void BidCoSPeer::packetReceived(std::shared_ptr<BidCoSPacket> packet) {
         if (senderPeer) {
           //Check for low battery
           //If values is not empty, packet is valid
-          if (senderPeer->_rpcDevice->hasBattery && !a->values.empty() && !packet->payload().empty() && frame && hasLowbatBit(frame)) {
+          if (senderPeer->_rpcDevice->hasBattery && a->valueCount > 0 && !packet->payload().empty() && frame && hasLowbatBit(frame)) {
             if (packet->payload().at(0) & 0x80) senderPeer->serviceMessages->set("LOWBAT", true);
             else senderPeer->serviceMessages->set("LOWBAT", false);
           }
-          for (std::list<uint32_t>::const_iterator i = a->paramsetChannels.begin(); i != a->paramsetChannels.end(); ++i) {
+          for (std::vector<uint32_t>::const_iterator i = a->paramsetChannels.begin(); i != a->paramsetChannels.end(); ++i) {
             PParameterGroup parameterGroup = getParameterSet(*i, a->parameterSetType);
             if (!parameterGroup) continue;
             PParameter rpcParameter(parameterGroup->parameters.at("SENDERADDRESS"));
@@ -1779,8 +1994,7 @@ void BidCoSPeer::packetReceived(std::shared_ptr<BidCoSPacket> packet) {
               std::vector<uint8_t> parameterData;
               rpcParameter->convertToPacket(senderPeer->getSerialNumber() + ":" + std::to_string(*i), parameter.mainRole(), parameterData);
               parameter.setBinaryData(parameterData);
-              if (parameter.databaseId > 0) saveParameter(parameter.databaseId, parameterData);
-              else saveParameter(0, ParameterGroup::Type::Enum::variables, *i, "SENDERADDRESS", parameterData);
+              saveValue(parameterWriter, *i, "SENDERADDRESS", parameter, parameterData);
               valueKeys[*i]->push_back("SENDERADDRESS");
               rpcValues[*i]->push_back(rpcParameter->convertFromPacket(parameterData, parameter.mainRole(), true));
             }
@@ -1792,8 +2006,7 @@ void BidCoSPeer::packetReceived(std::shared_ptr<BidCoSPacket> packet) {
               std::vector<uint8_t> parameterData;
               rpcParameter->convertToPacket(peerIdValue, parameter.mainRole(), parameterData);
               parameter.setBinaryData(parameterData);
-              if (parameter.databaseId > 0) saveParameter(parameter.databaseId, parameterData);
-              else saveParameter(0, ParameterGroup::Type::Enum::variables, *i, "SENDERID", parameterData);
+              saveValue(parameterWriter, *i, "SENDERID", parameter, parameterData);
               valueKeys[*i]->push_back("SENDERID");
               rpcValues[*i]->push_back(rpcParameter->convertFromPacket(parameterData, parameter.mainRole(), true));
             }
@@ -1802,16 +2015,18 @@ void BidCoSPeer::packetReceived(std::shared_ptr<BidCoSPacket> packet) {
       }
 
       //We have to do this in a seperate loop, because all parameters need to be set first
-      for (std::map<std::string, FrameValue>::iterator i = a->values.begin(); i != a->values.end(); ++i) {
-        for (std::list<uint32_t>::const_iterator j = a->paramsetChannels.begin(); j != a->paramsetChannels.end(); ++j) {
+      for (std::vector<FrameValue>::iterator i = a->values.begin(); i != a->values.end(); ++i) {
+        if (!i->isSet) continue;
+        for (std::vector<uint32_t>::const_iterator j = a->paramsetChannels.begin(); j != a->paramsetChannels.end(); ++j) {
           if (packet->messageType() == 0x02 && aesEnabled(*j) && !packet->validAesAck()) continue;
-          if (std::find(i->second.channels.begin(), i->second.channels.end(), *j) == i->second.channels.end()) continue;
+          if (std::find(i->channels.begin(), i->channels.end(), *j) == i->channels.end()) continue;
           PParameterGroup parameterGroup = getParameterSet(*j, a->parameterSetType);
           if (!parameterGroup) continue;
-          handleDominoEvent(parameterGroup->parameters.at(i->first), a->frameID, *j);
+          handleDominoEvent(parameterGroup->parameters.at(i->parameter->id), i->symbol, frame->id, *j);
         }
       }
     }
+    frameValuesBuffer.swap(frameValues);
     std::shared_ptr<BidCoSQueue> queue = central->getQueue(_address);
     if (queue && !queue->isEmpty() && queue->getQueueType() == BidCoSQueueType::GETVALUE) {
       //Handle get value response
@@ -1863,6 +2078,7 @@ void BidCoSPeer::packetReceived(std::shared_ptr<BidCoSPacket> packet) {
 
     //if(!rpcValues.empty() && !resendPacket)
     if (!rpcValues.empty()) {
+      int64_t startTime = BidCoSLatencyStatistics::now();
       for (std::map<uint32_t, std::shared_ptr<std::vector<std::string>>>::iterator j = valueKeys.begin(); j != valueKeys.end(); ++j) {
         if (j->second->empty()) continue;
         std::string eventSource = "device-" + std::to_string(_peerID);
@@ -1870,6 +2086,7 @@ void BidCoSPeer::packetReceived(std::shared_ptr<BidCoSPacket> packet) {
         raiseEvent(eventSource, _peerID, j->first, j->second, rpcValues.at(j->first));
         raiseRPCEvent(eventSource, _peerID, j->first, address, j->second, rpcValues.at(j->first));
       }
+      if (GD::latencyStatistics) GD::latencyStatistics->recordSince(getPhysicalInterfaceID(), BidCoSLatencyStatistics::Stage::rpcEvent, startTime);
     }
   }
   catch (const std::exception &ex) {
@@ -2078,6 +2295,7 @@ PVariable BidCoSPeer::putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t ch
 
       bool aesActivated = false;
       std::map<int32_t, std::map<int32_t, std::vector<uint8_t>>> changedParameters;
+      std::map<int32_t, std::set<int32_t>> changedIndices;
       //allParameters is necessary to temporarily store all values. It is used to set changedParameters.
       //This is necessary when there are multiple variables per index and not all of them are changed.
       std::map<int32_t, std::map<int32_t, std::vector<uint8_t>>> allParameters;
@@ -2117,6 +2335,7 @@ PVariable BidCoSPeer::putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t ch
           }
         }
         parameter.rpcParameter->convertToPacket(i->second, parameter.mainRole(), value);
+        bool valueChanged = (value != parameter.getBinaryData());
         std::vector<uint8_t> shiftedValue = value;
         parameter.rpcParameter->adjustBitPosition(shiftedValue);
         int32_t intIndex = (int32_t)parameter.rpcParameter->physical->index;
@@ -2131,16 +2350,25 @@ PVariable BidCoSPeer::putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t ch
             index++;
           }
         }
-        parameter.setBinaryData(value);
-        if (parameter.databaseId > 0) saveParameter(parameter.databaseId, value);
-        else saveParameter(0, ParameterGroup::Type::Enum::config, channel, i->first, value);
+        if (valueChanged) {
+          parameter.setBinaryData(value);
+          if (parameter.databaseId > 0) saveParameter(parameter.databaseId, value);
+          else saveParameter(0, ParameterGroup::Type::Enum::config, channel, i->first, value);
+          GD::out.printInfo("Info: Parameter " + i->first + " of peer " + std::to_string(_peerID) + " and channel " + std::to_string(channel) + " was set to 0x" + BaseLib::HelperFunctions::getHexString(value) + ".");
+        }
         if (peerInfoPacketsEnabled && i->first == "AES_ACTIVE" && !aesActivated) getPhysicalInterface()->setAES(getPeerInfo(), channel);
-        GD::out.printInfo("Info: Parameter " + i->first + " of peer " + std::to_string(_peerID) + " and channel " + std::to_string(channel) + " was set to 0x" + BaseLib::HelperFunctions::getHexString(value) + ".");
         //Only send to device when parameter is of type config;
         if (parameter.rpcParameter->physical->operationType != IPhysical::OperationType::Enum::config && parameter.rpcParameter->physical->operationType != IPhysical::OperationType::Enum::configString) continue;
         //Don't active AES, when aesAlways is true as it is activated already
         if (i->first == "AES_ACTIVE" && functionIterator->second->forceEncryption) continue;
-        changedParameters[list][intIndex] = allParameters[list][intIndex];
+        //Only write registers whose value differs from the value known to be on the device
+        if (valueChanged) changedIndices[list].insert(intIndex);
+      }
+      //Registers are collected after all variables are processed, because variables sharing a register all need to be merged in
+      for (auto &changedList : changedIndices) {
+        for (auto index : changedList.second) {
+          changedParameters[changedList.first][index] = allParameters[changedList.first][index];
+        }
       }
 
       if (changedParameters.empty() || changedParameters.begin()->second.empty()) {
@@ -2148,8 +2376,12 @@ PVariable BidCoSPeer::putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t ch
         return PVariable(new Variable(VariableType::tVoid));
       }
 
+      std::string parameterSetId = "MASTER";
+      std::shared_ptr<BidCoSQueue> pendingQueue = mergePendingConfigQueue(parameterSetId, channel, changedParameters);
       std::shared_ptr<BidCoSQueue> queue(new BidCoSQueue(getPhysicalInterface(), BidCoSQueueType::CONFIG));
       queue->noSending = true;
+      queue->parameterName = parameterSetId;
+      queue->channel = channel;
       std::vector<uint8_t> payload;
       std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(getCentral());
 
@@ -2209,7 +2441,7 @@ PVariable BidCoSPeer::putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t ch
         setMessageCounter(_messageCounter + 1);
       }
 
-      pendingBidCoSQueues->push(queue);
+      if (!pendingQueue || !pendingBidCoSQueues->replace(pendingQueue, queue)) pendingBidCoSQueues->push(queue);
       if (aesActivated) checkAESKey(onlyPushing);
       serviceMessages->setConfigPending(true);
       //if((getRXModes() & HomegearDevice::ReceiveModes::Enum::always) || (getRXModes() & HomegearDevice::ReceiveModes::Enum::wakeOnRadio))
@@ -2241,6 +2473,7 @@ PVariable BidCoSPeer::putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t ch
       if (configIterator->second[_address].find(remotePeer->channel) == configIterator->second[_address].end()) Variable::createError(-3, "Unknown parameter set.");
 
       std::map<int32_t, std::map<int32_t, std::vector<uint8_t>>> changedParameters;
+      std::map<int32_t, std::set<int32_t>> changedIndices;
       //allParameters is necessary to temporarily store all values. It is used to set changedParameters.
       //This is necessary when there are multiple variables per index and not all of them are changed.
       std::map<int32_t, std::map<int32_t, std::vector<uint8_t>>> allParameters;
@@ -2274,6 +2507,7 @@ PVariable BidCoSPeer::putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t ch
         BaseLib::Systems::RpcConfigurationParameter &parameter = configIterator->second[remotePeer->address][remotePeer->channel][i->first];
         if (!parameter.rpcParameter) continue;
         parameter.rpcParameter->convertToPacket(i->second, parameter.mainRole(), value);
+        bool valueChanged = (value != parameter.getBinaryData());
         std::vector<uint8_t> shiftedValue = value;
         parameter.rpcParameter->adjustBitPosition(shiftedValue);
         int32_t intIndex = (int32_t)parameter.rpcParameter->physical->index;
@@ -2288,19 +2522,30 @@ PVariable BidCoSPeer::putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t ch
             index++;
           }
         }
-        parameter.setBinaryData(value);
-        if (parameter.databaseId > 0) saveParameter(parameter.databaseId, value);
-        else saveParameter(0, ParameterGroup::Type::Enum::link, channel, i->first, value, remotePeer->address, remotePeer->channel);
-        GD::out.printInfo("Info: Parameter " + i->first + " of peer " + std::to_string(_peerID) + " and channel " + std::to_string(channel) + " was set to 0x" + BaseLib::HelperFunctions::getHexString(allParameters[list][intIndex]) + ".");
+        if (valueChanged) {
+          parameter.setBinaryData(value);
+          if (parameter.databaseId > 0) saveParameter(parameter.databaseId, value);
+          else saveParameter(0, ParameterGroup::Type::Enum::link, channel, i->first, value, remotePeer->address, remotePeer->channel);
+          GD::out.printInfo("Info: Parameter " + i->first + " of peer " + std::to_string(_peerID) + " and channel " + std::to_string(channel) + " was set to 0x" + BaseLib::HelperFunctions::getHexString(allParameters[list][intIndex]) + ".");
+        }
         //Only send to device when parameter is of type config
         if (parameter.rpcParameter->physical->operationType != IPhysical::OperationType::Enum::config && parameter.rpcParameter->physical->operationType != IPhysical::OperationType::Enum::configString) continue;
-        changedParameters[list][intIndex] = allParameters[list][intIndex];
+        if (valueChanged) changedIndices[list].insert(intIndex);
+      }
+      for (auto &changedList : changedIndices) {
+        for (auto index : changedList.second) {
+          changedParameters[changedList.first][index] = allParameters[changedList.first][index];
+        }
       }
 
       if (changedParameters.empty() || changedParameters.begin()->second.empty()) return PVariable(new Variable(VariableType::tVoid));
 
+      std::string parameterSetId = "LINK." + BaseLib::HelperFunctions::getHexString(remotePeer->address, 6) + "." + std::to_string(remotePeer->channel);
+      std::shared_ptr<BidCoSQueue> pendingQueue = mergePendingConfigQueue(parameterSetId, channel, changedParameters);
       std::shared_ptr<BidCoSQueue> queue(new BidCoSQueue(getPhysicalInterface(), BidCoSQueueType::CONFIG));
       queue->noSending = true;
+      queue->parameterName = parameterSetId;
+      queue->channel = channel;
       std::vector<uint8_t> payload;
       std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(getCentral());
       bool firstPacket = true;
@@ -2362,7 +2607,7 @@ PVariable BidCoSPeer::putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t ch
         setMessageCounter(_messageCounter + 1);
       }
 
-      pendingBidCoSQueues->push(queue);
+      if (!pendingQueue || !pendingBidCoSQueues->replace(pendingQueue, queue)) pendingBidCoSQueues->push(queue);
       serviceMessages->setConfigPending(true);
       //if((getRXModes() & HomegearDevice::ReceiveModes::Enum::always) || (getRXModes() & HomegearDevice::ReceiveModes::Enum::wakeOnRadio))
       //{
@@ -2382,6 +2627,44 @@ PVariable BidCoSPeer::putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t ch
   return Variable::createError(-32500, "Unknown application error.");
 }
 
+std::shared_ptr<BidCoSQueue> BidCoSPeer::mergePendingConfigQueue(const std::string &parameterSetId, int32_t channel, std::map<int32_t, std::map<int32_t, std::vector<uint8_t>>> &changedParameters) {
+  std::shared_ptr<BidCoSQueue> pendingQueue;
+  try {
+    //One entry per register, so registers written by the pending queue can be overwritten individually
+    std::map<int32_t, std::map<int32_t, std::vector<uint8_t>>> registers;
+    pendingQueue = pendingBidCoSQueues->findUnstarted(BidCoSQueueType::CONFIG, parameterSetId, channel);
+    if (pendingQueue) {
+      int32_t list = -1;
+      for (auto &entry : *pendingQueue->getQueue()) {
+        if (entry.getType() != QueueEntryType::PACKET) continue;
+        std::shared_ptr<BidCoSPacket> packet = entry.getPacket();
+        if (!packet || packet->messageType() != 0x01 || packet->payload().size() < 2) continue;
+        BidCoSPayload &payload = packet->payload();
+        if (payload.at(1) == 0x05 && payload.size() >= 7) list = payload.at(6); //CONFIG_START
+        else if (payload.at(1) == 0x08 && list != -1) //CONFIG_WRITE_INDEX
+        {
+          for (uint32_t i = 2; i + 1 < payload.size(); i += 2) {
+            registers[list][payload.at(i)] = std::vector<uint8_t>{payload.at(i + 1)};
+          }
+        }
+      }
+      GD::out.printInfo("Info: Merging pending config queue of peer " + std::to_string(_peerID) + ", channel " + std::to_string(channel) + " and parameter set " + parameterSetId + " with new values.");
+    }
+    for (auto &changedList : changedParameters) {
+      for (auto &changedIndex : changedList.second) {
+        for (uint32_t i = 0; i < changedIndex.second.size(); i++) {
+          registers[changedList.first][changedIndex.first + i] = std::vector<uint8_t>{changedIndex.second.at(i)};
+        }
+      }
+    }
+    changedParameters.swap(registers);
+  }
+  catch (const std::exception &ex) {
+    GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+  return pendingQueue;
+}
+
 bool BidCoSPeer::setHomegearValue(uint32_t channel, std::string valueKey, PVariable value) {
   try {
     if (_deviceType == (uint32_t)DeviceType::HMCCVD && valueKey == "VALVE_STATE") {
@@ -2408,8 +2691,7 @@ bool BidCoSPeer::setHomegearValue(uint32_t channel, std::string valueKey, PVaria
         std::vector<uint8_t> parameterData;
         rpcParameter->convertToPacket(value, parameter.mainRole(), parameterData);
         parameter.setBinaryData(parameterData);
-        if (parameter.databaseId > 0) saveParameter(parameter.databaseId, parameterData);
-        else saveParameter(0, ParameterGroup::Type::Enum::variables, channel, valueKey, parameterData);
+        saveValue(channel, valueKey, parameter, parameterData);
         GD::out.printInfo("Info: Setting valve state of HM-CC-VD with id " + std::to_string(_peerID) + " to " + std::to_string(value->integerValue) + "%.");
         return true;
       }
@@ -2421,8 +2703,7 @@ bool BidCoSPeer::setHomegearValue(uint32_t channel, std::string valueKey, PVaria
         std::vector<uint8_t> parameterData;
         rpcParameter->convertToPacket(value, parameter.mainRole(), parameterData);
         parameter.setBinaryData(parameterData);
-        if (parameter.databaseId > 0) saveParameter(parameter.databaseId, parameterData);
-        else saveParameter(0, ParameterGroup::Type::Enum::variables, channel, valueKey, parameterData);
+        saveValue(channel, valueKey, parameter, parameterData);
 
         std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(getCentral());
         std::shared_ptr<BidCoSPeer> associatedPeer = central->getPeer(_address);
@@ -2449,8 +2730,7 @@ bool BidCoSPeer::setHomegearValue(uint32_t channel, std::string valueKey, PVaria
         std::vector<uint8_t> parameterData;
         rpcParameter->convertToPacket(value, parameter.mainRole(), parameterData);
         parameter.setBinaryData(parameterData);
-        if (parameter.databaseId > 0) saveParameter(parameter.databaseId, parameterData);
-        else saveParameter(0, ParameterGroup::Type::Enum::variables, channel, valueKey, parameterData);
+        saveValue(channel, valueKey, parameter, parameterData);
 
         std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(getCentral());
         std::shared_ptr<BidCoSPeer> associatedPeer = central->getPeer(_address);
@@ -2477,8 +2757,7 @@ bool BidCoSPeer::setHomegearValue(uint32_t channel, std::string valueKey, PVaria
         std::vector<uint8_t> parameterData;
         rpcParameter->convertToPacket(value, parameter.mainRole(), parameterData);
         parameter.setBinaryData(parameterData);
-        if (parameter.databaseId > 0) saveParameter(parameter.databaseId, parameterData);
-        else saveParameter(0, ParameterGroup::Type::Enum::variables, channel, valueKey, parameterData);
+        saveValue(channel, valueKey, parameter, parameterData);
 
         std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(getCentral());
         std::shared_ptr<BidCoSPeer> associatedPeer = central->getPeer(_address);
@@ -2511,8 +2790,7 @@ bool BidCoSPeer::setHomegearValue(uint32_t channel, std::string valueKey, PVaria
         std::vector<uint8_t> parameterData;
         rpcParameter->convertToPacket(value, parameter.mainRole(), parameterData);
         parameter.setBinaryData(parameterData);
-        if (parameter.databaseId > 0) saveParameter(parameter.databaseId, parameterData);
-        else saveParameter(0, ParameterGroup::Type::Enum::variables, channel, valueKey, parameterData);
+        saveValue(channel, valueKey, parameter, parameterData);
 
         std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(getCentral());
         std::shared_ptr<BidCoSPeer> associatedPeer = central->getPeer(_address);
@@ -2560,9 +2838,7 @@ void BidCoSPeer::addVariableToResetCallback(std::shared_ptr<CallbackFunctionPara
     _bl->hf.memcpyBigEndian(variable->data, integerValue);
     variable->resetTime = timeToReset;
     variable->key = parameters->strings.at(0);
-    _variablesToResetMutex.lock();
-    _variablesToReset[variable->channel][variable->key] = variable;
-    _variablesToResetMutex.unlock();
+    addVariableToReset(variable);
   }
   catch (const std::exception &ex) {
     GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
@@ -2607,8 +2883,7 @@ PVariable BidCoSPeer::setValue(BaseLib::PRpcClientInfo clientInfo, uint32_t chan
       std::vector<uint8_t> parameterData;
       rpcParameter->convertToPacket(value, parameter.mainRole(), parameterData);
       parameter.setBinaryData(parameterData);
-      if (parameter.databaseId > 0) saveParameter(parameter.databaseId, parameterData);
-      else saveParameter(0, ParameterGroup::Type::Enum::variables, channel, valueKey, parameterData);
+      saveValue(channel, valueKey, parameter, parameterData);
       value = rpcParameter->convertFromPacket(parameterData, parameter.mainRole(), false);
       valueKeys->push_back(valueKey);
       values->push_back(value);
@@ -2648,15 +2923,13 @@ PVariable BidCoSPeer::setValue(BaseLib::PRpcClientInfo clientInfo, uint32_t chan
     std::vector<uint8_t> parameterData;
     rpcParameter->convertToPacket(value, parameter.mainRole(), parameterData);
     parameter.setBinaryData(parameterData);
-    if (parameter.databaseId > 0) saveParameter(parameter.databaseId, parameterData);
-    else saveParameter(0, ParameterGroup::Type::Enum::variables, channel, valueKey, parameterData);
+    saveValue(channel, valueKey, parameter, parameterData);
     value = rpcParameter->convertFromPacket(parameterData, parameter.mainRole(), false);
     valueKeys->push_back(valueKey);
     values->push_back(value);
     if (_bl->debugLevel > 4)
       GD::out.printDebug("Debug: " + valueKey + " of peer " + std::to_string(_peerID) + " with serial number " + _serialNumber + ":" + std::to_string(channel) + " was set to " + BaseLib::HelperFunctions::getHexString(parameterData) + ".");
 
-    pendingBidCoSQueues->remove(BidCoSQueueType::PEER, valueKey, channel);
     std::shared_ptr<BidCoSQueue> queue(new BidCoSQueue(getPhysicalInterface(), BidCoSQueueType::PEER));
     queue->noSending = true;
     queue->parameterName = valueKey;
@@ -2761,17 +3034,7 @@ PVariable BidCoSPeer::setValue(BaseLib::PRpcClientInfo clientInfo, uint32_t chan
       }
     }
 
-    _variablesToResetMutex.lock();
-    std::map<std::int32_t, std::map<std::string, std::shared_ptr<VariableToReset>>>::iterator resetIterator1 = _variablesToReset.find(channel);
-    if (resetIterator1 != _variablesToReset.end()) {
-      std::map<std::string, std::shared_ptr<VariableToReset>>::iterator resetIterator2 = resetIterator1->second.find(valueKey);
-      if (resetIterator2 != resetIterator1->second.end()) {
-        if (GD::bl->debugLevel >= 5) GD::bl->out.printDebug("Debug: Deleting element from _variablesToReset. Peer: " + std::to_string(_peerID) + " Serial number: " + _serialNumber + " Frame: " + frame->id, 5);
-        resetIterator1->second.erase(resetIterator2);
-        if (resetIterator1->second.empty()) _variablesToReset.erase(resetIterator1);
-      }
-    }
-    _variablesToResetMutex.unlock();
+    if (_variablesToResetCount > 0) cancelVariableToReset(channel, BidCoSParameterSymbols::get(valueKey));
 
     if (!rpcParameter->setPackets.front()->autoReset.empty()) {
       for (std::vector<std::string>::iterator j = rpcParameter->setPackets.front()->autoReset.begin(); j != rpcParameter->setPackets.front()->autoReset.end(); ++j) {
@@ -2782,8 +3045,7 @@ PVariable BidCoSPeer::setValue(BaseLib::PRpcClientInfo clientInfo, uint32_t chan
         tempParam.rpcParameter->convertToPacket(logicalDefaultValue, tempParam.mainRole(), defaultValue);
         if (!tempParam.equals(defaultValue)) {
           tempParam.setBinaryData(defaultValue);
-          if (tempParam.databaseId > 0) saveParameter(tempParam.databaseId, defaultValue);
-          else saveParameter(0, ParameterGroup::Type::Enum::variables, channel, *j, defaultValue);
+          saveValue(channel, *j, tempParam, defaultValue);
           GD::out.printInfo("Info: Parameter \"" + *j + "\" was reset to " + BaseLib::HelperFunctions::getHexString(defaultValue) + ". Peer: " + std::to_string(_peerID) + " Serial number: " + _serialNumber + " Frame: " + frame->id);
           if (rpcParameter->readable) {
             valueKeys->push_back(*j);
@@ -2795,7 +3057,7 @@ PVariable BidCoSPeer::setValue(BaseLib::PRpcClientInfo clientInfo, uint32_t chan
     setMessageCounter(_messageCounter + 1);
     queue->push(packet);
     queue->push(central->getMessages()->find(0x02));
-    pendingBidCoSQueues->push(queue);
+    pendingBidCoSQueues->push(queue); //Replaces an unsent queue setting the same parameter
     if ((getRXModes() & HomegearDevice::ReceiveModes::Enum::always) || (getRXModes() & HomegearDevice::ReceiveModes::Enum::wakeOnRadio)) {
       bool result = false;
       central->enqueuePendingQueues(_address, wait, &result);
@@ -2831,7 +3093,6 @@ PVariable BidCoSPeer::setValue(BaseLib::PRpcClientInfo clientInfo, uint32_t chan
   }
   catch (const std::exception &ex) {
     GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-    _variablesToResetMutex.unlock();
   }
   return Variable::createError(-32500, "Unknown application error. See error log for more details.");
 }
@@ -35,6 +35,7 @@
 #include <homegear-base/BaseLib.h>
 #include "BidCoSDeviceTypes.h"
 #include "BidCoSPacket.h"
+#include "BidCoSFrameDecoder.h"
 #include "PhysicalInterfaces/IBidCoSInterface.h"
 #include "GD.h"
 
@@ -46,8 +47,10 @@
 #include <memory>
 #include <queue>
 #include <mutex>
+#include <atomic>
 #include <list>
 #include <tuple>
+#include <algorithm>
 
 using namespace BaseLib;
 using namespace BaseLib::DeviceDescription;
@@ -59,6 +62,8 @@ class CallbackFunctionParameter;
 class HomeMaticCentral;
 class BidCoSQueue;
 class BidCoSMessages;
+class BidCoSPeerScheduler;
+class BidCoSParameterWriter;
 
 class VariableToReset
 {
@@ -69,6 +74,16 @@ public:
 	int64_t resetTime = 0;
 	bool isDominoEvent = false;
 
+	/**
+	 * The ID of "key" assigned by BidCoSParameterSymbols. Not serialized.
+	 */
+	uint32_t symbol = 0;
+
+	/**
+	 * Identifies the reset token in the scheduler of the central. Not serialized.
+	 */
+	uint64_t generation = 0;
+
 	VariableToReset() {}
 	virtual ~VariableToReset() {}
 };
@@ -76,17 +91,30 @@ public:
 class FrameValue
 {
 public:
-	std::set<uint32_t> channels;
+	bool isSet = false;
+	PParameter parameter;
+	uint32_t symbol = 0; //The ID of the parameter name assigned by BidCoSParameterSymbols
+	std::vector<uint32_t> channels;
 	std::vector<uint8_t> value;
+
+	void addChannel(uint32_t channel) { if(std::find(channels.begin(), channels.end(), channel) == channels.end()) channels.push_back(channel); }
 };
 
+/**
+ * The values of one decoded frame. Objects of this class are reused for many packets, so the vectors keep their memory.
+ */
 class FrameValues
 {
 public:
-	std::string frameID;
-	std::list<uint32_t> paramsetChannels;
+	PPacket frame;
+	std::vector<uint32_t> paramsetChannels;
 	ParameterGroup::Type::Enum parameterSetType;
-	std::map<std::string, FrameValue> values;
+
+	/**
+	 * Indexed by the value slots of the frame's decode program. Only elements with "isSet" contain values.
+	 */
+	std::vector<FrameValue> values;
+	uint32_t valueCount = 0;
 };
 
 class BidCoSPeer : public BaseLib::Systems::Peer
@@ -108,7 +136,7 @@ class BidCoSPeer : public BaseLib::Systems::Peer
 		int32_t getCountFromSysinfo() { return _countFromSysinfo; }
 		void setCountFromSysinfo(int32_t value) { _countFromSysinfo = value; saveVariable(4, value); }
 		int32_t getMessageCounter() { return _messageCounter; }
-		void setMessageCounter(int32_t value) { _messageCounter = value; saveVariable(5, value); }
+		void setMessageCounter(int32_t value) { _messageCounter = value; saveVariableLater(5); }
 		int32_t getPairingComplete() { return _pairingComplete; }
 		void setPairingComplete(int32_t value) { _pairingComplete = value; saveVariable(6, value); }
 		int32_t getTeamChannel() { return _teamChannel; }
@@ -129,7 +157,7 @@ class BidCoSPeer : public BaseLib::Systems::Peer
 		bool getValuePending() { return _valuePending; }
 		void setValuePending(bool value);
 		int32_t getGeneralCounter() { return _generalCounter; }
-		void setGeneralCounter(int32_t value) { _generalCounter = value; saveVariable(22, value); }
+		void setGeneralCounter(int32_t value) { _generalCounter = value; saveVariableLater(22); }
 		//End
 
 		virtual bool isVirtual() { return false; }
@@ -140,6 +168,22 @@ class BidCoSPeer : public BaseLib::Systems::Peer
         bool peerInfoPacketsEnabled = true;
 
         virtual void worker();
+
+        /**
+         * Returns the time in milliseconds since epoch "worker()" needs to be called next: The earliest reset time, the unreach timeout, the next
+         * poll or the next config pending check.
+         */
+        int64_t getNextWorkerTime();
+
+        /**
+         * Resets a variable when its reset token fired. Does nothing when the variable was removed or replaced in the meantime.
+         */
+        void resetVariable(uint32_t channel, uint32_t symbol, uint64_t generation);
+
+        /**
+         * Schedules reset tokens for all variables to reset. Called after the peer was loaded.
+         */
+        void scheduleVariablesToReset(BidCoSPeerScheduler *scheduler);
         virtual std::string handleCliCommand(std::string command);
         void initializeLinkConfig(int32_t channel, int32_t address, int32_t remoteChannel, bool useConfigFunction);
         void applyConfigFunction(int32_t channel, int32_t address, int32_t remoteChannel);
@@ -155,6 +199,20 @@ class BidCoSPeer : public BaseLib::Systems::Peer
         void saveNonCentralConfig();
         void saveVariablesToReset();
         void savePendingQueues();
+
+        /**
+         * Writes the variables recorded by "saveVariableLater()". Called by the variable journal.
+         *
+         * @param variables One bit per variable index.
+         */
+        void saveJournaledVariables(uint32_t variables);
+
+        /**
+         * Writes values buffered by the parameter writer of the central.
+         *
+         * @param parameters Pairs of database ID and value.
+         */
+        void saveBufferedParameters(std::vector<std::pair<uint64_t, std::vector<uint8_t>>> &parameters);
         bool aesEnabled();
         bool aesEnabled(int32_t channel);
         void checkAESKey(bool onlyPushing = false);
@@ -170,8 +228,20 @@ class BidCoSPeer : public BaseLib::Systems::Peer
         virtual bool pendingQueuesEmpty();
         virtual void enqueuePendingQueues();
 
-        void handleDominoEvent(PParameter parameter, std::string& frameID, uint32_t channel);
+        void handleDominoEvent(PParameter parameter, uint32_t symbol, std::string& frameID, uint32_t channel);
         bool hasLowbatBit(PPacket frame);
+
+        /**
+         * Returns the element of "valuesCentral" for a parameter. Equivalent to "valuesCentral[channel][name]", but the element is looked up by
+         * the parameter's symbol after the first call.
+         */
+        BaseLib::Systems::RpcConfigurationParameter& getValueSlot(uint32_t channel, uint32_t symbol, const std::string& name);
+
+        /**
+         * Discards all pointers cached by "getValueSlot". Needs to be called whenever elements of "valuesCentral" are erased or replaced.
+         */
+        void invalidateValueSlots();
+        virtual void initializeCentralConfig();
         void packetReceived(std::shared_ptr<BidCoSPacket> packet);
         bool setHomegearValue(uint32_t channel, std::string valueKey, PVariable value);
         virtual int32_t getChannelGroupedWith(int32_t channel);
@@ -244,8 +314,93 @@ class BidCoSPeer : public BaseLib::Systems::Peer
         uint32_t _lastRSSIDevice = 0;
         int64_t _lastPressLong = 0;
         std::mutex _variablesToResetMutex;
-        std::map<std::int32_t, std::map<std::string, std::shared_ptr<VariableToReset>>> _variablesToReset;
+        std::map<std::int32_t, std::map<uint32_t, std::shared_ptr<VariableToReset>>> _variablesToReset; //Second key is the symbol of the parameter
+        std::atomic<uint32_t> _variablesToResetCount{0}; //Number of elements in "_variablesToReset". Lets the receive path skip the mutex.
+        uint64_t _variablesToResetGeneration = 0;
         std::shared_ptr<IBidCoSInterface> _physicalInterface;
+        std::shared_ptr<BidCoSFrameDecoder> _frameDecoder; //Access with std::atomic_load and std::atomic_store
+
+        /**
+         * Pointers to the elements of "valuesCentral" of one channel, indexed by the IDs assigned by BidCoSParameterSymbols. The pointers are only
+         * valid while "generation" equals "_valuesCentralGeneration".
+         */
+        struct ValueSlots
+        {
+            uint64_t generation = 0;
+            std::vector<BaseLib::Systems::RpcConfigurationParameter*> slots;
+        };
+        std::mutex _valueSlotsMutex;
+        uint64_t _valuesCentralGeneration = 1; //Guarded by "_valueSlotsMutex". Slots of an older generation are discarded on lookup.
+        std::vector<ValueSlots> _valueSlots; //Indexed by channel
+
+        /**
+         * Records a change of a frequently changing variable in the variable journal instead of writing it to the database immediately.
+         */
+        void saveVariableLater(uint32_t index);
+
+        /**
+         * Creates "pendingBidCoSQueues" and calls "pendingQueuesChanged()" on each change of it.
+         */
+        void createPendingQueues();
+
+        /**
+         * Journals the pending queues and schedules the next config pending check.
+         */
+        void pendingQueuesChanged(bool empty);
+
+        /**
+         * Moves the deadline of the peer forward, so "worker()" resets config pending and value pending soon after the pending queues are empty.
+         * Without this, the next deadline can be up to "_maxWorkerInterval" away.
+         */
+        void schedulePendingCheck(bool queuesEmpty);
+
+        /**
+         * Maximum time in milliseconds between two calls of "worker()".
+         */
+        static constexpr int64_t _maxWorkerInterval = 300000;
+
+        /**
+         * Interval in milliseconds in which "worker()" checks if config pending or value pending can be reset.
+         */
+        static constexpr int64_t _pendingCheckInterval = 10000;
+
+        /**
+         * Returns the polling interval in milliseconds or 0 when polling is disabled.
+         */
+        int64_t getPollingInterval();
+
+        /**
+         * Adds a variable to "_variablesToReset" and schedules its reset token.
+         */
+        void addVariableToReset(std::shared_ptr<VariableToReset> variable);
+
+        void scheduleVariableToReset(BidCoSPeerScheduler *scheduler, const VariableToReset &variable);
+
+        /**
+         * Removes a variable from "_variablesToReset". Its reset token is ignored when it fires. "data" is compared to the data of the reset when not null.
+         * Returns without locking "_variablesToResetMutex" when no variable is waiting for a reset.
+         */
+        void cancelVariableToReset(uint32_t channel, uint32_t symbol, const std::vector<uint8_t> *data = nullptr);
+
+        /**
+         * Saves a value of "valuesCentral". Existing values are handed to the parameter writer of the central, which combines repeated writes and
+         * writes them in the background.
+         */
+        void saveValue(uint32_t channel, const std::string &name, BaseLib::Systems::RpcConfigurationParameter &parameter, std::vector<uint8_t> &value);
+
+        /**
+         * Same as above, but uses the given parameter writer of the central, so callers saving many values only look it up once. "writer" may be
+         * nullptr, in which case the value is written directly.
+         */
+        void saveValue(BidCoSParameterWriter *writer, uint32_t channel, const std::string &name, BaseLib::Systems::RpcConfigurationParameter &parameter, std::vector<uint8_t> &value);
+
+        /**
+         * Splits "changedParameters" into single registers and adds the registers written by a pending config queue for the same parameter set
+         * which wasn't sent yet. Values in "changedParameters" take precedence.
+         *
+         * @return The pending config queue to replace or nullptr.
+         */
+        std::shared_ptr<BidCoSQueue> mergePendingConfigQueue(const std::string& parameterSetId, int32_t channel, std::map<int32_t, std::map<int32_t, std::vector<uint8_t>>>& changedParameters);
 
         //In table variables:
 		int32_t _remoteChannel = 0;
@@ -343,7 +498,12 @@ class BidCoSPeer : public BaseLib::Systems::Peer
 		 */
 		virtual void setDefaultValue(BaseLib::Systems::RpcConfigurationParameter& parameter);
 
-		void getValuesFromPacket(std::shared_ptr<BidCoSPacket> packet, std::vector<FrameValues>& frameValue);
+		/**
+		 * Decodes the values of all frames matching the packet into "frameValues". Existing elements of "frameValues" are reused.
+		 *
+		 * @return Returns the number of decoded frames. Only the elements up to this index are valid.
+		 */
+		uint32_t getValuesFromPacket(std::shared_ptr<BidCoSPacket> packet, std::vector<FrameValues>& frameValues);
 
 		/**
 		 * Returns if the peer needs to be woken up on next reception of a wake me up packet.
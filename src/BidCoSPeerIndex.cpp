@@ -0,0 +1,148 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "BidCoSPeerIndex.h"
+#include "BidCoSPeer.h"
+
+namespace BidCoS
+{
+BidCoSPeerIndex::BidCoSPeerIndex()
+{
+	_addresses.resize(64);
+	_addressShift = 32 - 6;
+}
+
+uint32_t BidCoSPeerIndex::findSlot(int32_t address) const
+{
+	uint32_t mask = _addresses.size() - 1;
+	uint32_t slot = homeSlot(address);
+	while(_addresses[slot].address != -1 && _addresses[slot].address != address) slot = (slot + 1) & mask;
+	return slot;
+}
+
+void BidCoSPeerIndex::growAddresses()
+{
+	std::vector<AddressSlot> addresses(_addresses.size() * 2);
+	addresses.swap(_addresses);
+	_addressShift--;
+	for(auto& element : addresses)
+	{
+		if(element.address == -1) continue;
+		_addresses[findSlot(element.address)] = std::move(element);
+	}
+}
+
+void BidCoSPeerIndex::addByAddress(int32_t address, const std::shared_ptr<BidCoSPeer>& peer)
+{
+	if(address < 0 || !peer) return;
+	std::lock_guard<std::shared_mutex> indexGuard(_mutex);
+	if((_addressCount + 1) * 2 > _addresses.size()) growAddresses();
+	AddressSlot& slot = _addresses[findSlot(address)];
+	if(slot.address == -1) _addressCount++;
+	slot.address = address;
+	slot.peer = peer;
+}
+
+void BidCoSPeerIndex::addById(uint64_t id, const std::shared_ptr<BidCoSPeer>& peer)
+{
+	if(!peer) return;
+	std::lock_guard<std::shared_mutex> indexGuard(_mutex);
+	_peersById[id] = peer;
+}
+
+void BidCoSPeerIndex::addBySerial(const std::string& serialNumber, const std::shared_ptr<BidCoSPeer>& peer)
+{
+	if(serialNumber.empty() || !peer) return;
+	std::lock_guard<std::shared_mutex> indexGuard(_mutex);
+	_peersBySerial[serialNumber] = peer;
+}
+
+void BidCoSPeerIndex::removeByAddress(int32_t address)
+{
+	if(address < 0) return;
+	std::lock_guard<std::shared_mutex> indexGuard(_mutex);
+	uint32_t mask = _addresses.size() - 1;
+	uint32_t slot = findSlot(address);
+	if(_addresses[slot].address == -1) return;
+	_addressCount--;
+
+	//Move following entries back into the gap, so no probe sequence is interrupted.
+	uint32_t next = slot;
+	while(true)
+	{
+		next = (next + 1) & mask;
+		if(_addresses[next].address == -1) break;
+		uint32_t home = homeSlot(_addresses[next].address);
+		bool canMove = (next > slot) ? (home <= slot || home > next) : (home <= slot && home > next);
+		if(!canMove) continue;
+		_addresses[slot] = std::move(_addresses[next]);
+		slot = next;
+	}
+	_addresses[slot].address = -1;
+	_addresses[slot].peer.reset();
+}
+
+void BidCoSPeerIndex::removeById(uint64_t id)
+{
+	std::lock_guard<std::shared_mutex> indexGuard(_mutex);
+	_peersById.erase(id);
+}
+
+void BidCoSPeerIndex::removeBySerial(const std::string& serialNumber)
+{
+	std::lock_guard<std::shared_mutex> indexGuard(_mutex);
+	_peersBySerial.erase(serialNumber);
+}
+
+std::shared_ptr<BidCoSPeer> BidCoSPeerIndex::getByAddress(int32_t address)
+{
+	if(address < 0) return std::shared_ptr<BidCoSPeer>();
+	std::shared_lock<std::shared_mutex> indexGuard(_mutex);
+	const AddressSlot& slot = _addresses[findSlot(address)];
+	if(slot.address == -1) return std::shared_ptr<BidCoSPeer>();
+	return slot.peer;
+}
+
+std::shared_ptr<BidCoSPeer> BidCoSPeerIndex::getById(uint64_t id)
+{
+	std::shared_lock<std::shared_mutex> indexGuard(_mutex);
+	auto peerIterator = _peersById.find(id);
+	if(peerIterator == _peersById.end()) return std::shared_ptr<BidCoSPeer>();
+	return peerIterator->second;
+}
+
+std::shared_ptr<BidCoSPeer> BidCoSPeerIndex::getBySerial(const std::string& serialNumber)
+{
+	std::shared_lock<std::shared_mutex> indexGuard(_mutex);
+	auto peerIterator = _peersBySerial.find(serialNumber);
+	if(peerIterator == _peersBySerial.end()) return std::shared_ptr<BidCoSPeer>();
+	return peerIterator->second;
+}
+
+}
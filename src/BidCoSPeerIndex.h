@@ -0,0 +1,99 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef BIDCOSPEERINDEX_H_
+#define BIDCOSPEERINDEX_H_
+
+#include <cstdint>
+
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BidCoS
+{
+class BidCoSPeer;
+
+/**
+ * Read-mostly index of the peers of a central. It mirrors "_peers", "_peersById" and "_peersBySerial" of the central but stores "BidCoSPeer"
+ * pointers, so lookups need neither "dynamic_pointer_cast" nor "_peersMutex". Lookups only take a shared lock. Addresses are stored in a flat
+ * open addressing table.
+ */
+class BidCoSPeerIndex
+{
+public:
+	BidCoSPeerIndex();
+	virtual ~BidCoSPeerIndex() = default;
+
+	void addByAddress(int32_t address, const std::shared_ptr<BidCoSPeer>& peer);
+	void addById(uint64_t id, const std::shared_ptr<BidCoSPeer>& peer);
+	void addBySerial(const std::string& serialNumber, const std::shared_ptr<BidCoSPeer>& peer);
+	void removeByAddress(int32_t address);
+	void removeById(uint64_t id);
+	void removeBySerial(const std::string& serialNumber);
+
+	std::shared_ptr<BidCoSPeer> getByAddress(int32_t address);
+	std::shared_ptr<BidCoSPeer> getById(uint64_t id);
+	std::shared_ptr<BidCoSPeer> getBySerial(const std::string& serialNumber);
+private:
+	struct AddressSlot
+	{
+		/**
+		 * -1 marks an empty slot. BidCoS addresses are 24 bit, so no valid address is negative.
+		 */
+		int32_t address = -1;
+		std::shared_ptr<BidCoSPeer> peer;
+	};
+
+	std::shared_mutex _mutex;
+
+	/**
+	 * Linear probing table. The size is always a power of two and at least twice the number of addresses.
+	 */
+	std::vector<AddressSlot> _addresses;
+	uint32_t _addressCount = 0;
+	uint32_t _addressShift = 0;
+
+	std::unordered_map<uint64_t, std::shared_ptr<BidCoSPeer>> _peersById;
+	std::unordered_map<std::string, std::shared_ptr<BidCoSPeer>> _peersBySerial;
+
+	uint32_t homeSlot(int32_t address) const { return ((uint32_t)address * 2654435769u) >> _addressShift; }
+
+	/**
+	 * Returns the slot of "address" or the empty slot where it would be inserted.
+	 */
+	uint32_t findSlot(int32_t address) const;
+
+	void growAddresses();
+};
+
+}
+#endif
@@ -0,0 +1,208 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "BidCoSPeerScheduler.h"
+#include "GD.h"
+
+namespace BidCoS
+{
+BidCoSPeerScheduler::BidCoSPeerScheduler(std::function<int64_t(uint64_t)> callback, std::function<void(const ResetToken&)> resetCallback)
+{
+	try
+	{
+		_callback = callback;
+		_resetCallback = resetCallback;
+		GD::bl->threadManager.start(_workerThread, true, &BidCoSPeerScheduler::worker, this);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+BidCoSPeerScheduler::~BidCoSPeerScheduler()
+{
+	dispose();
+}
+
+void BidCoSPeerScheduler::dispose()
+{
+	try
+	{
+		{
+			std::lock_guard<std::mutex> deadlinesGuard(_deadlinesMutex);
+			if(_disposing) return;
+			_disposing = true;
+			_deadlinesConditionVariable.notify_all();
+		}
+		GD::bl->threadManager.join(_workerThread);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSPeerScheduler::schedule(uint64_t peerId, int64_t time)
+{
+	try
+	{
+		std::lock_guard<std::mutex> deadlinesGuard(_deadlinesMutex);
+		if(_disposing) return;
+		auto deadlineIterator = _peerDeadlines.find(peerId);
+		if(deadlineIterator != _peerDeadlines.end() && deadlineIterator->second <= time) return;
+		_peerDeadlines[peerId] = time;
+		Deadline deadline;
+		deadline.time = time;
+		deadline.peerId = peerId;
+		bool earliest = (_deadlines.empty() || time < _deadlines.top().time) && (_resets.empty() || time < _resets.top().time);
+		_deadlines.push(deadline);
+		if(earliest) _deadlinesConditionVariable.notify_one();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSPeerScheduler::remove(uint64_t peerId)
+{
+	try
+	{
+		std::lock_guard<std::mutex> deadlinesGuard(_deadlinesMutex);
+		_peerDeadlines.erase(peerId);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSPeerScheduler::scheduleReset(const ResetToken& token)
+{
+	try
+	{
+		std::lock_guard<std::mutex> deadlinesGuard(_deadlinesMutex);
+		if(_disposing) return;
+		bool earliest = (_resets.empty() || token.time < _resets.top().time) && (_deadlines.empty() || token.time < _deadlines.top().time);
+		_resets.push(token);
+		if(earliest) _deadlinesConditionVariable.notify_one();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSPeerScheduler::recordDelay(int64_t delay)
+{
+	_totalDelay += delay;
+	if(delay > _maxDelay) _maxDelay = delay;
+	if(delay > _missThreshold) _missedDeadlines++;
+}
+
+BidCoSPeerScheduler::Statistics BidCoSPeerScheduler::getStatistics()
+{
+	Statistics statistics;
+	std::lock_guard<std::mutex> deadlinesGuard(_deadlinesMutex);
+	statistics.scheduledPeers = _peerDeadlines.size();
+	statistics.pendingResets = _resets.size();
+	statistics.firedResets = _firedResets;
+	statistics.firedDeadlines = _firedDeadlines;
+	statistics.missedDeadlines = _missedDeadlines;
+	statistics.averageDelay = (_firedDeadlines + _firedResets) > 0 ? _totalDelay / (int64_t)(_firedDeadlines + _firedResets) : 0;
+	statistics.maxDelay = _maxDelay;
+	return statistics;
+}
+
+void BidCoSPeerScheduler::worker()
+{
+	while(GD::bl->booting && !_disposing)
+	{
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+	}
+
+	while(!_disposing)
+	{
+		try
+		{
+			Deadline deadline;
+			ResetToken resetToken;
+			bool isReset = false;
+			{
+				std::unique_lock<std::mutex> deadlinesGuard(_deadlinesMutex);
+				if(_deadlines.empty() && _resets.empty())
+				{
+					_deadlinesConditionVariable.wait(deadlinesGuard, [&] { return _disposing || !_deadlines.empty() || !_resets.empty(); });
+					continue;
+				}
+				isReset = !_resets.empty() && (_deadlines.empty() || _resets.top().time <= _deadlines.top().time);
+				int64_t nextTime = isReset ? _resets.top().time : _deadlines.top().time;
+				int64_t now = BaseLib::HelperFunctions::getTime();
+				if(nextTime > now)
+				{
+					_deadlinesConditionVariable.wait_for(deadlinesGuard, std::chrono::milliseconds(nextTime - now));
+					continue;
+				}
+
+				if(isReset)
+				{
+					resetToken = _resets.top();
+					_resets.pop();
+					_firedResets++;
+					recordDelay(now - resetToken.time);
+				}
+				else
+				{
+					deadline = _deadlines.top();
+					_deadlines.pop();
+					auto deadlineIterator = _peerDeadlines.find(deadline.peerId);
+					if(deadlineIterator == _peerDeadlines.end() || deadlineIterator->second != deadline.time) continue; //Replaced or removed
+					_peerDeadlines.erase(deadlineIterator);
+					_firedDeadlines++;
+					recordDelay(now - deadline.time);
+				}
+			}
+
+			if(isReset)
+			{
+				_resetCallback(resetToken);
+				continue;
+			}
+			int64_t nextTime = _callback(deadline.peerId);
+			if(nextTime > 0) schedule(deadline.peerId, nextTime);
+		}
+		catch(const std::exception& ex)
+		{
+			GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+		}
+	}
+}
+
+}
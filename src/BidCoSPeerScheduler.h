@@ -0,0 +1,168 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef BIDCOSPEERSCHEDULER_H_
+#define BIDCOSPEERSCHEDULER_H_
+
+#include <cstdint>
+
+#include <homegear-base/BaseLib.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace BidCoS
+{
+
+/**
+ * Calls the housekeeping of a peer ("BidCoSPeer::worker()") when the next deadline of the peer is due. Each peer has at most one deadline: The
+ * earliest of its reset times, unreach timeout, next poll and config pending check. Scheduling an earlier time replaces the deadline, scheduling
+ * a later one is ignored.
+ *
+ * Resets of variables (e. g. domino events) are scheduled as separate reset tokens, so they fire on time without the peer scanning its variables.
+ * A token is only valid while the peer still has a variable to reset with the same generation, so cancelling a reset doesn't need to touch the
+ * heap.
+ */
+class BidCoSPeerScheduler
+{
+public:
+	struct ResetToken
+	{
+		int64_t time = 0;
+		uint64_t peerId = 0;
+		uint32_t channel = 0;
+		uint32_t symbol = 0; //The ID of the parameter name assigned by BidCoSParameterSymbols
+		uint64_t generation = 0;
+
+		bool operator>(const ResetToken& other) const { return time > other.time; }
+	};
+
+	struct Statistics
+	{
+		uint32_t scheduledPeers = 0;
+		uint32_t pendingResets = 0;
+		uint64_t firedResets = 0;
+		uint64_t firedDeadlines = 0;
+		uint64_t missedDeadlines = 0;
+		int64_t averageDelay = 0;
+		int64_t maxDelay = 0;
+	};
+
+	/**
+	 * @param callback Called with the peer ID when the deadline of a peer is due. Returns the next deadline of the peer or 0 to unschedule it.
+	 * @param resetCallback Called when a reset token is due.
+	 */
+	BidCoSPeerScheduler(std::function<int64_t(uint64_t)> callback, std::function<void(const ResetToken&)> resetCallback);
+	virtual ~BidCoSPeerScheduler();
+
+	/**
+	 * Stops the scheduler thread. Waits until a running callback returned.
+	 */
+	void dispose();
+
+	/**
+	 * Sets the deadline of a peer, unless the peer already has an earlier one.
+	 *
+	 * @param peerId The ID of the peer.
+	 * @param time The deadline in milliseconds since epoch.
+	 */
+	void schedule(uint64_t peerId, int64_t time);
+
+	/**
+	 * Removes the deadline of a peer.
+	 */
+	void remove(uint64_t peerId);
+
+	/**
+	 * Schedules a reset token. Tokens can't be removed. The reset callback needs to ignore outdated tokens.
+	 */
+	void scheduleReset(const ResetToken& token);
+
+	/**
+	 * Returns the current counters. Delays are the times in milliseconds between a deadline or reset time and the call of the callback. Deadlines are missed
+	 * when the delay is longer than "_missThreshold".
+	 */
+	Statistics getStatistics();
+private:
+	struct Deadline
+	{
+		int64_t time = 0;
+		uint64_t peerId = 0;
+
+		bool operator>(const Deadline& other) const { return time > other.time; }
+	};
+
+	static constexpr int64_t _missThreshold = 100;
+
+	std::function<int64_t(uint64_t)> _callback;
+	std::function<void(const ResetToken&)> _resetCallback;
+	std::atomic_bool _disposing{false};
+	std::thread _workerThread;
+	std::mutex _deadlinesMutex;
+	std::condition_variable _deadlinesConditionVariable;
+
+	/**
+	 * All deadlines, earliest first. Replaced deadlines stay in the heap and are skipped when they are due.
+	 */
+	std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> _deadlines;
+
+	/**
+	 * The current deadline of each scheduled peer.
+	 */
+	std::unordered_map<uint64_t, int64_t> _peerDeadlines;
+
+	/**
+	 * All reset tokens, earliest first.
+	 */
+	std::priority_queue<ResetToken, std::vector<ResetToken>, std::greater<ResetToken>> _resets;
+
+	uint64_t _firedResets = 0;
+
+	uint64_t _firedDeadlines = 0;
+	uint64_t _missedDeadlines = 0;
+	int64_t _totalDelay = 0;
+	int64_t _maxDelay = 0;
+
+	/**
+	 * Updates the delay counters. "_deadlinesMutex" must be locked.
+	 */
+	void recordDelay(int64_t delay);
+
+	void worker();
+};
+
+}
+#endif
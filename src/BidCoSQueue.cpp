@@ -42,10 +42,12 @@ BidCoSQueue::BidCoSQueue()
 {
 	_queueType = BidCoSQueueType::EMPTY;
 	_lastPop = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-	_physicalInterface = GD::interfaces->getDefaultInterface();
+	if(GD::interfaces) _physicalInterface = GD::interfaces->getDefaultInterface(); //Not set in tests
 	_disposing = false;
 	_workingOnPendingQueue = false;
 	noSending = false;
+	started = false;
+	_sendExecutor = GD::sendExecutor;
 }
 
 BidCoSQueue::BidCoSQueue(std::shared_ptr<IBidCoSInterface> physicalInterface) : BidCoSQueue()
@@ -92,9 +94,10 @@ void BidCoSQueue::serialize(std::vector<uint8_t>& encodedData)
 			else
 			{
 				encoder.encodeBoolean(encodedData, true);
-				std::vector<uint8_t> packet = i->getPacket()->byteArray();
-				encoder.encodeByte(encodedData, packet.size());
-				encodedData.insert(encodedData.end(), packet.begin(), packet.end());
+				BidCoSPacket::FrameBuffer packet;
+				uint32_t packetSize = i->getPacket()->byteArray(packet.data(), packet.size());
+				encoder.encodeByte(encodedData, packetSize);
+				encodedData.insert(encodedData.end(), packet.begin(), packet.begin() + packetSize);
 			}
 			std::shared_ptr<BidCoSMessage> message = i->getMessage();
 			if(!message) encoder.encodeBoolean(encodedData, false);
@@ -137,11 +140,11 @@ void BidCoSQueue::unserialize(std::shared_ptr<std::vector<char>> serializedData,
 			int32_t packetExists = decoder.decodeBoolean(*serializedData, position);
 			if(packetExists)
 			{
-				std::vector<uint8_t> packetData;
 				uint32_t dataSize = decoder.decodeByte(*serializedData, position);
-				if(position + dataSize <= serializedData->size()) packetData.insert(packetData.end(), serializedData->begin() + position, serializedData->begin() + position + dataSize);
+				std::shared_ptr<BidCoSPacket> packet;
+				if(position + dataSize <= serializedData->size()) packet.reset(new BidCoSPacket((uint8_t*)serializedData->data() + position, dataSize, false));
+				else packet.reset(new BidCoSPacket());
 				position += dataSize;
-				std::shared_ptr<BidCoSPacket> packet(new BidCoSPacket(packetData, false));
 				entry.setPacket(packet, false);
 			}
 			int32_t messageExists = decoder.decodeBoolean(*serializedData, position);
@@ -179,17 +182,16 @@ void BidCoSQueue::dispose()
 {
 	try
 	{
-		if(_disposing) return;
-		_disposing = true;
+		{
+			//Tasks are posted while holding "_postMutex", so no task can be posted after the strand is removed below.
+			std::lock_guard<std::mutex> postGuard(_postMutex);
+			if(_disposing) return;
+			_disposing = true;
+		}
 		_startResendThreadMutex.lock();
 		GD::bl->threadManager.join(_startResendThread);
 		_startResendThreadMutex.unlock();
-		_pushPendingQueueThreadMutex.lock();
-		GD::bl->threadManager.join(_pushPendingQueueThread);
-		_pushPendingQueueThreadMutex.unlock();
-		_sendThreadMutex.lock();
-		GD::bl->threadManager.join(_sendThread);
-        _sendThreadMutex.unlock();
+		if(_sendExecutor) _sendExecutor->remove((uint64_t)(uintptr_t)this);
 		_queueMutex.lock();
 		_queue.clear();
 		_pendingQueues.reset();
@@ -197,8 +199,6 @@ void BidCoSQueue::dispose()
 	catch(const std::exception& ex)
     {
     	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-    	_sendThreadMutex.unlock();
-    	_pushPendingQueueThreadMutex.unlock();
     	_startResendThreadMutex.unlock();
     }
     _queueMutex.unlock();
@@ -227,18 +227,7 @@ void BidCoSQueue::push(std::shared_ptr<BidCoSPacket> packet, bool stealthy)
 		{
 			_queue.push_back(entry);
 			_queueMutex.unlock();
-			if(!noSending)
-			{
-				_sendThreadMutex.lock();
-				if(_disposing)
-				{
-					_sendThreadMutex.unlock();
-					return;
-				}
-				GD::bl->threadManager.join(_sendThread);
-				GD::bl->threadManager.start(_sendThread, false, GD::bl->settings.packetQueueThreadPriority(), GD::bl->settings.packetQueueThreadPolicy(), &BidCoSQueue::send, this, entry.getPacket(), entry.stealthy);
-				_sendThreadMutex.unlock();
-			}
+			if(!noSending) startSending(entry.getPacket(), entry.stealthy);
 		}
 		else
 		{
@@ -249,7 +238,6 @@ void BidCoSQueue::push(std::shared_ptr<BidCoSPacket> packet, bool stealthy)
 	catch(const std::exception& ex)
     {
 		_queueMutex.unlock();
-		_sendThreadMutex.unlock();
     	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
 }
@@ -316,7 +304,6 @@ void BidCoSQueue::push(std::shared_ptr<BidCoSMessage> message)
 	catch(const std::exception& ex)
     {
 		_queueMutex.unlock();
-		_sendThreadMutex.unlock();
     	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
 }
@@ -342,18 +329,7 @@ void BidCoSQueue::pushFront(std::shared_ptr<BidCoSPacket> packet, bool stealthy,
 			_queueMutex.lock();
 			_queue.push_front(entry);
 			_queueMutex.unlock();
-			if(!noSending)
-			{
-				_sendThreadMutex.lock();
-				if(_disposing)
-				{
-					_sendThreadMutex.unlock();
-					return;
-				}
-				GD::bl->threadManager.join(_sendThread);
-				GD::bl->threadManager.start(_sendThread, false, GD::bl->settings.packetQueueThreadPriority(), GD::bl->settings.packetQueueThreadPolicy(), &BidCoSQueue::send, this, entry.getPacket(), entry.stealthy);
-				_sendThreadMutex.unlock();
-			}
+			if(!noSending) startSending(entry.getPacket(), entry.stealthy);
 		}
 		else
 		{
@@ -365,7 +341,6 @@ void BidCoSQueue::pushFront(std::shared_ptr<BidCoSPacket> packet, bool stealthy,
 	catch(const std::exception& ex)
     {
 		_queueMutex.unlock();
-		_sendThreadMutex.unlock();
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
 }
@@ -390,6 +365,38 @@ void BidCoSQueue::send(std::shared_ptr<BidCoSPacket> packet, bool stealthy)
     }
 }
 
+void BidCoSQueue::startSending(std::shared_ptr<BidCoSPacket> packet, bool stealthy)
+{
+	try
+	{
+		post(std::bind(&BidCoSQueue::send, this, packet, stealthy));
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSQueue::post(std::function<void()> task)
+{
+	try
+	{
+		std::lock_guard<std::mutex> postGuard(_postMutex);
+		if(_disposing) return;
+		if(!_sendExecutor)
+		{
+			GD::out.printError("Error: Queue " + std::to_string(id) + " has no send executor.");
+			return;
+		}
+		//The queue's address identifies its strand. dispose() removes the strand, so tasks never run after the queue is destroyed.
+		_sendExecutor->post((uint64_t)(uintptr_t)this, std::move(task));
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
 void BidCoSQueue::clear()
 {
 	try
@@ -431,7 +438,7 @@ void BidCoSQueue::pushPendingQueue()
 			_queueMutex.unlock();
 			return;
 		}
-		std::shared_ptr<BidCoSQueue> queue = _pendingQueues->front();
+		std::shared_ptr<BidCoSQueue> queue = _pendingQueues->start();
 		_queueMutex.unlock();
 		if(!queue) return; //Not really necessary, as the mutex is locked, but I had a segmentation fault in this function, so just to make
 		_queueType = queue->getQueueType();
@@ -447,16 +454,9 @@ void BidCoSQueue::pushPendingQueue()
 				_queueMutex.unlock();
 				if(!noSending)
 				{
-					_sendThreadMutex.lock();
-					if(_disposing)
-					{
-						_sendThreadMutex.unlock();
-						return;
-					}
-					GD::bl->threadManager.join(_sendThread);
+					if(_disposing) return;
 					_lastPop = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-					GD::bl->threadManager.start(_sendThread, false, GD::bl->settings.packetQueueThreadPriority(), GD::bl->settings.packetQueueThreadPolicy(), &BidCoSQueue::send, this, i->getPacket(), i->stealthy);
-					_sendThreadMutex.unlock();
+					startSending(i->getPacket(), i->stealthy);
 				}
 			}
 			else
@@ -471,7 +471,6 @@ void BidCoSQueue::pushPendingQueue()
 	catch(const std::exception& ex)
     {
 		_queueMutex.unlock();
-		_sendThreadMutex.unlock();
     	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
 }
@@ -509,15 +508,7 @@ void BidCoSQueue::nextQueueEntry()
 			{
 				_queueMutex.unlock();
 				GD::out.printDebug("Queue " + std::to_string(id) + " is empty. Pushing pending queue...");
-				_pushPendingQueueThreadMutex.lock();
-				if(_disposing)
-				{
-					_pushPendingQueueThreadMutex.unlock();
-					return;
-				}
-				GD::bl->threadManager.join(_pushPendingQueueThread);
-				GD::bl->threadManager.start(_pushPendingQueueThread, true, GD::bl->settings.packetQueueThreadPriority(), GD::bl->settings.packetQueueThreadPolicy(), &BidCoSQueue::pushPendingQueue, this);
-				_pushPendingQueueThreadMutex.unlock();
+				post(std::bind(&BidCoSQueue::pushPendingQueue, this));
 				return;
 			}
 		}
@@ -528,15 +519,7 @@ void BidCoSQueue::nextQueueEntry()
 				std::shared_ptr<BidCoSPacket> packet = _queue.front().getPacket();
 				bool stealthy = _queue.front().stealthy;
 				_queueMutex.unlock();
-				_sendThreadMutex.lock();
-				if(_disposing)
-				{
-					_sendThreadMutex.unlock();
-					return;
-				}
-				GD::bl->threadManager.join(_sendThread);
-				GD::bl->threadManager.start(_sendThread, false, GD::bl->settings.packetQueueThreadPriority(), GD::bl->settings.packetQueueThreadPolicy(), &BidCoSQueue::send, this, packet, stealthy);
-				_sendThreadMutex.unlock();
+				startSending(packet, stealthy);
 			}
 			else _queueMutex.unlock();
 		}
@@ -545,8 +528,6 @@ void BidCoSQueue::nextQueueEntry()
 	catch(const std::exception& ex)
     {
 		_queueMutex.unlock();
-		_sendThreadMutex.unlock();
-		_pushPendingQueueThreadMutex.unlock();
     	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
 }
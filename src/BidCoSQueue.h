@@ -35,6 +35,7 @@
 #include <homegear-base/BaseLib.h>
 #include "BidCoSPacket.h"
 #include "PhysicalInterfaces/IBidCoSInterface.h"
+#include "BidCoSSendExecutor.h"
 #include "GD.h"
 
 #include <iostream>
@@ -94,22 +95,35 @@ class BidCoSQueue
         std::shared_ptr<PendingBidCoSQueues> _pendingQueues;
         std::mutex _queueMutex;
         BidCoSQueueType _queueType;
-        std::thread _sendThread;
-        std::mutex _sendThreadMutex;
+        std::shared_ptr<BidCoSSendExecutor> _sendExecutor;
+        std::mutex _postMutex;
         std::thread _startResendThread;
         std::mutex _startResendThreadMutex;
-        std::thread _pushPendingQueueThread;
-        std::mutex _pushPendingQueueThreadMutex;
         std::atomic_bool _workingOnPendingQueue;
         int64_t _lastPop = 0;
         void (HomeMaticCentral::*_queueProcessed)() = nullptr;
         void pushPendingQueue();
         void nextQueueEntry();
+
+        /**
+         * Sends the packet on the send executor. All tasks of a queue run in the order they were started.
+         */
+        void startSending(std::shared_ptr<BidCoSPacket> packet, bool stealthy);
+
+        /**
+         * Posts a task to the queue's strand on the send executor unless the queue is being disposed.
+         */
+        void post(std::function<void()> task);
     public:
         uint32_t id = 0;
         uint32_t pendingQueueID = 0;
         std::shared_ptr<int64_t> lastAction;
         std::atomic_bool noSending;
+
+        /**
+         * Set when a pending queue was taken over for sending.
+         */
+        std::atomic_bool started;
         std::shared_ptr<BidCoSPeer> peer;
         std::shared_ptr<CallbackFunctionParameter> callbackParameter;
         std::function<void(std::shared_ptr<CallbackFunctionParameter>)> queueEmptyCallback;
@@ -45,6 +45,7 @@ BidCoSQueueManager::BidCoSQueueManager()
 {
 	_disposing = false;
 	_stopWorkerThread = true;
+	_sendExecutor = GD::sendExecutor;
 }
 
 BidCoSQueueManager::~BidCoSQueueManager()
@@ -55,9 +56,7 @@ BidCoSQueueManager::~BidCoSQueueManager()
 		_workerThreadMutex.lock();
 		GD::bl->threadManager.join(_workerThread);
 		_workerThreadMutex.unlock();
-		_resetQueueThreadMutex.lock();
-		GD::bl->threadManager.join(_resetQueueThread); //After waiting for worker thread!
-		_resetQueueThreadMutex.unlock();
+		if(_sendExecutor) _sendExecutor->remove((uint64_t)(uintptr_t)this); //After waiting for worker thread!
 	}
     catch(const std::exception& ex)
     {
@@ -68,61 +67,51 @@ BidCoSQueueManager::~BidCoSQueueManager()
 void BidCoSQueueManager::dispose(bool wait)
 {
 	_disposing = true;
+	std::lock_guard<std::mutex> queueGuard(_queueMutex);
 	_stopWorkerThread = true;
+	_workerConditionVariable.notify_one();
 }
 
 void BidCoSQueueManager::worker()
 {
 	try
 	{
-		std::chrono::milliseconds sleepingTime(100);
-		int32_t lastQueue;
-		lastQueue = 0;
+		std::unique_lock<std::mutex> queueGuard(_queueMutex);
 		while(!_stopWorkerThread)
 		{
 			try
 			{
-				std::this_thread::sleep_for(sleepingTime);
-				if(_stopWorkerThread) return;
-				_queueMutex.lock();
-				if(!_queues.empty())
+				if(_deadlines.empty())
 				{
-					std::unordered_map<int32_t, std::shared_ptr<BidCoSQueueData>>::iterator nextQueue = _queues.find(lastQueue);
-					if(nextQueue != _queues.end())
-					{
-						nextQueue++;
-						if(nextQueue == _queues.end()) nextQueue = _queues.begin();
-					}
-					else nextQueue = _queues.begin();
-					lastQueue = nextQueue->first;
+					_workerConditionVariable.wait(queueGuard, [&] { return _stopWorkerThread || !_deadlines.empty(); });
+					continue;
 				}
-				std::shared_ptr<BidCoSQueueData> queue;
-				if(_queues.find(lastQueue) != _queues.end()) queue = _queues.at(lastQueue);
-				_queueMutex.unlock();
-				if(queue)
+
+				int64_t now = BaseLib::HelperFunctions::getTime();
+				Deadline deadline = _deadlines.top();
+				if(deadline.time > now)
+				{
+					_workerConditionVariable.wait_for(queueGuard, std::chrono::milliseconds(deadline.time - now));
+					continue;
+				}
+				_deadlines.pop();
+
+				auto queueIterator = _queues.find(deadline.address);
+				if(queueIterator == _queues.end() || !queueIterator->second || queueIterator->second->id != deadline.id) continue; //Queue was replaced or deleted
+				int64_t staleTime = *queueIterator->second->lastAction + _staleTime;
+				if(queueIterator->second->queue && !queueIterator->second->queue->isEmpty() && now <= staleTime)
 				{
-					try
-					{
-						_resetQueueThreadMutex.lock();
-						if(_disposing)
-						{
-							_resetQueueThreadMutex.unlock();
-							return;
-						}
-						GD::bl->threadManager.join(_resetQueueThread);
-						//Has to be called in a thread as resetQueue might cause queuing (retrying in setUnreach) and therefore a deadlock
-						GD::bl->threadManager.start(_resetQueueThread, true, &BidCoSQueueManager::resetQueue, this, lastQueue, queue->id);
-					}
-					catch(const std::exception& ex)
-					{
-						GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-					}
-					_resetQueueThreadMutex.unlock();
+					//The queue was used since the deadline was set. Empty queues are deleted right away.
+					addDeadline(deadline.address, deadline.id, std::min(staleTime + 1, now + _emptyCheckInterval));
+					continue;
 				}
+
+				//Has to be called in another thread as resetQueue might cause queuing (retrying in setUnreach) and therefore a deadlock
+				if(_sendExecutor) _sendExecutor->post((uint64_t)(uintptr_t)this, std::bind(&BidCoSQueueManager::resetQueueTask, this, deadline.address, deadline.id, deadline.time));
 			}
 			catch(const std::exception& ex)
 			{
-				_queueMutex.unlock();
+				if(!queueGuard.owns_lock()) queueGuard.lock();
 				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
 			}
 		}
@@ -133,6 +122,46 @@ void BidCoSQueueManager::worker()
     }
 }
 
+void BidCoSQueueManager::addDeadline(int32_t address, uint32_t id, int64_t time)
+{
+	Deadline deadline;
+	deadline.time = time;
+	deadline.address = address;
+	deadline.id = id;
+	//Only wake up the worker when it is waiting for a later deadline.
+	bool notify = _deadlines.empty() || deadline.time < _deadlines.top().time;
+	_deadlines.push(deadline);
+	if(notify) _workerConditionVariable.notify_one();
+}
+
+void BidCoSQueueManager::resetQueueTask(int32_t address, uint32_t id, int64_t deadline)
+{
+	try
+	{
+		int64_t lag = BaseLib::HelperFunctions::getTime() - deadline;
+		if(!resetQueue(address, id)) return;
+		std::lock_guard<std::mutex> queueGuard(_queueMutex);
+		_resets++;
+		_totalLag += lag;
+		if(lag > _maxLag) _maxLag = lag;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+BidCoSQueueManager::ReaperStatistics BidCoSQueueManager::getReaperStatistics()
+{
+	ReaperStatistics statistics;
+	std::lock_guard<std::mutex> queueGuard(_queueMutex);
+	statistics.scheduledChecks = _deadlines.size();
+	statistics.resets = _resets;
+	statistics.averageLag = _resets > 0 ? _totalLag / (int64_t)_resets : 0;
+	statistics.maxLag = _maxLag;
+	return statistics;
+}
+
 std::shared_ptr<BidCoSQueue> BidCoSQueueManager::createQueue(std::shared_ptr<IBidCoSInterface> physicalInterface, BidCoSQueueType queueType, int32_t address)
 {
 	try
@@ -182,6 +211,7 @@ std::shared_ptr<BidCoSQueue> BidCoSQueueManager::createQueue(std::shared_ptr<IBi
 		queueData->queue->id = _id++;
 		queueData->id = queueData->queue->id;
 		_queues.insert(std::pair<int32_t, std::shared_ptr<BidCoSQueueData>>(address, queueData));
+		addDeadline(address, queueData->id, *queueData->lastAction + _staleTime + 1);
 		_queueMutex.unlock();
 		return queueData->queue;
 	}
@@ -194,35 +224,38 @@ std::shared_ptr<BidCoSQueue> BidCoSQueueManager::createQueue(std::shared_ptr<IBi
     return std::shared_ptr<BidCoSQueue>();
 }
 
-void BidCoSQueueManager::resetQueue(int32_t address, uint32_t id)
+bool BidCoSQueueManager::resetQueue(int32_t address, uint32_t id)
 {
 	try
 	{
-		if(_disposing) return;
+		if(_disposing) return false;
 		_queueMutex.lock();
 		if(_queues.empty())
 		{
-			_stopWorkerThread = true;
 			_queueMutex.unlock();
-			return;
+			return false;
 		}
-		if(_queues.find(address) != _queues.end() && _queues.at(address) && _queues.at(address)->queue && !_queues.at(address)->queue->isEmpty() && std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count() <= *_queues.at(address)->lastAction + 3000)
+		int64_t now = BaseLib::HelperFunctions::getTime();
+		if(_queues.find(address) != _queues.end() && _queues.at(address) && _queues.at(address)->queue && !_queues.at(address)->queue->isEmpty() && now <= *_queues.at(address)->lastAction + _staleTime)
 		{
+			if(_queues.at(address)->id == id) addDeadline(address, id, std::min(*_queues.at(address)->lastAction + _staleTime + 1, now + _emptyCheckInterval));
 			_queueMutex.unlock();
-			return;
+			return false;
 		}
 
 		std::shared_ptr<BidCoSQueueData> queue;
 		std::shared_ptr<BidCoSPeer> peer;
 		bool setUnreach = false;
+		bool deleted = false;
 		if(_queues.find(address) != _queues.end() && _queues.at(address) && _queues.at(address)->id == id)
 		{
 			queue = _queues.at(address);
-			if(queue->queue.use_count() > 1 && std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count() <= *queue->lastAction + 20000)
+			if(queue->queue.use_count() > 1 && now <= *queue->lastAction + _inUseStaleTime)
 			{
+				addDeadline(address, id, std::min(*queue->lastAction + _inUseStaleTime + 1, now + _inUseCheckInterval));
 				_queueMutex.unlock();
 				GD::out.printDebug("Debug: Postponing deletion of queue " + std::to_string(id) + " for BidCoS peer with address 0x" + BaseLib::HelperFunctions::getHexString(address) + ", because it is still in use (" + std::to_string(queue->queue.use_count()) + " referring objects).");
-				return;
+				return false;
 			}
 			GD::out.printDebug("Debug: Deleting queue " + std::to_string(id) + " for BidCoS peer with address 0x" + BaseLib::HelperFunctions::getHexString(address));
 			_queues.erase(address);
@@ -235,22 +268,24 @@ void BidCoSQueueManager::resetQueue(int32_t address, uint32_t id)
 				}
 			}
 			queue->queue->dispose();
+			deleted = true;
 		}
 		//setUnreach calls enqueuePendingQueues, which calls BidCoSQueueManger::get => deadlock,
 		//so we need to unlock first
-		if(_queues.empty()) _stopWorkerThread = true;
 		_queueMutex.unlock();
 		if(setUnreach)
 		{
 			GD::out.printInfo("Info: Setting peer to unreachable, because the queue processing was interrupted.");
 			peer->serviceMessages->setUnreach(true, true);
 		}
+		return deleted;
 	}
 	catch(const std::exception& ex)
     {
 		_queueMutex.unlock();
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
+    return false;
 }
 
 std::shared_ptr<BidCoSQueue> BidCoSQueueManager::get(int32_t address)
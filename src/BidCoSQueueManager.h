@@ -38,8 +38,12 @@
 
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <algorithm>
 #include <memory>
+#include <queue>
 #include <unordered_map>
+#include <vector>
 
 namespace BidCoS
 {
@@ -59,25 +63,92 @@ public:
 class BidCoSQueueManager
 {
 public:
+	struct ReaperStatistics
+	{
+		uint32_t scheduledChecks = 0;
+		uint64_t resets = 0;
+
+		/**
+		 * Time in milliseconds between a queue becoming stale and its reset.
+		 */
+		int64_t averageLag = 0;
+		int64_t maxLag = 0;
+	};
+
 	BidCoSQueueManager();
 	virtual ~BidCoSQueueManager();
 
 	std::shared_ptr<BidCoSQueue> get(int32_t address);
 	std::shared_ptr<BidCoSQueue> createQueue(std::shared_ptr<IBidCoSInterface> physicalInterface, BidCoSQueueType queueType, int32_t address);
-	void resetQueue(int32_t address, uint32_t id);
+
+	/**
+	 * Deletes the queue when it is empty or stale and not in use anymore. Otherwise a new deadline is set.
+	 *
+	 * @return Returns true when the queue was deleted.
+	 */
+	bool resetQueue(int32_t address, uint32_t id);
 	void dispose(bool wait = true);
+	ReaperStatistics getReaperStatistics();
 protected:
+	/**
+	 * Queues with entries are reset when they weren't used for this time (in milliseconds).
+	 */
+	static constexpr int64_t _staleTime = 3000;
+
+	/**
+	 * Queues still referenced by other objects are kept until they weren't used for this time (in milliseconds).
+	 */
+	static constexpr int64_t _inUseStaleTime = 20000;
+
+	/**
+	 * Interval in milliseconds to check if a queue is still referenced.
+	 */
+	static constexpr int64_t _inUseCheckInterval = 1000;
+
+	/**
+	 * Interval in milliseconds to check queues with entries, so they are deleted soon after they were emptied.
+	 */
+	static constexpr int64_t _emptyCheckInterval = 100;
+
+	struct Deadline
+	{
+		int64_t time = 0;
+		int32_t address = 0;
+		uint32_t id = 0;
+
+		bool operator>(const Deadline& other) const { return time > other.time; }
+	};
+
 	std::atomic_bool _disposing;
 	std::atomic_bool _stopWorkerThread;
 	std::mutex _workerThreadMutex;
     std::thread _workerThread;
-    std::mutex _resetQueueThreadMutex;
-    std::thread _resetQueueThread;
+    std::shared_ptr<BidCoSSendExecutor> _sendExecutor;
 	uint32_t _id = 0;
 	std::unordered_map<int32_t, std::shared_ptr<BidCoSQueueData>> _queues;
 	std::mutex _queueMutex;
 
+	/**
+	 * Times at which the queues need to be checked, earliest first. Deadlines are evaluated against "lastAction" when they are due, so
+	 * keepAlive() doesn't need to update them. Protected by "_queueMutex".
+	 */
+	std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> _deadlines;
+	std::condition_variable _workerConditionVariable;
+	uint64_t _resets = 0;
+	int64_t _totalLag = 0;
+	int64_t _maxLag = 0;
+
 	void worker();
+
+	/**
+	 * Adds a deadline. "_queueMutex" must be locked.
+	 */
+	void addDeadline(int32_t address, uint32_t id, int64_t time);
+
+	/**
+	 * Runs on the send executor. Calls resetQueue() and records the reaper lag when the queue was deleted.
+	 */
+	void resetQueueTask(int32_t address, uint32_t id, int64_t deadline);
 };
 }
 #endif /* BIDCOSQUEUEMANAGER_H_ */
@@ -0,0 +1,166 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "BidCoSReceivePipeline.h"
+#include "GD.h"
+
+namespace BidCoS
+{
+BidCoSReceivePipeline::BidCoSReceivePipeline(uint32_t workerCount, uint32_t maxQueueSize, std::function<void(std::string&, std::shared_ptr<BidCoSPacket>)> handler)
+{
+	try
+	{
+		_handler = handler;
+		if(workerCount == 0) workerCount = 1;
+		if(maxQueueSize > 0) _maxQueueSize = maxQueueSize;
+		_workers.reserve(workerCount);
+		for(uint32_t i = 0; i < workerCount; i++)
+		{
+			_workers.emplace_back(new Worker());
+		}
+		for(uint32_t i = 0; i < workerCount; i++)
+		{
+			GD::bl->threadManager.start(_workers[i]->thread, true, GD::bl->settings.workerThreadPriority(), GD::bl->settings.workerThreadPolicy(), &BidCoSReceivePipeline::worker, this, i);
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+BidCoSReceivePipeline::~BidCoSReceivePipeline()
+{
+	dispose();
+}
+
+void BidCoSReceivePipeline::dispose()
+{
+	try
+	{
+		if(_disposing.exchange(true)) return;
+		for(auto& worker : _workers)
+		{
+			std::lock_guard<std::mutex> workerGuard(worker->mutex);
+			worker->conditionVariable.notify_all();
+		}
+		for(auto& worker : _workers)
+		{
+			GD::bl->threadManager.join(worker->thread);
+			std::lock_guard<std::mutex> workerGuard(worker->mutex);
+			worker->items.clear();
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+bool BidCoSReceivePipeline::post(int32_t partitionKey, const std::string& senderId, std::shared_ptr<BidCoSPacket> packet)
+{
+	try
+	{
+		if(_disposing || _workers.empty()) return false;
+		uint32_t index = (uint32_t)(((uint64_t)((uint32_t)partitionKey * 2654435769u) * _workers.size()) >> 32);
+		Worker& worker = *_workers[index];
+		std::lock_guard<std::mutex> workerGuard(worker.mutex);
+		if(worker.items.size() >= _maxQueueSize)
+		{
+			//Processing the packet on the caller's thread would overtake the queued packets of the same peer.
+			if(worker.droppedPackets++ == 0 || GD::bl->debugLevel >= 5) GD::out.printWarning("Warning: Receive queue of worker " + std::to_string(index) + " is full. Dropping packet from 0x" + BaseLib::HelperFunctions::getHexString(packet->senderAddress(), 6) + ".");
+			return true;
+		}
+		Item item;
+		item.senderId = senderId;
+		item.packet = packet;
+		worker.items.push_back(std::move(item));
+		if(worker.items.size() > worker.maxQueueDepth) worker.maxQueueDepth = worker.items.size();
+		worker.conditionVariable.notify_one();
+		return true;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return false;
+}
+
+std::vector<BidCoSReceivePipeline::WorkerStatistics> BidCoSReceivePipeline::getStatistics()
+{
+	std::vector<WorkerStatistics> statistics;
+	statistics.reserve(_workers.size());
+	for(auto& worker : _workers)
+	{
+		WorkerStatistics workerStatistics;
+		std::lock_guard<std::mutex> workerGuard(worker->mutex);
+		workerStatistics.queueDepth = worker->items.size();
+		workerStatistics.maxQueueDepth = worker->maxQueueDepth;
+		workerStatistics.processedPackets = worker->processedPackets;
+		workerStatistics.droppedPackets = worker->droppedPackets;
+		workerStatistics.averageProcessingTime = worker->processedPackets > 0 ? worker->totalProcessingTime / (int64_t)worker->processedPackets : 0;
+		workerStatistics.maxProcessingTime = worker->maxProcessingTime;
+		statistics.push_back(workerStatistics);
+	}
+	return statistics;
+}
+
+void BidCoSReceivePipeline::worker(uint32_t index)
+{
+	Worker& worker = *_workers[index];
+	while(!_disposing)
+	{
+		try
+		{
+			Item item;
+			{
+				std::unique_lock<std::mutex> workerGuard(worker.mutex);
+				worker.conditionVariable.wait(workerGuard, [&] { return _disposing || !worker.items.empty(); });
+				if(_disposing) return;
+				item = std::move(worker.items.front());
+				worker.items.pop_front();
+			}
+
+			auto startTime = std::chrono::steady_clock::now();
+			_handler(item.senderId, item.packet);
+			int64_t processingTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+			std::lock_guard<std::mutex> workerGuard(worker.mutex);
+			worker.processedPackets++;
+			worker.totalProcessingTime += processingTime;
+			if(processingTime > worker.maxProcessingTime) worker.maxProcessingTime = processingTime;
+		}
+		catch(const std::exception& ex)
+		{
+			GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+		}
+	}
+}
+
+}
@@ -0,0 +1,126 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef BIDCOSRECEIVEPIPELINE_H_
+#define BIDCOSRECEIVEPIPELINE_H_
+
+#include <cstdint>
+
+#include <homegear-base/BaseLib.h>
+#include "BidCoSPacket.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace BidCoS
+{
+
+/**
+ * Processes received packets on a fixed number of worker threads instead of the listen thread of the interface. Packets are distributed by a
+ * partition key (the sender or team address), so the packets of one peer are still processed in the order they were received while
+ * packets of different peers are processed in parallel.
+ */
+class BidCoSReceivePipeline
+{
+public:
+	struct WorkerStatistics
+	{
+		uint32_t queueDepth = 0;
+		uint32_t maxQueueDepth = 0;
+		uint64_t processedPackets = 0;
+		uint64_t droppedPackets = 0;
+		int64_t averageProcessingTime = 0;
+		int64_t maxProcessingTime = 0;
+	};
+
+	/**
+	 * @param workerCount The number of worker threads.
+	 * @param maxQueueSize The maximum number of packets queued for one worker.
+	 * @param handler Called on a worker thread for each packet.
+	 */
+	BidCoSReceivePipeline(uint32_t workerCount, uint32_t maxQueueSize, std::function<void(std::string&, std::shared_ptr<BidCoSPacket>)> handler);
+	virtual ~BidCoSReceivePipeline();
+
+	/**
+	 * Stops all worker threads. Queued packets are dropped.
+	 */
+	void dispose();
+
+	/**
+	 * Queues a packet for processing. The packet is dropped and counted when the queue of the worker is full, so a slow peer can't make the
+	 * pipeline use unbounded memory.
+	 *
+	 * @param partitionKey Packets with the same key are processed by the same worker in order.
+	 * @param senderId The ID of the interface the packet was received by.
+	 * @param packet The packet to process.
+	 * @return Returns false when the pipeline was disposed. Dropped packets return true.
+	 */
+	bool post(int32_t partitionKey, const std::string& senderId, std::shared_ptr<BidCoSPacket> packet);
+
+	/**
+	 * Returns the counters of each worker. Processing times are in microseconds.
+	 */
+	std::vector<WorkerStatistics> getStatistics();
+private:
+	struct Item
+	{
+		std::string senderId;
+		std::shared_ptr<BidCoSPacket> packet;
+	};
+
+	struct Worker
+	{
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable conditionVariable;
+		std::deque<Item> items;
+		uint32_t maxQueueDepth = 0;
+		uint64_t processedPackets = 0;
+		uint64_t droppedPackets = 0;
+		int64_t totalProcessingTime = 0;
+		int64_t maxProcessingTime = 0;
+	};
+
+	std::function<void(std::string&, std::shared_ptr<BidCoSPacket>)> _handler;
+	uint32_t _maxQueueSize = 1000;
+	std::atomic_bool _disposing{false};
+	std::vector<std::unique_ptr<Worker>> _workers;
+
+	void worker(uint32_t index);
+};
+
+}
+#endif
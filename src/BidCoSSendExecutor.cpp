@@ -0,0 +1,234 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "BidCoSSendExecutor.h"
+#include "GD.h"
+
+namespace BidCoS
+{
+BidCoSSendExecutor::BidCoSSendExecutor(uint32_t threadCount, uint32_t maxThreadCount)
+{
+	try
+	{
+		if(threadCount == 0) threadCount = 1;
+		_maxThreadCount = maxThreadCount < threadCount ? threadCount : maxThreadCount;
+		std::lock_guard<std::mutex> strandsGuard(_strandsMutex);
+		for(uint32_t i = 0; i < threadCount; i++)
+		{
+			_threads.emplace_back();
+			GD::bl->threadManager.start(_threads.back(), true, GD::bl->settings.packetQueueThreadPriority(), GD::bl->settings.packetQueueThreadPolicy(), &BidCoSSendExecutor::worker, this);
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+BidCoSSendExecutor::~BidCoSSendExecutor()
+{
+	dispose();
+}
+
+void BidCoSSendExecutor::dispose()
+{
+	try
+	{
+		{
+			std::lock_guard<std::mutex> strandsGuard(_strandsMutex);
+			if(_disposing) return;
+			_disposing = true;
+			_workerConditionVariable.notify_all();
+		}
+		for(auto& thread : _threads)
+		{
+			GD::bl->threadManager.join(thread);
+		}
+		std::lock_guard<std::mutex> strandsGuard(_strandsMutex);
+		_strands.clear();
+		_readyStrands.clear();
+		_queueDepth = 0;
+		_strandFinishedConditionVariable.notify_all();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSSendExecutor::post(uint64_t strand, std::function<void()> task)
+{
+	try
+	{
+		if(_disposing || !task) return;
+		std::lock_guard<std::mutex> strandsGuard(_strandsMutex);
+		if(_disposing) return;
+		Strand& currentStrand = _strands[strand];
+		Task newTask;
+		newTask.function = std::move(task);
+		newTask.postTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		currentStrand.tasks.push_back(std::move(newTask));
+		_queueDepth++;
+		if(_queueDepth > _maxQueueDepth) _maxQueueDepth = _queueDepth;
+		//Running strands are requeued by the worker when their current task finishes.
+		if(!currentStrand.running && currentStrand.tasks.size() == 1)
+		{
+			_readyStrands.push_back(strand);
+			startWorkerIfNeeded();
+			_workerConditionVariable.notify_one();
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSSendExecutor::remove(uint64_t strand)
+{
+	try
+	{
+		std::unique_lock<std::mutex> strandsGuard(_strandsMutex);
+		auto strandIterator = _strands.find(strand);
+		if(strandIterator == _strands.end()) return;
+		_queueDepth -= strandIterator->second.tasks.size();
+		strandIterator->second.tasks.clear();
+		if(!strandIterator->second.running)
+		{
+			_strands.erase(strandIterator);
+			return;
+		}
+		if(strandIterator->second.thread == std::this_thread::get_id()) return; //The worker erases the strand after the task.
+		_strandFinishedConditionVariable.wait(strandsGuard, [&] { auto i = _strands.find(strand); return i == _strands.end() || !i->second.running; });
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+BidCoSSendExecutor::Statistics BidCoSSendExecutor::getStatistics()
+{
+	Statistics statistics;
+	std::lock_guard<std::mutex> strandsGuard(_strandsMutex);
+	statistics.threadCount = _threads.size();
+	statistics.busyThreads = _busyThreads;
+	statistics.queueDepth = _queueDepth;
+	statistics.maxQueueDepth = _maxQueueDepth;
+	statistics.executedTasks = _executedTasks;
+	statistics.averageLatency = _executedTasks > 0 ? _totalLatency / (int64_t)_executedTasks : 0;
+	statistics.maxLatency = _maxLatency;
+	return statistics;
+}
+
+void BidCoSSendExecutor::startWorkerIfNeeded()
+{
+	try
+	{
+		if(_disposing || _threads.size() >= _maxThreadCount || _readyStrands.size() <= _threads.size() - _busyThreads) return;
+		_threads.emplace_back();
+		GD::bl->threadManager.start(_threads.back(), true, GD::bl->settings.packetQueueThreadPriority(), GD::bl->settings.packetQueueThreadPolicy(), &BidCoSSendExecutor::worker, this);
+		GD::out.printInfo("Info: All " + std::to_string(_threads.size() - 1) + " send threads are busy. Started another one.");
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSSendExecutor::worker()
+{
+	std::unique_lock<std::mutex> strandsGuard(_strandsMutex);
+	while(!_disposing)
+	{
+		try
+		{
+			if(_readyStrands.empty())
+			{
+				_workerConditionVariable.wait(strandsGuard, [&] { return _disposing || !_readyStrands.empty(); });
+				continue;
+			}
+			uint64_t strand = _readyStrands.front();
+			_readyStrands.pop_front();
+			auto strandIterator = _strands.find(strand);
+			if(strandIterator == _strands.end() || strandIterator->second.running) continue;
+			if(strandIterator->second.tasks.empty())
+			{
+				_strands.erase(strandIterator);
+				continue;
+			}
+
+			Task task = std::move(strandIterator->second.tasks.front());
+			strandIterator->second.tasks.pop_front();
+			strandIterator->second.running = true;
+			strandIterator->second.thread = std::this_thread::get_id();
+			_busyThreads++;
+			_queueDepth--;
+			int64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() - task.postTime;
+			_executedTasks++;
+			_totalLatency += latency;
+			if(latency > _maxLatency) _maxLatency = latency;
+			strandsGuard.unlock();
+
+			try
+			{
+				task.function();
+			}
+			catch(const std::exception& ex)
+			{
+				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+			}
+			task.function = std::function<void()>(); //Release captured objects before locking
+
+			strandsGuard.lock();
+			_busyThreads--;
+			//The iterator might be invalid at this point.
+			strandIterator = _strands.find(strand);
+			if(strandIterator != _strands.end())
+			{
+				strandIterator->second.running = false;
+				strandIterator->second.thread = std::thread::id();
+				if(strandIterator->second.tasks.empty()) _strands.erase(strandIterator);
+				else
+				{
+					_readyStrands.push_back(strand);
+					startWorkerIfNeeded();
+				}
+			}
+			_strandFinishedConditionVariable.notify_all();
+		}
+		catch(const std::exception& ex)
+		{
+			if(!strandsGuard.owns_lock()) strandsGuard.lock();
+			GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+		}
+	}
+}
+
+}
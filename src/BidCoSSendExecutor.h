@@ -0,0 +1,149 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef BIDCOSSENDEXECUTOR_H_
+#define BIDCOSSENDEXECUTOR_H_
+
+#include <cstdint>
+
+#include <homegear-base/BaseLib.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace BidCoS
+{
+
+/**
+ * Pool of threads executing the send, pending queue and queue reset tasks of all queues. Tasks are posted to a strand. Tasks of one strand
+ * are executed one after another in the order they were posted, tasks of different strands run in parallel. Every queue uses its own strand, so
+ * the packets of a peer are still sent in order.
+ *
+ * Sending blocks until the interface is done with the packet. So a few slow peers don't stall all other queues, the pool starts another thread
+ * when a strand is ready and all threads are busy, up to the maximum thread count.
+ */
+class BidCoSSendExecutor
+{
+public:
+	struct Statistics
+	{
+		uint32_t threadCount = 0;
+		uint32_t busyThreads = 0;
+		uint32_t queueDepth = 0;
+		uint32_t maxQueueDepth = 0;
+		uint64_t executedTasks = 0;
+		int64_t averageLatency = 0;
+		int64_t maxLatency = 0;
+	};
+
+	/**
+	 * @param threadCount The number of threads started immediately.
+	 * @param maxThreadCount The maximum number of threads when all threads are busy.
+	 */
+	BidCoSSendExecutor(uint32_t threadCount, uint32_t maxThreadCount);
+	virtual ~BidCoSSendExecutor();
+
+	/**
+	 * Stops all threads. Tasks posted after this are dropped.
+	 */
+	void dispose();
+
+	/**
+	 * Queues a task for execution.
+	 *
+	 * @param strand Tasks with the same strand are never executed concurrently.
+	 * @param task The task to execute.
+	 */
+	void post(uint64_t strand, std::function<void()> task);
+
+	/**
+	 * Removes all queued tasks of a strand and waits until its running task finished. Doesn't wait when called from within a task of the strand.
+	 */
+	void remove(uint64_t strand);
+
+	/**
+	 * Returns the current counters. Latencies are the times in microseconds between posting and starting a task.
+	 */
+	Statistics getStatistics();
+private:
+	struct Task
+	{
+		std::function<void()> function;
+		int64_t postTime = 0;
+	};
+
+	struct Strand
+	{
+		std::deque<Task> tasks;
+		bool running = false;
+		std::thread::id thread;
+	};
+
+	std::atomic_bool _disposing{false};
+	uint32_t _maxThreadCount = 0;
+	uint32_t _busyThreads = 0;
+
+	/**
+	 * A list, because threads are added while others are running.
+	 */
+	std::list<std::thread> _threads;
+	std::mutex _strandsMutex;
+	std::condition_variable _workerConditionVariable;
+	std::condition_variable _strandFinishedConditionVariable;
+	std::unordered_map<uint64_t, Strand> _strands;
+
+	/**
+	 * Strands with queued tasks which are not running.
+	 */
+	std::deque<uint64_t> _readyStrands;
+
+	uint32_t _queueDepth = 0;
+	uint32_t _maxQueueDepth = 0;
+	uint64_t _executedTasks = 0;
+	int64_t _totalLatency = 0;
+	int64_t _maxLatency = 0;
+
+	void worker();
+
+	/**
+	 * Starts another worker if there are more ready strands than idle threads. "_strandsMutex" needs to be locked.
+	 */
+	void startWorkerIfNeeded();
+};
+
+}
+#endif
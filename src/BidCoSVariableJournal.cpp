@@ -0,0 +1,126 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "BidCoSVariableJournal.h"
+#include "GD.h"
+#include "HomeMaticCentral.h"
+
+#include <unordered_map>
+
+namespace BidCoS
+{
+BidCoSVariableJournal::BidCoSVariableJournal(int64_t flushInterval) : BidCoSWriteBehind(flushInterval)
+{
+	start();
+}
+
+BidCoSVariableJournal::~BidCoSVariableJournal()
+{
+	dispose();
+}
+
+bool BidCoSVariableJournal::append(uint64_t peerId, uint32_t index)
+{
+	try
+	{
+		if(index >= 32) return false;
+		std::lock_guard<std::mutex> bufferGuard(_bufferMutex);
+		if(_disposing) return false;
+		Entry entry;
+		entry.peerId = peerId;
+		entry.index = index;
+		_journal.push_back(entry);
+		_appendedEntries++;
+		return true;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return false;
+}
+
+bool BidCoSVariableJournal::writeBuffer()
+{
+	try
+	{
+		std::vector<Entry> journal;
+		{
+			std::lock_guard<std::mutex> bufferGuard(_bufferMutex);
+			if(_journal.empty()) return false;
+			journal.swap(_journal);
+		}
+
+		//Compact to one bit per variable and peer
+		std::unordered_map<uint64_t, uint32_t> dirtyVariables;
+		for(auto& entry : journal)
+		{
+			dirtyVariables[entry.peerId] |= (1u << entry.index);
+		}
+
+		std::shared_ptr<HomeMaticCentral> central = std::dynamic_pointer_cast<HomeMaticCentral>(GD::family->getCentral());
+		if(!central)
+		{
+			//Peers are not loaded yet. Keep the entries.
+			std::lock_guard<std::mutex> bufferGuard(_bufferMutex);
+			_journal.insert(_journal.begin(), journal.begin(), journal.end());
+			return false;
+		}
+
+		for(auto& element : dirtyVariables)
+		{
+			std::shared_ptr<BidCoSPeer> peer = central->getPeer(element.first);
+			if(!peer) continue;
+			peer->saveJournaledVariables(element.second);
+			for(uint32_t variables = element.second; variables != 0; variables &= variables - 1)
+			{
+				_writtenVariables++;
+			}
+		}
+		return true;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return false;
+}
+
+BidCoSVariableJournal::Statistics BidCoSVariableJournal::getStatistics()
+{
+	Statistics statistics;
+	statistics.appendedEntries = _appendedEntries;
+	statistics.writtenVariables = _writtenVariables;
+	statistics.flushes = _flushes;
+	std::lock_guard<std::mutex> bufferGuard(_bufferMutex);
+	statistics.pendingEntries = _journal.size();
+	return statistics;
+}
+
+}
@@ -0,0 +1,93 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef BIDCOSVARIABLEJOURNAL_H_
+#define BIDCOSVARIABLEJOURNAL_H_
+
+#include <cstdint>
+
+#include <homegear-base/BaseLib.h>
+#include "BidCoSWriteBehind.h"
+
+#include <atomic>
+#include <vector>
+
+namespace BidCoS
+{
+
+/**
+ * Write-behind journal for peer variables which change with nearly every packet, like the message counter or the pending queues. Changes
+ * are appended to an in-memory journal without touching the database. A background thread compacts the journal to one write per variable
+ * and peer and lets the peers write the current values. The database stays the only persistent store, so there is nothing to replay on
+ * startup. At most the changes of one flush interval are lost on a crash.
+ */
+class BidCoSVariableJournal : public BidCoSWriteBehind
+{
+public:
+	struct Statistics
+	{
+		uint64_t appendedEntries = 0;
+		uint64_t writtenVariables = 0;
+		uint64_t flushes = 0;
+		uint32_t pendingEntries = 0;
+	};
+
+	BidCoSVariableJournal(int64_t flushInterval);
+	virtual ~BidCoSVariableJournal();
+
+	/**
+	 * Records a change of a variable.
+	 *
+	 * @param peerId The ID of the peer.
+	 * @param index The index of the variable. Must be smaller than 32.
+	 * @return Returns false when the journal was disposed. The caller needs to write the variable itself in this case.
+	 */
+	bool append(uint64_t peerId, uint32_t index);
+
+	Statistics getStatistics();
+private:
+	struct Entry
+	{
+		uint64_t peerId = 0;
+		uint32_t index = 0;
+	};
+
+	/**
+	 * Protected by "_bufferMutex".
+	 */
+	std::vector<Entry> _journal;
+
+	std::atomic<uint64_t> _appendedEntries{0};
+	std::atomic<uint64_t> _writtenVariables{0};
+
+	bool writeBuffer() override;
+};
+
+}
+#endif
@@ -0,0 +1,127 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "BidCoSWriteBehind.h"
+#include "GD.h"
+
+namespace BidCoS
+{
+BidCoSWriteBehind::BidCoSWriteBehind(int64_t flushInterval)
+{
+	if(flushInterval > 0) _flushInterval = flushInterval;
+}
+
+BidCoSWriteBehind::~BidCoSWriteBehind()
+{
+	//The derived class is destroyed already, so the buffer can't be written anymore. Only make sure the thread is stopped.
+	{
+		std::lock_guard<std::mutex> bufferGuard(_bufferMutex);
+		_disposing = true;
+		_bufferConditionVariable.notify_all();
+	}
+	GD::bl->threadManager.join(_workerThread);
+}
+
+void BidCoSWriteBehind::start()
+{
+	try
+	{
+		GD::bl->threadManager.start(_workerThread, true, &BidCoSWriteBehind::worker, this);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSWriteBehind::dispose()
+{
+	try
+	{
+		{
+			std::lock_guard<std::mutex> bufferGuard(_bufferMutex);
+			if(_disposing) return;
+			_disposing = true;
+			_bufferConditionVariable.notify_all();
+		}
+		GD::bl->threadManager.join(_workerThread);
+		flush();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSWriteBehind::requestFlush()
+{
+	if(_flushRequested) return;
+	_flushRequested = true;
+	_bufferConditionVariable.notify_one();
+}
+
+void BidCoSWriteBehind::flush()
+{
+	try
+	{
+		std::lock_guard<std::mutex> flushGuard(_flushMutex);
+		{
+			std::lock_guard<std::mutex> bufferGuard(_bufferMutex);
+			if(_flushRequested) _requestedFlushes++;
+			_flushRequested = false;
+		}
+		if(writeBuffer()) _flushes++;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void BidCoSWriteBehind::worker()
+{
+	while(!_disposing)
+	{
+		try
+		{
+			{
+				std::unique_lock<std::mutex> bufferGuard(_bufferMutex);
+				_bufferConditionVariable.wait_for(bufferGuard, std::chrono::milliseconds(_flushInterval), [&] { return _disposing || _flushRequested; });
+				if(_disposing) return;
+			}
+			flush();
+		}
+		catch(const std::exception& ex)
+		{
+			GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+		}
+	}
+}
+
+}
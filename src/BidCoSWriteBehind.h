@@ -0,0 +1,113 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef BIDCOSWRITEBEHIND_H_
+#define BIDCOSWRITEBEHIND_H_
+
+#include <cstdint>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace BidCoS
+{
+
+/**
+ * Base class for buffers which collect database writes in memory and write them from a background thread. The derived class owns the buffer
+ * and implements "writeBuffer()". The buffer is written every flush interval, when "requestFlush()" is called and on "dispose()". Flushes are
+ * serialized, so a later flush can't overtake an earlier one.
+ */
+class BidCoSWriteBehind
+{
+public:
+	/**
+	 * @param flushInterval The maximum time in milliseconds a change stays in the buffer.
+	 */
+	BidCoSWriteBehind(int64_t flushInterval);
+	virtual ~BidCoSWriteBehind();
+
+	/**
+	 * Stops the background thread and writes the buffer. "_disposing" is set afterwards, so the derived class can refuse new changes.
+	 * Derived classes need to call this in their destructor.
+	 */
+	void dispose();
+
+	/**
+	 * Writes the buffer now.
+	 */
+	void flush();
+protected:
+	int64_t _flushInterval = 1000;
+	std::atomic_bool _disposing{false};
+
+	/**
+	 * Protects the buffer of the derived class.
+	 */
+	std::mutex _bufferMutex;
+
+	std::atomic<uint64_t> _flushes{0};
+
+	/**
+	 * Number of flushes triggered by "requestFlush()".
+	 */
+	std::atomic<uint64_t> _requestedFlushes{0};
+
+	/**
+	 * Starts the background thread. Needs to be called at the end of the constructor of the derived class.
+	 */
+	void start();
+
+	/**
+	 * Wakes up the background thread to write the buffer before the flush interval ends. "_bufferMutex" must be locked.
+	 */
+	void requestFlush();
+
+	/**
+	 * Takes the buffered changes and writes them. Never called by two threads at the same time.
+	 *
+	 * @return Returns true when changes were written.
+	 */
+	virtual bool writeBuffer() = 0;
+private:
+	std::thread _workerThread;
+	std::condition_variable _bufferConditionVariable;
+	bool _flushRequested = false;
+
+	/**
+	 * Held while the buffer is written.
+	 */
+	std::mutex _flushMutex;
+
+	void worker();
+};
+
+}
+#endif
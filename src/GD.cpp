@@ -28,6 +28,9 @@
  */
 
 #include "GD.h"
+#include "BidCoSLatencyStatistics.h"
+#include "BidCoSSendExecutor.h"
+#include "BidCoSVariableJournal.h"
 
 namespace BidCoS
 {
@@ -35,5 +38,8 @@ namespace BidCoS
 	BidCoS* GD::family = nullptr;
 	std::shared_ptr<Systems::FamilySettings> GD::settings;
     std::shared_ptr<Interfaces> GD::interfaces;
+	std::shared_ptr<BidCoSSendExecutor> GD::sendExecutor;
+	std::shared_ptr<BidCoSVariableJournal> GD::variableJournal;
+	std::shared_ptr<BidCoSLatencyStatistics> GD::latencyStatistics;
 	BaseLib::Output GD::out;
 }
@@ -38,6 +38,9 @@
 
 namespace BidCoS
 {
+class BidCoSLatencyStatistics;
+class BidCoSSendExecutor;
+class BidCoSVariableJournal;
 
 class GD
 {
@@ -48,6 +51,9 @@ public:
 	static BidCoS* family;
 	static std::shared_ptr<Systems::FamilySettings> settings;
     static std::shared_ptr<Interfaces> interfaces;
+	static std::shared_ptr<BidCoSSendExecutor> sendExecutor;
+	static std::shared_ptr<BidCoSVariableJournal> variableJournal;
+	static std::shared_ptr<BidCoSLatencyStatistics> latencyStatistics;
 	static BaseLib::Output out;
 private:
 	GD();
@@ -28,7 +28,10 @@
  */
 
 #include "HomeMaticCentral.h"
+#include "BidCoSLatencyStatistics.h"
 #include "PendingBidCoSQueues.h"
+#include "BidCoSVariableJournal.h"
+#include "PhysicalInterfaces/PeerProvisioner.h"
 #include <homegear-base/BaseLib.h>
 #include "GD.h"
 #include "VirtualPeers/HmCcTc.h"
@@ -71,6 +74,9 @@ void HomeMaticCentral::dispose(bool wait)
 		_receivedPackets.dispose(false);
 		_sentPackets.dispose(false);
 
+		//Write buffered values while the peers are still available.
+		if(_parameterWriter) _parameterWriter->dispose();
+
 		_peersMutex.lock();
 		for(std::map<uint64_t, std::shared_ptr<BaseLib::Systems::Peer>>::const_iterator i = _peersById.begin(); i != _peersById.end(); ++i)
 		{
@@ -120,6 +126,8 @@ void HomeMaticCentral::stopThreads()
 		_stopWorkerThread = true;
 		GD::out.printDebug("Debug: Waiting for worker thread of device " + std::to_string(_deviceId) + "...");
 		_bl->threadManager.join(_workerThread);
+		if(_receivePipeline) _receivePipeline->dispose();
+		if(_peerScheduler) _peerScheduler->dispose();
 	}
     catch(const std::exception& ex)
     {
@@ -142,6 +150,19 @@ void HomeMaticCentral::init()
 		_messages = std::shared_ptr<BidCoSMessages>(new BidCoSMessages());
 		_messageCounter[0] = 0; //Broadcast message counter
 
+		int32_t parameterWriteInterval = GD::settings->getNumber("parameterwriteinterval");
+		if(parameterWriteInterval <= 0) parameterWriteInterval = 1000;
+		int32_t parameterWriteBufferSize = GD::settings->getNumber("parameterwritebuffersize");
+		if(parameterWriteBufferSize <= 0) parameterWriteBufferSize = 500;
+		//0 disables the receive pipeline, so the setting only defaults to 4 when it is missing.
+		int32_t receiveWorkerThreads = GD::settings->getString("receiveworkerthreads").empty() ? 4 : GD::settings->getNumber("receiveworkerthreads");
+		int32_t receiveQueueSize = GD::settings->getNumber("receivequeuesize");
+		if(receiveQueueSize <= 0) receiveQueueSize = 1000;
+		if(receiveWorkerThreads > 0) _receivePipeline.reset(new BidCoSReceivePipeline(receiveWorkerThreads, receiveQueueSize, std::bind(&HomeMaticCentral::processReceivedPacket, this, std::placeholders::_1, std::placeholders::_2)));
+		_peerScheduler.reset(new BidCoSPeerScheduler(std::bind(&HomeMaticCentral::runPeerHousekeeping, this, std::placeholders::_1), std::bind(&HomeMaticCentral::runPeerReset, this, std::placeholders::_1)));
+		_localRpcMethods.emplace("getLatencyStatistics", std::bind(&HomeMaticCentral::getLatencyStatistics, this, std::placeholders::_1, std::placeholders::_2));
+		_parameterWriter.reset(new BidCoSParameterWriter(this, BidCoSParameterWriter::parseDurability(GD::settings->getString("parameterwritedurability")), parameterWriteInterval, parameterWriteBufferSize));
+
 		setUpBidCoSMessages();
 
         GD::interfaces->addEventHandlers((BaseLib::Systems::IPhysicalInterface::IPhysicalInterfaceEventSink*)this);
@@ -172,70 +193,170 @@ void HomeMaticCentral::setUpBidCoSMessages()
     }
 }
 
+std::shared_ptr<BidCoSPeer> HomeMaticCentral::loadPeer(BaseLib::Database::DataTable::iterator& row)
+{
+	try
+	{
+		int32_t peerId = row->second.at(0)->intValue;
+		GD::out.printMessage("Loading peer " + std::to_string(peerId));
+		int32_t address = row->second.at(2)->intValue;
+		std::string serialNumber = row->second.at(3)->textValue;
+		std::shared_ptr<BidCoSPeer> peer;
+		if(serialNumber.substr(0, 3) == "VCD")
+		{
+			if(row->second.at(4)->intValue == (uint32_t)DeviceType::HMCCTC)
+			{
+				GD::out.printMessage("Peer is virtual.");
+				peer.reset(new HmCcTc(peerId, address, serialNumber, _deviceId, this));
+			}
+			else
+			{
+				GD::out.printError("Error: Unknown virtual HM-CC-TC: 0x" + BaseLib::HelperFunctions::getHexString(row->second.at(4)->intValue));
+				return std::shared_ptr<BidCoSPeer>();
+			}
+		}
+		else peer.reset(new BidCoSPeer(peerId, address, row->second.at(3)->textValue, _deviceId, this));
+		if(!peer->load(this)) return std::shared_ptr<BidCoSPeer>();
+		if(!peer->getRpcDevice()) return std::shared_ptr<BidCoSPeer>();
+		return peer;
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    return std::shared_ptr<BidCoSPeer>();
+}
+
+void HomeMaticCentral::loadPeersWorker(std::shared_ptr<PeerLoadBatch> batch)
+{
+	try
+	{
+		for(uint32_t index = batch->nextRow++; index < batch->rows.size(); index = batch->nextRow++)
+		{
+			batch->peers.at(index) = loadPeer(batch->rows.at(index));
+		}
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+}
+
 void HomeMaticCentral::loadPeers()
 {
 	try
 	{
+		int64_t startTime = BaseLib::HelperFunctions::getTime();
 		std::shared_ptr<BaseLib::Database::DataTable> rows = _bl->db->getPeers(_deviceId);
-		for(BaseLib::Database::DataTable::iterator row = rows->begin(); row != rows->end(); ++row)
-		{
-			int32_t peerId = row->second.at(0)->intValue;
-			GD::out.printMessage("Loading peer " + std::to_string(peerId));
-			int32_t address = row->second.at(2)->intValue;
-			std::string serialNumber = row->second.at(3)->textValue;
-			std::shared_ptr<BidCoSPeer> peer;
-			if(serialNumber.substr(0, 3) == "VCD")
+		int64_t queryTime = BaseLib::HelperFunctions::getTime();
+
+		// {{{ Load phase: Create the peers and load their variables, configuration and device descriptions in parallel
+			auto batch = std::make_shared<PeerLoadBatch>();
+			batch->rows.reserve(rows->size());
+			for(BaseLib::Database::DataTable::iterator row = rows->begin(); row != rows->end(); ++row)
+			{
+				batch->rows.push_back(row);
+			}
+			batch->peers.resize(batch->rows.size());
+
+			int32_t peerLoadThreads = GD::settings->getNumber("peerloadthreads");
+			if(peerLoadThreads <= 0) peerLoadThreads = 4;
+			if((uint32_t)peerLoadThreads > batch->rows.size()) peerLoadThreads = batch->rows.size();
+			//The current thread loads peers, too. So all peers are loaded even if no thread could be started.
+			std::vector<std::thread> loadThreads(peerLoadThreads > 1 ? peerLoadThreads - 1 : 0);
+			for(auto& loadThread : loadThreads)
 			{
-				if(row->second.at(4)->intValue == (uint32_t)DeviceType::HMCCTC)
+				try
 				{
-					GD::out.printMessage("Peer is virtual.");
-					peer.reset(new HmCcTc(peerId, address, serialNumber, _deviceId, this));
+					_bl->threadManager.start(loadThread, true, &HomeMaticCentral::loadPeersWorker, this, batch);
 				}
-				else
+				catch(const std::exception& ex)
 				{
-					GD::out.printError("Error: Unknown virtual HM-CC-TC: 0x" + BaseLib::HelperFunctions::getHexString(row->second.at(4)->intValue));
-					continue;
+					GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
 				}
 			}
-			else peer.reset(new BidCoSPeer(peerId, address, row->second.at(3)->textValue, _deviceId, this));
-			if(!peer->load(this)) continue;
-			PHomegearDevice rpcDevice = peer->getRpcDevice();
-			if(!rpcDevice) continue;
-			_peersMutex.lock();
-			if(peer->getAddress() != _address) _peers[peer->getAddress()] = peer;
-			if(!peer->getSerialNumber().empty()) _peersBySerial[peer->getSerialNumber()] = peer;
-			_peersById[peerId] = peer;
-			_peersMutex.unlock();
-			peer->getPhysicalInterface()->addPeer(peer->getPeerInfo());
-			if(!peer->getTeamRemoteSerialNumber().empty())
+			loadPeersWorker(batch);
+			for(auto& loadThread : loadThreads)
 			{
-				_peersMutex.lock();
-				if(_peersBySerial.find(peer->getTeamRemoteSerialNumber()) == _peersBySerial.end())
+				_bl->threadManager.join(loadThread);
+			}
+		// }}}
+		int64_t loadTime = BaseLib::HelperFunctions::getTime();
+
+		// {{{ Insert phase: Add the peers to the peer maps in database order
+			std::map<std::string, std::pair<std::shared_ptr<IBidCoSInterface>, std::vector<IBidCoSInterface::PeerInfo>>> peerInfos;
+			uint32_t loadedPeers = 0;
+			for(auto& peer : batch->peers)
+			{
+				if(!peer) continue;
+				loadedPeers++;
+				uint64_t peerId = peer->getID();
+				PHomegearDevice rpcDevice = peer->getRpcDevice();
 				{
-					std::shared_ptr<BidCoSPeer> team = createTeam(peer->getTeamRemoteAddress(), peer->getDeviceType(), peer->getTeamRemoteSerialNumber());
-					team->setRpcDevice(rpcDevice->group);
-					team->initializeCentralConfig();
-					team->setID(peer->getID() | (1 << 30));
-					team->setInterface(nullptr, peer->getPhysicalInterfaceID());
-					_peersBySerial[team->getSerialNumber()] = team;
-					_peersById[team->getID()] = team;
+					std::lock_guard<std::mutex> peersGuard(_peersMutex);
+					if(peer->getAddress() != _address)
+					{
+						_peers[peer->getAddress()] = peer;
+						_peerIndex.addByAddress(peer->getAddress(), peer);
+					}
+					if(!peer->getSerialNumber().empty())
+					{
+						_peersBySerial[peer->getSerialNumber()] = peer;
+						_peerIndex.addBySerial(peer->getSerialNumber(), peer);
+					}
+					_peersById[peerId] = peer;
+					_peerIndex.addById(peerId, peer);
+					if(_peerScheduler) _peerScheduler->schedule(peerId, BaseLib::HelperFunctions::getTime());
+					peer->scheduleVariablesToReset(_peerScheduler.get());
 				}
-				_peersMutex.unlock();
-				for(Functions::iterator i = rpcDevice->functions.begin(); i != rpcDevice->functions.end(); ++i)
+				std::shared_ptr<IBidCoSInterface> physicalInterface = peer->getPhysicalInterface();
+				auto& interfacePeerInfos = peerInfos[physicalInterface->getID()];
+				interfacePeerInfos.first = physicalInterface;
+				interfacePeerInfos.second.push_back(peer->getPeerInfo());
+				if(!peer->getTeamRemoteSerialNumber().empty())
 				{
-					if(i->second->hasGroup)
 					{
-						getPeer(peer->getTeamRemoteSerialNumber())->teamChannels.push_back(std::pair<std::string, uint32_t>(peer->getSerialNumber(), peer->getTeamRemoteChannel()));
-						break;
+						std::lock_guard<std::mutex> peersGuard(_peersMutex);
+						if(_peersBySerial.find(peer->getTeamRemoteSerialNumber()) == _peersBySerial.end())
+						{
+							std::shared_ptr<BidCoSPeer> team = createTeam(peer->getTeamRemoteAddress(), peer->getDeviceType(), peer->getTeamRemoteSerialNumber());
+							team->setRpcDevice(rpcDevice->group);
+							team->initializeCentralConfig();
+							team->setID(peer->getID() | (1 << 30));
+							team->setInterface(nullptr, peer->getPhysicalInterfaceID());
+							_peersBySerial[team->getSerialNumber()] = team;
+							_peersById[team->getID()] = team;
+							_peerIndex.addBySerial(team->getSerialNumber(), team);
+							_peerIndex.addById(team->getID(), team);
+							if(_peerScheduler) _peerScheduler->schedule(team->getID(), BaseLib::HelperFunctions::getTime());
+						}
+					}
+					for(Functions::iterator i = rpcDevice->functions.begin(); i != rpcDevice->functions.end(); ++i)
+					{
+						if(i->second->hasGroup)
+						{
+							getPeer(peer->getTeamRemoteSerialNumber())->teamChannels.push_back(std::pair<std::string, uint32_t>(peer->getSerialNumber(), peer->getTeamRemoteChannel()));
+							break;
+						}
 					}
 				}
 			}
-		}
+		// }}}
+		int64_t insertTime = BaseLib::HelperFunctions::getTime();
+
+		// {{{ Interface phase: Pass the peers to each interface at once
+			for(auto& interfacePeerInfos : peerInfos)
+			{
+				interfacePeerInfos.second.first->addPeers(interfacePeerInfos.second.second);
+			}
+		// }}}
+		int64_t endTime = BaseLib::HelperFunctions::getTime();
+
+		GD::out.printInfo("Info: Loaded " + std::to_string(loadedPeers) + " of " + std::to_string(batch->rows.size()) + " peers in " + std::to_string(endTime - startTime) + " ms using " + std::to_string(loadThreads.size() + 1) + " threads (query: " + std::to_string(queryTime - startTime) + " ms, load: " + std::to_string(loadTime - queryTime) + " ms, insert: " + std::to_string(insertTime - loadTime) + " ms, interfaces: " + std::to_string(endTime - insertTime) + " ms).");
 	}
 	catch(const std::exception& ex)
     {
     	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-    	_peersMutex.unlock();
     }
 }
 
@@ -355,19 +476,12 @@ std::shared_ptr<BidCoSPeer> HomeMaticCentral::getPeer(int32_t address)
 {
 	try
 	{
-		_peersMutex.lock();
-		if(_peers.find(address) != _peers.end())
-		{
-			std::shared_ptr<BidCoSPeer> peer(std::dynamic_pointer_cast<BidCoSPeer>(_peers.at(address)));
-			_peersMutex.unlock();
-			return peer;
-		}
+		return _peerIndex.getByAddress(address);
 	}
 	catch(const std::exception& ex)
     {
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
-    _peersMutex.unlock();
     return std::shared_ptr<BidCoSPeer>();
 }
 
@@ -375,19 +489,12 @@ std::shared_ptr<BidCoSPeer> HomeMaticCentral::getPeer(uint64_t id)
 {
 	try
 	{
-		_peersMutex.lock();
-		if(_peersById.find(id) != _peersById.end())
-		{
-			std::shared_ptr<BidCoSPeer> peer(std::dynamic_pointer_cast<BidCoSPeer>(_peersById.at(id)));
-			_peersMutex.unlock();
-			return peer;
-		}
+		return _peerIndex.getById(id);
 	}
 	catch(const std::exception& ex)
     {
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
-    _peersMutex.unlock();
     return std::shared_ptr<BidCoSPeer>();
 }
 
@@ -395,19 +502,12 @@ std::shared_ptr<BidCoSPeer> HomeMaticCentral::getPeer(std::string serialNumber)
 {
 	try
 	{
-		_peersMutex.lock();
-		if(_peersBySerial.find(serialNumber) != _peersBySerial.end())
-		{
-			std::shared_ptr<BidCoSPeer> peer(std::dynamic_pointer_cast<BidCoSPeer>(_peersBySerial.at(serialNumber)));
-			_peersMutex.unlock();
-			return peer;
-		}
+		return _peerIndex.getBySerial(serialNumber);
 	}
 	catch(const std::exception& ex)
     {
         GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
-    _peersMutex.unlock();
     return std::shared_ptr<BidCoSPeer>();
 }
 
@@ -533,6 +633,35 @@ bool HomeMaticCentral::isDimmer(uint32_t type)
 }
 
 
+int64_t HomeMaticCentral::runPeerHousekeeping(uint64_t peerId)
+{
+	try
+	{
+		std::shared_ptr<BidCoSPeer> peer(getPeer(peerId));
+		if(!peer || peer->deleting) return 0;
+		peer->worker();
+		return peer->getNextWorkerTime();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return BaseLib::HelperFunctions::getTime() + 10000;
+}
+
+void HomeMaticCentral::runPeerReset(const BidCoSPeerScheduler::ResetToken& token)
+{
+	try
+	{
+		std::shared_ptr<BidCoSPeer> peer(getPeer(token.peerId));
+		if(peer) peer->resetVariable(token.channel, token.symbol, token.generation);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
 void HomeMaticCentral::worker()
 {
 	try
@@ -542,10 +671,8 @@ void HomeMaticCentral::worker()
 			std::this_thread::sleep_for(std::chrono::seconds(1));
 		}
 
-		std::chrono::milliseconds sleepingTime(10);
-		uint32_t counter = 0;
-		uint64_t lastPeer = 0;
-		//One loop on the Raspberry Pi takes about 30Âµs
+		//The housekeeping of the peers is done by "_peerScheduler".
+		std::chrono::milliseconds sleepingTime(100);
 		while(!_stopWorkerThread)
 		{
 			try
@@ -566,42 +693,10 @@ void HomeMaticCentral::worker()
 
 				std::this_thread::sleep_for(sleepingTime);
 				if(_stopWorkerThread) return;
-				if(counter > 10000)
-				{
-					counter = 0;
-					_peersMutex.lock();
-					if(_peersById.size() > 0)
-					{
-						int32_t windowTimePerPeer = _bl->settings.workerThreadWindow() / _peersById.size();
-						if(windowTimePerPeer > 2) windowTimePerPeer -= 2;
-						sleepingTime = std::chrono::milliseconds(windowTimePerPeer);
-					}
-					_peersMutex.unlock();
-				}
-				_peersMutex.lock();
-				if(!_peersById.empty())
-				{
-					if(!_peersById.empty())
-					{
-						std::map<uint64_t, std::shared_ptr<BaseLib::Systems::Peer>>::iterator nextPeer = _peersById.find(lastPeer);
-						if(nextPeer != _peersById.end())
-						{
-							nextPeer++;
-							if(nextPeer == _peersById.end()) nextPeer = _peersById.begin();
-						}
-						else nextPeer = _peersById.begin();
-						lastPeer = nextPeer->first;
-					}
-				}
-				_peersMutex.unlock();
-				std::shared_ptr<BidCoSPeer> peer(getPeer(lastPeer));
-				if(peer && !peer->deleting) peer->worker();
                 GD::interfaces->worker();
-				counter++;
 			}
 			catch(const std::exception& ex)
 			{
-				_peersMutex.unlock();
 				GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
 			}
 		}
@@ -620,9 +715,33 @@ bool HomeMaticCentral::onPacketReceived(std::string& senderId, std::shared_ptr<B
 	{
 		if(_disposing) return false;
 		std::shared_ptr<BidCoSPacket> bidCoSPacket(std::dynamic_pointer_cast<BidCoSPacket>(packet));
+		if(!bidCoSPacket) return false;
+		if(GD::latencyStatistics) GD::latencyStatistics->recordSince(senderId, BidCoSLatencyStatistics::Stage::dispatch, bidCoSPacket->monotonicTimeReceived());
+		if(_receivePipeline)
+		{
+			//Packets of a team are passed to all team members, so all members need to be processed by the same worker.
+			int32_t partitionKey = bidCoSPacket->senderAddress();
+			std::shared_ptr<BidCoSPeer> peer(getPeer(partitionKey));
+			if(peer && peer->hasTeam()) partitionKey = peer->getTeamRemoteAddress();
+			if(_receivePipeline->post(partitionKey, senderId, bidCoSPacket)) return true;
+		}
+		return processReceivedPacket(senderId, bidCoSPacket);
+	}
+	catch(const std::exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    return false;
+}
+
+bool HomeMaticCentral::processReceivedPacket(std::string& senderId, std::shared_ptr<BidCoSPacket> bidCoSPacket)
+{
+	try
+	{
+		if(_disposing) return false;
+		if(GD::latencyStatistics) GD::latencyStatistics->recordSince(senderId, BidCoSLatencyStatistics::Stage::processingStart, bidCoSPacket->monotonicTimeReceived());
 		if(BaseLib::HelperFunctions::getTime() > bidCoSPacket->getTimeReceived() + 5000) GD::out.printError("Error: Packet was processed more than 5 seconds after reception. If your CPU and network load is low, please report this to the Homegear developers.");
 		if(_bl->debugLevel >= 4) GD::out.printInfo("Info: " + BaseLib::HelperFunctions::getTimeString(bidCoSPacket->getTimeReceived()) + " Packet received (" + senderId + (bidCoSPacket->rssiDevice() ? std::string(", RSSI: -") + std::to_string((int32_t)(bidCoSPacket->rssiDevice())) + " dBm" : "") + "): " + bidCoSPacket->hexString());
-		if(!bidCoSPacket) return false;
 
 		// {{{ Intercept packet
 		/*if(bidCoSPacket->senderAddress() == 0x19A4E0 && bidCoSPacket->messageType() == 0x41)
@@ -688,7 +807,9 @@ bool HomeMaticCentral::onPacketReceived(std::string& senderId, std::shared_ptr<B
 				if(message && message->checkAccess(bidCoSPacket, queue))
 				{
 					if(_bl->debugLevel >= 6) GD::out.printDebug("Debug: Device " + std::to_string(_deviceId) + ": Access granted for packet " + bidCoSPacket->hexString());
+					int64_t messageHandlerStartTime = BidCoSLatencyStatistics::now();
 					message->invokeMessageHandler(senderId, bidCoSPacket);
+					if(GD::latencyStatistics) GD::latencyStatistics->recordSince(senderId, BidCoSLatencyStatistics::Stage::messageHandler, messageHandlerStartTime);
 					handled = true;
 				}
 			}
@@ -710,6 +831,7 @@ bool HomeMaticCentral::onPacketReceived(std::string& senderId, std::shared_ptr<B
 			}
 		}
 		if(_bl->settings.devLog()) _bl->out.printMessage("Devlog (" + senderId + "): Packet " + bidCoSPacket->hexString() + " is now passed to the peer.");
+		int64_t peerDecodeStartTime = BidCoSLatencyStatistics::now();
 		if(team)
 		{
 			team->packetReceived(bidCoSPacket);
@@ -719,6 +841,11 @@ bool HomeMaticCentral::onPacketReceived(std::string& senderId, std::shared_ptr<B
 			}
 		}
 		else peer->packetReceived(bidCoSPacket);
+		if(GD::latencyStatistics)
+		{
+			GD::latencyStatistics->recordSince(senderId, BidCoSLatencyStatistics::Stage::peerDecode, peerDecodeStartTime);
+			GD::latencyStatistics->recordSince(senderId, BidCoSLatencyStatistics::Stage::total, bidCoSPacket->monotonicTimeReceived());
+		}
 	}
 	catch(const std::exception& ex)
     {
@@ -1007,6 +1134,8 @@ std::string HomeMaticCentral::handleCliCommand(std::string command)
 			stringStream << "peers unpair (pup) Unpair a peer" << std::endl;
 			stringStream << "peers update (pud) Updates a peer to the newest firmware version" << std::endl;
 			stringStream << "comm reopen (cr)   Reopen communication interface" << std::endl;
+			stringStream << "comm stats (cs)    Show statistics of the communication interfaces" << std::endl;
+			stringStream << "latency stats (lat) Show latencies of the stages of received packets" << std::endl;
 			stringStream << "unselect (u)\t\tUnselect this device" << std::endl;
 			return stringStream.str();
 		}
@@ -1120,13 +1249,23 @@ std::string HomeMaticCentral::handleCliCommand(std::string command)
 				try
 				{
 					_peersMutex.lock();
-					if(peer->getAddress() != _address) _peers[peer->getAddress()] = peer;
-					if(!peer->getSerialNumber().empty()) _peersBySerial[peer->getSerialNumber()] = peer;
+					if(peer->getAddress() != _address)
+					{
+						_peers[peer->getAddress()] = peer;
+						_peerIndex.addByAddress(peer->getAddress(), peer);
+					}
+					if(!peer->getSerialNumber().empty())
+					{
+						_peersBySerial[peer->getSerialNumber()] = peer;
+						_peerIndex.addBySerial(peer->getSerialNumber(), peer);
+					}
 					_peersMutex.unlock();
 					peer->save(true, true, false);
 					peer->initializeCentralConfig();
 					_peersMutex.lock();
 					_peersById[peer->getID()] = peer;
+					_peerIndex.addById(peer->getID(), peer);
+					if(_peerScheduler) _peerScheduler->schedule(peer->getID(), BaseLib::HelperFunctions::getTime());
 					_peersMutex.unlock();
 				}
 				catch(const std::exception& ex)
@@ -1584,6 +1723,153 @@ std::string HomeMaticCentral::handleCliCommand(std::string command)
             interface->startListening();
             stringStream << "Interface successfully reopened." << std::endl;
             return stringStream.str();
+        }
+        else if(BaseLib::HelperFunctions::checkCliCommand(command, "comm stats", "cs", "", 0, arguments, showHelp))
+        {
+            if(showHelp)
+            {
+                stringStream << "Description: This command shows statistics of the communication interfaces." << std::endl;
+                stringStream << "Usage: comm stats [ID]" << std::endl << std::endl;
+                stringStream << "Parameters:" << std::endl;
+                stringStream << "  ID: Optional ID of the interface to show statistics for. Statistics not belonging to an interface are only shown without ID." << std::endl;
+                return stringStream.str();
+            }
+
+            auto interfaces = GD::interfaces->getInterfaces();
+            for(auto& interface : interfaces)
+            {
+                if(!arguments.empty() && interface->getID() != arguments.at(0)) continue;
+                auto& packetPool = interface->getPacketPool();
+                stringStream << interface->getID() << ":" << std::endl;
+                stringStream << "  Packet pool hits:        " << packetPool.hits() << std::endl;
+                stringStream << "  Packet pool misses:      " << packetPool.misses() << std::endl;
+                stringStream << "  Packet pool free blocks: " << packetPool.freeBlocks() << std::endl;
+                auto airtime = interface->getAirtimeScheduler().getStatistics();
+                stringStream << "  Airtime used:            " << airtime.used << " ms of " << airtime.budget << " ms" << std::endl;
+                stringStream << "  Airtime remaining:       " << airtime.remaining << " ms" << std::endl;
+                stringStream << "  Load hint:               " << (airtime.loadHint == AirtimeScheduler::LoadHint::overload ? "overload" : (airtime.loadHint == AirtimeScheduler::LoadHint::highLoad ? "high load" : "none")) << std::endl;
+                stringStream << "  Backlog (ACK/AES):       " << airtime.backlog.at((int32_t)AirtimeScheduler::TrafficClass::acknowledgement) << std::endl;
+                stringStream << "  Backlog (interactive):   " << airtime.backlog.at((int32_t)AirtimeScheduler::TrafficClass::interactive) << std::endl;
+                stringStream << "  Backlog (config):        " << airtime.backlog.at((int32_t)AirtimeScheduler::TrafficClass::bulk) << std::endl;
+                stringStream << "  Frames sent:             " << airtime.frames << std::endl;
+                stringStream << "  Deferred frames:         " << airtime.deferredFrames << std::endl;
+                auto peerProvisioner = interface->getPeerProvisioner();
+                if(peerProvisioner)
+                {
+                    auto provisioning = peerProvisioner->getStatistics();
+                    stringStream << "  Peer provisioning:       " << (provisioning.running ? "running" : "finished") << ", " << (provisioning.completedPeers + provisioning.skippedPeers + provisioning.failedPeers) << " of " << provisioning.peers << " peers" << std::endl;
+                    stringStream << "    Sent peers:            " << provisioning.completedPeers << std::endl;
+                    stringStream << "    Unchanged peers:       " << provisioning.skippedPeers << std::endl;
+                    stringStream << "    Failed peers:          " << provisioning.failedPeers << std::endl;
+                    stringStream << "    Commands (retries):    " << provisioning.commands << " (" << provisioning.retries << ")" << std::endl;
+                    stringStream << "    Duration:              " << provisioning.duration << " ms" << std::endl;
+                    stringStream << "    Peer list hash:        " << BaseLib::HelperFunctions::getHexString((int32_t)(provisioning.peerListHash >> 32), 8) << BaseLib::HelperFunctions::getHexString((int32_t)(provisioning.peerListHash & 0xFFFFFFFF), 8) << std::endl;
+                }
+            }
+            if(arguments.empty() && GD::sendExecutor)
+            {
+                auto statistics = GD::sendExecutor->getStatistics();
+                stringStream << "Send executor:" << std::endl;
+                stringStream << "  Threads (busy):          " << statistics.threadCount << " (" << statistics.busyThreads << ")" << std::endl;
+                stringStream << "  Queued tasks:            " << statistics.queueDepth << std::endl;
+                stringStream << "  Max. queued tasks:       " << statistics.maxQueueDepth << std::endl;
+                stringStream << "  Executed tasks:          " << statistics.executedTasks << std::endl;
+                stringStream << "  Avg. task latency:       " << statistics.averageLatency << " us" << std::endl;
+                stringStream << "  Max. task latency:       " << statistics.maxLatency << " us" << std::endl;
+            }
+            if(arguments.empty())
+            {
+                stringStream << "Receive pipeline:" << std::endl;
+                if(!_receivePipeline) stringStream << "  Disabled (packets are processed by the interfaces' threads)" << std::endl;
+                else
+                {
+                    auto statistics = _receivePipeline->getStatistics();
+                    for(uint32_t i = 0; i < statistics.size(); i++)
+                    {
+                        stringStream << "  Worker " << i << ":                " << (i < 10 ? " " : "") << statistics[i].processedPackets  << " packets, queue " << statistics[i].queueDepth << " (max " << statistics[i].maxQueueDepth << ", " << statistics[i].droppedPackets << " dropped), " << statistics[i].averageProcessingTime << " us average, " << statistics[i].maxProcessingTime << " us max" << std::endl;
+                    }
+                }
+            }
+            if(arguments.empty() && _peerScheduler)
+            {
+                auto statistics = _peerScheduler->getStatistics();
+                stringStream << "Peer scheduler:" << std::endl;
+                stringStream << "  Scheduled peers:         " << statistics.scheduledPeers << std::endl;
+                stringStream << "  Fired deadlines:         " << statistics.firedDeadlines << std::endl;
+                stringStream << "  Pending resets:          " << statistics.pendingResets << std::endl;
+                stringStream << "  Fired resets:            " << statistics.firedResets << std::endl;
+                stringStream << "  Missed deadlines:        " << statistics.missedDeadlines << std::endl;
+                stringStream << "  Delay:                   " << statistics.averageDelay << " ms average, " << statistics.maxDelay << " ms max" << std::endl;
+            }
+            if(arguments.empty() && _parameterWriter)
+            {
+                auto statistics = _parameterWriter->getStatistics();
+                stringStream << "Parameter writer:" << std::endl;
+                stringStream << "  Durability:              " << (statistics.durability == BidCoSParameterWriter::Durability::immediate ? "immediate" : "buffered") << std::endl;
+                stringStream << "  Buffered writes:         " << statistics.bufferedWrites << std::endl;
+                stringStream << "  Coalesced writes:        " << statistics.coalescedWrites << std::endl;
+                stringStream << "  Pending parameters:      " << statistics.pendingParameters << std::endl;
+                stringStream << "  Written parameters:      " << statistics.writtenParameters << std::endl;
+                stringStream << "  Flushes:                 " << statistics.flushes << " (" << statistics.fullBufferFlushes << " on full buffer)" << std::endl;
+                stringStream << "  Flush latency:           " << statistics.lastFlushLatency << " ms last, " << statistics.averageFlushLatency << " ms average, " << statistics.maxFlushLatency << " ms max" << std::endl;
+                stringStream << "  Last flush duration:     " << statistics.lastFlushDuration << " ms" << std::endl;
+            }
+            if(arguments.empty() && GD::variableJournal)
+            {
+                auto statistics = GD::variableJournal->getStatistics();
+                stringStream << "Variable journal:" << std::endl;
+                stringStream << "  Appended entries:        " << statistics.appendedEntries << std::endl;
+                stringStream << "  Pending entries:         " << statistics.pendingEntries << std::endl;
+                stringStream << "  Written variables:       " << statistics.writtenVariables << std::endl;
+                stringStream << "  Flushes:                 " << statistics.flushes << std::endl;
+            }
+            if(arguments.empty())
+            {
+                auto statistics = _bidCoSQueueManager.getReaperStatistics();
+                stringStream << "Queue reaper:" << std::endl;
+                stringStream << "  Scheduled checks:        " << statistics.scheduledChecks << std::endl;
+                stringStream << "  Resets:                  " << statistics.resets << std::endl;
+                stringStream << "  Avg. lag:                " << statistics.averageLag << " ms" << std::endl;
+                stringStream << "  Max. lag:                " << statistics.maxLag << " ms" << std::endl;
+            }
+            return stringStream.str();
+        }
+        else if(BaseLib::HelperFunctions::checkCliCommand(command, "latency stats", "lat", "", 0, arguments, showHelp))
+        {
+            if(showHelp)
+            {
+                stringStream << "Description: This command shows the latencies of the stages received packets pass. All times are in microseconds." << std::endl;
+                stringStream << "Usage: latency stats [ID] [reset]" << std::endl << std::endl;
+                stringStream << "Parameters:" << std::endl;
+                stringStream << "  ID:    Optional ID of the interface to show latencies for." << std::endl;
+                stringStream << "  reset: Clears the latencies after showing them." << std::endl;
+                return stringStream.str();
+            }
+            if(!GD::latencyStatistics) return "Latency statistics are not available.\n";
+
+            bool reset = !arguments.empty() && arguments.back() == "reset";
+            std::string interfaceId = (!arguments.empty() && arguments.front() != "reset") ? arguments.front() : "";
+            auto statistics = GD::latencyStatistics->getStatistics(interfaceId);
+            if(statistics.empty()) stringStream << "No latencies recorded." << std::endl;
+            std::string currentInterfaceId;
+            for(auto& stageStatistics : statistics)
+            {
+                if(stageStatistics.interfaceId != currentInterfaceId)
+                {
+                    currentInterfaceId = stageStatistics.interfaceId;
+                    stringStream << currentInterfaceId << ":" << std::endl;
+                    stringStream << "  Stage              Count       Avg       p50       p90       p99       Max" << std::endl;
+                }
+                auto& snapshot = stageStatistics.snapshot;
+                stringStream << "  " << std::setw(17) << std::left << BidCoSLatencyStatistics::getStageName(stageStatistics.stage) << std::right;
+                stringStream << std::setw(7) << snapshot.count << std::setw(10) << snapshot.average << std::setw(10) << snapshot.p50 << std::setw(10) << snapshot.p90 << std::setw(10) << snapshot.p99 << std::setw(10) << snapshot.max << std::endl;
+            }
+            if(reset)
+            {
+                GD::latencyStatistics->reset();
+                stringStream << "Latencies were cleared." << std::endl;
+            }
+            return stringStream.str();
         }
 		else return "Unknown command.\n";
 	}
@@ -2079,12 +2365,18 @@ void HomeMaticCentral::addHomegearFeaturesHMCCVD(std::shared_ptr<BidCoSPeer> pee
 			try
 			{
 				_peersMutex.lock();
-				if(!tc->getSerialNumber().empty()) _peersBySerial[tc->getSerialNumber()] = tc;
+				if(!tc->getSerialNumber().empty())
+				{
+					_peersBySerial[tc->getSerialNumber()] = tc;
+					_peerIndex.addBySerial(tc->getSerialNumber(), tc);
+				}
 				_peersMutex.unlock();
 				tc->save(true, true, false);
 				tc->initializeCentralConfig();
 				_peersMutex.lock();
 				_peersById[tc->getID()] = tc;
+				_peerIndex.addById(tc->getID(), tc);
+				if(_peerScheduler) _peerScheduler->schedule(tc->getID(), BaseLib::HelperFunctions::getTime());
 				_peersMutex.unlock();
 			}
 			catch(const std::exception& ex)
@@ -2505,6 +2797,10 @@ void HomeMaticCentral::deletePeer(uint64_t id)
 			if(_peersBySerial.find(peer->getSerialNumber()) != _peersBySerial.end()) _peersBySerial.erase(peer->getSerialNumber());
 			if(_peersById.find(id) != _peersById.end()) _peersById.erase(id);
 			if(_peers.find(peer->getAddress()) != _peers.end()) _peers.erase(peer->getAddress());
+			_peerIndex.removeBySerial(peer->getSerialNumber());
+			_peerIndex.removeById(id);
+			if(_peerScheduler) _peerScheduler->remove(id);
+			_peerIndex.removeByAddress(peer->getAddress());
 		}
 
 		removePeerFromTeam(peer);
@@ -3268,6 +3564,9 @@ void HomeMaticCentral::resetTeam(std::shared_ptr<BidCoSPeer> peer, uint32_t chan
 			_peersMutex.lock();
 			_peersBySerial[team->getSerialNumber()] = team;
 			_peersById[team->getID()] = team;
+			_peerIndex.addBySerial(team->getSerialNumber(), team);
+			_peerIndex.addById(team->getID(), team);
+			if(_peerScheduler) _peerScheduler->schedule(team->getID(), BaseLib::HelperFunctions::getTime());
 			_peersMutex.unlock();
 			teamCreated = true;
 		}
@@ -3381,6 +3680,9 @@ void HomeMaticCentral::removePeerFromTeam(std::shared_ptr<BidCoSPeer> peer)
 			{
 				_peersBySerial.erase(oldTeam->getSerialNumber());
 				_peersById.erase(oldTeam->getID());
+				_peerIndex.removeBySerial(oldTeam->getSerialNumber());
+				_peerIndex.removeById(oldTeam->getID());
+				if(_peerScheduler) _peerScheduler->remove(oldTeam->getID());
 			}
 			catch(const std::exception& ex)
 			{
@@ -3450,12 +3752,19 @@ void HomeMaticCentral::handleAck(const std::string& interfaceId, int32_t message
 					{
 						_peersMutex.lock();
 						_peers[queue->peer->getAddress()] = queue->peer;
-						if(!queue->peer->getSerialNumber().empty()) _peersBySerial[queue->peer->getSerialNumber()] = queue->peer;
+						_peerIndex.addByAddress(queue->peer->getAddress(), queue->peer);
+						if(!queue->peer->getSerialNumber().empty())
+						{
+							_peersBySerial[queue->peer->getSerialNumber()] = queue->peer;
+							_peerIndex.addBySerial(queue->peer->getSerialNumber(), queue->peer);
+						}
 						_peersMutex.unlock();
 						queue->peer->save(true, true, false);
 						queue->peer->initializeCentralConfig();
 						_peersMutex.lock();
 						_peersById[queue->peer->getID()] = queue->peer;
+						_peerIndex.addById(queue->peer->getID(), queue->peer);
+						if(_peerScheduler) _peerScheduler->schedule(queue->peer->getID(), BaseLib::HelperFunctions::getTime());
 						_peersMutex.unlock();
 					}
 					catch(const std::exception& ex)
@@ -4120,6 +4429,50 @@ PVariable HomeMaticCentral::deleteDevice(BaseLib::PRpcClientInfo clientInfo, uin
     return Variable::createError(-32500, "Unknown application error.");
 }
 
+PVariable HomeMaticCentral::getLatencyStatistics(BaseLib::PRpcClientInfo clientInfo, BaseLib::PArray parameters)
+{
+	try
+	{
+		if(!GD::latencyStatistics) return Variable::createError(-32500, "Latency statistics are not available.");
+		std::string interfaceId;
+		bool reset = false;
+		if(parameters->size() > 2) return Variable::createError(-1, "Wrong parameter count.");
+		if(parameters->size() > 0)
+		{
+			if(parameters->at(0)->type != VariableType::tString) return Variable::createError(-1, "Parameter 1 is not of type String.");
+			interfaceId = parameters->at(0)->stringValue;
+		}
+		if(parameters->size() > 1)
+		{
+			if(parameters->at(1)->type != VariableType::tBoolean) return Variable::createError(-1, "Parameter 2 is not of type Boolean.");
+			reset = parameters->at(1)->booleanValue;
+		}
+
+		auto result = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+		auto statistics = GD::latencyStatistics->getStatistics(interfaceId);
+		for(auto& stageStatistics : statistics)
+		{
+			auto& interfaceStruct = result->structValue->operator[](stageStatistics.interfaceId);
+			if(!interfaceStruct) interfaceStruct = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+			auto stage = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+			stage->structValue->emplace("count", std::make_shared<BaseLib::Variable>((int64_t)stageStatistics.snapshot.count));
+			stage->structValue->emplace("average", std::make_shared<BaseLib::Variable>(stageStatistics.snapshot.average));
+			stage->structValue->emplace("p50", std::make_shared<BaseLib::Variable>(stageStatistics.snapshot.p50));
+			stage->structValue->emplace("p90", std::make_shared<BaseLib::Variable>(stageStatistics.snapshot.p90));
+			stage->structValue->emplace("p99", std::make_shared<BaseLib::Variable>(stageStatistics.snapshot.p99));
+			stage->structValue->emplace("max", std::make_shared<BaseLib::Variable>(stageStatistics.snapshot.max));
+			interfaceStruct->structValue->emplace(BidCoSLatencyStatistics::getStageName(stageStatistics.stage), stage);
+		}
+		if(reset) GD::latencyStatistics->reset();
+		return result;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return Variable::createError(-32500, "Unknown application error.");
+}
+
 PVariable HomeMaticCentral::getPairingState(BaseLib::PRpcClientInfo clientInfo)
 {
     try
@@ -4517,4 +4870,32 @@ PVariable HomeMaticCentral::setInterface(BaseLib::PRpcClientInfo clientInfo, uin
     return Variable::createError(-32500, "Unknown application error.");
 }
 
+PVariable HomeMaticCentral::setId(BaseLib::PRpcClientInfo clientInfo, uint64_t oldPeerId, uint64_t newPeerId)
+{
+	try
+	{
+		PVariable result = ICentral::setId(clientInfo, oldPeerId, newPeerId);
+		if(result->errorStruct) return result;
+
+		//"ICentral::setId" only updates "_peersById".
+		std::lock_guard<std::mutex> peersGuard(_peersMutex);
+		auto peerIterator = _peersById.find(newPeerId);
+		if(peerIterator == _peersById.end()) return result;
+		std::shared_ptr<BidCoSPeer> peer(std::dynamic_pointer_cast<BidCoSPeer>(peerIterator->second));
+		if(!peer) return result;
+		_peerIndex.removeById(oldPeerId);
+		_peerIndex.addById(newPeerId, peer);
+		if(_peerScheduler)
+		{
+			_peerScheduler->remove(oldPeerId);
+			_peerScheduler->schedule(newPeerId, BaseLib::HelperFunctions::getTime());
+		}
+		return result;
+	}
+	catch(const std::exception& ex)
+    {
+        GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    return Variable::createError(-32500, "Unknown application error.");
+}
 }
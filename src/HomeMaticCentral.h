@@ -39,6 +39,10 @@
 #include "BidCoSMessages.h"
 #include "BidCoSQueueManager.h"
 #include "BidCoSPacketManager.h"
+#include "BidCoSParameterWriter.h"
+#include "BidCoSPeerIndex.h"
+#include "BidCoSPeerScheduler.h"
+#include "BidCoSReceivePipeline.h"
 
 #include <memory>
 #include <mutex>
@@ -89,6 +93,8 @@ public:
 	virtual void enqueuePackets(int32_t deviceAddress, std::shared_ptr<BidCoSQueue> packets, bool pushPendingBidCoSQueues = false);
 	std::shared_ptr<BidCoSPacket> getReceivedPacket(int32_t address) { return _receivedPackets.get(address); }
     std::shared_ptr<BidCoSPacket> getSentPacket(int32_t address) { return _sentPackets.get(address); }
+    BidCoSParameterWriter* getParameterWriter() { return _parameterWriter.get(); }
+    BidCoSPeerScheduler* getPeerScheduler() { return _peerScheduler.get(); }
 
 	/**
 	 * Enqueues the pending queues of the peer with deviceAddress.
@@ -135,6 +141,18 @@ public:
 	virtual BaseLib::PVariable setInstallMode(BaseLib::PRpcClientInfo clientInfo, bool on, uint32_t duration, BaseLib::PVariable metadata, bool debugOutput = true);
 	virtual BaseLib::PVariable updateFirmware(BaseLib::PRpcClientInfo clientInfo, std::vector<uint64_t> ids, bool manual);
 	virtual BaseLib::PVariable setInterface(BaseLib::PRpcClientInfo clientInfo, uint64_t peerID, std::string interfaceID);
+
+	/**
+	 * Changes the ID of a peer and moves the peer to the new ID in "_peerIndex" and "_peerScheduler".
+	 */
+	virtual BaseLib::PVariable setId(BaseLib::PRpcClientInfo clientInfo, uint64_t oldPeerId, uint64_t newPeerId);
+
+	/**
+	 * RPC method "getLatencyStatistics". Returns the latencies of the stages of received packets in microseconds.
+	 *
+	 * @param parameters Optional interface ID (String) and optional reset flag (Boolean).
+	 */
+	BaseLib::PVariable getLatencyStatistics(BaseLib::PRpcClientInfo clientInfo, BaseLib::PArray parameters);
 protected:
 	// {{{ In table variables
         std::unordered_map<int32_t, uint8_t> _messageCounter;
@@ -143,6 +161,18 @@ protected:
     BidCoSQueueManager _bidCoSQueueManager;
 	BidCoSPacketManager _receivedPackets;
 	BidCoSPacketManager _sentPackets;
+	std::unique_ptr<BidCoSParameterWriter> _parameterWriter;
+
+	/**
+	 * Typed copy of "_peers", "_peersById" and "_peersBySerial" for "getPeer()". Always update it together with the maps.
+	 */
+	BidCoSPeerIndex _peerIndex;
+	std::unique_ptr<BidCoSPeerScheduler> _peerScheduler;
+
+	/**
+	 * Processes received packets on worker threads. nullptr when "receiveWorkerThreads" is 0.
+	 */
+	std::unique_ptr<BidCoSReceivePipeline> _receivePipeline;
 	std::shared_ptr<BidCoSMessages> _messages;
 
     std::atomic_bool _stopWorkerThread;
@@ -169,7 +199,30 @@ protected:
 	std::thread _updateFirmwareThread;
 	//End
 
+	/**
+	 * The peers loaded in the parallel phase of "loadPeers()". Each worker takes the next row and stores the peer at the row's index, so the order of
+	 * the database is kept.
+	 */
+	struct PeerLoadBatch
+	{
+		std::vector<BaseLib::Database::DataTable::iterator> rows;
+		std::vector<std::shared_ptr<BidCoSPeer>> peers;
+		std::atomic<uint32_t> nextRow{0};
+	};
+
 	virtual void loadPeers();
+
+	/**
+	 * Creates and loads the peers of "batch" until all rows are taken. Doesn't touch the peer maps, so it can run on multiple threads.
+	 */
+	void loadPeersWorker(std::shared_ptr<PeerLoadBatch> batch);
+
+	/**
+	 * Creates the peer of a row of the peers table and loads it from the database.
+	 *
+	 * @return Returns the peer or nullptr when the peer couldn't be loaded.
+	 */
+	std::shared_ptr<BidCoSPeer> loadPeer(BaseLib::Database::DataTable::iterator& row);
 	virtual void savePeers(bool full);
 	virtual void loadVariables();
 	virtual void saveVariables();
@@ -179,6 +232,23 @@ protected:
 	std::shared_ptr<BidCoSPeer> createPeer(int32_t address, int32_t firmwareVersion, uint32_t deviceType, std::string serialNumber, int32_t remoteChannel, int32_t messageCounter, std::shared_ptr<BidCoSPacket> packet = std::shared_ptr<BidCoSPacket>(), bool save = true);
     std::shared_ptr<BidCoSPeer> createTeam(int32_t address, uint32_t deviceType, std::string serialNumber);
 	virtual void worker();
+
+	/**
+	 * Called by "_peerScheduler" when the next deadline of a peer is due.
+	 *
+	 * @return Returns the next deadline of the peer or 0 when the peer doesn't exist anymore.
+	 */
+	int64_t runPeerHousekeeping(uint64_t peerId);
+
+	/**
+	 * Called by "_peerScheduler" when a reset token is due.
+	 */
+	void runPeerReset(const BidCoSPeerScheduler::ResetToken& token);
+
+	/**
+	 * Processes a received packet. Called by "onPacketReceived()" or by a worker of "_receivePipeline".
+	 */
+	bool processReceivedPacket(std::string& senderId, std::shared_ptr<BidCoSPacket> bidCoSPacket);
 	virtual void init();
 	virtual std::shared_ptr<IBidCoSInterface> getPhysicalInterface(int32_t peerAddress);
 };
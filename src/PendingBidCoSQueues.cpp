@@ -43,7 +43,7 @@ void PendingBidCoSQueues::serialize(std::vector<uint8_t>& encodedData)
 		BaseLib::BinaryEncoder encoder(GD::bl);
 		_queuesMutex.lock();
 		encoder.encodeInteger(encodedData, _queues.size());
-		for(std::deque<std::shared_ptr<BidCoSQueue>>::iterator i = _queues.begin(); i != _queues.end(); ++i)
+		for(std::list<std::shared_ptr<BidCoSQueue>>::iterator i = _queues.begin(); i != _queues.end(); ++i)
 		{
 			std::vector<uint8_t> serializedQueue;
 			(*i)->serialize(serializedQueue);
@@ -94,7 +94,11 @@ void PendingBidCoSQueues::unserialize(std::shared_ptr<std::vector<char>> seriali
 				queue->queueEmptyCallback = std::bind(&BidCoSPeer::addVariableToResetCallback, peer, std::placeholders::_1);
 			}
 			queue->pendingQueueID = _currentID++;
-			if(!queue->isEmpty()) _queues.push_back(queue);
+			if(!queue->isEmpty())
+			{
+				_queues.push_back(queue);
+				addToIndex(std::prev(_queues.end()));
+			}
 		}
 	}
 	catch(const std::exception& ex)
@@ -128,7 +132,23 @@ void PendingBidCoSQueues::push(std::shared_ptr<BidCoSQueue> queue)
 		if(!queue || queue->isEmpty()) return;
 		_queuesMutex.lock();
 		queue->pendingQueueID = _currentID++;
+		if(!queue->parameterName.empty() && isSupersedable(queue->getQueueType()))
+		{
+			auto indexIterator = _index.find(getKey(queue));
+			if(indexIterator != _index.end() && !(*indexIterator->second.queue)->started)
+			{
+				//Replace the unsent queue at its position
+				*indexIterator->second.queue = queue;
+				indexIterator->second.superseded++;
+				_superseded++;
+				changed();
+				_queuesMutex.unlock();
+				return;
+			}
+		}
 		_queues.push_back(queue);
+		addToIndex(std::prev(_queues.end()));
+		changed();
 	}
 	catch(const std::exception& ex)
     {
@@ -142,7 +162,12 @@ void PendingBidCoSQueues::pop()
 	try
 	{
 		_queuesMutex.lock();
-		if(!_queues.empty()) _queues.pop_front();
+		if(!_queues.empty())
+		{
+			removeFromIndex(_queues.begin());
+			_queues.pop_front();
+			changed();
+		}
 	}
 	catch(const std::exception& ex)
     {
@@ -156,7 +181,12 @@ void PendingBidCoSQueues::pop(uint32_t id)
 	try
 	{
 		_queuesMutex.lock();
-		if(!_queues.empty() && _queues.front()->pendingQueueID == id) _queues.pop_front();
+		if(!_queues.empty() && _queues.front()->pendingQueueID == id)
+		{
+			removeFromIndex(_queues.begin());
+			_queues.pop_front();
+			changed();
+		}
 	}
 	catch(const std::exception& ex)
     {
@@ -171,6 +201,8 @@ void PendingBidCoSQueues::clear()
 	{
 		_queuesMutex.lock();
 		_queues.clear();
+		_index.clear();
+		changed();
 	}
 	catch(const std::exception& ex)
     {
@@ -214,21 +246,80 @@ std::shared_ptr<BidCoSQueue> PendingBidCoSQueues::front()
     return std::shared_ptr<BidCoSQueue>();
 }
 
+std::shared_ptr<BidCoSQueue> PendingBidCoSQueues::start()
+{
+	try
+	{
+		std::lock_guard<std::mutex> queuesGuard(_queuesMutex);
+		if(_queues.empty() || !_queues.front()) return std::shared_ptr<BidCoSQueue>();
+		_queues.front()->started = true;
+		return _queues.front();
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    return std::shared_ptr<BidCoSQueue>();
+}
+
+std::shared_ptr<BidCoSQueue> PendingBidCoSQueues::findUnstarted(BidCoSQueueType type, std::string parameterName, int32_t channel)
+{
+	try
+	{
+		if(parameterName.empty()) return std::shared_ptr<BidCoSQueue>();
+		std::lock_guard<std::mutex> queuesGuard(_queuesMutex);
+		auto indexIterator = _index.find(QueueKey{type, channel, parameterName});
+		if(indexIterator != _index.end() && !(*indexIterator->second.queue)->started) return *indexIterator->second.queue;
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    return std::shared_ptr<BidCoSQueue>();
+}
+
+bool PendingBidCoSQueues::replace(std::shared_ptr<BidCoSQueue> oldQueue, std::shared_ptr<BidCoSQueue> newQueue)
+{
+	try
+	{
+		if(!oldQueue || !newQueue || newQueue->isEmpty()) return false;
+		QueueKey key = getKey(oldQueue);
+		if(key.parameterName.empty() || !(getKey(newQueue) == key)) return false;
+		std::lock_guard<std::mutex> queuesGuard(_queuesMutex);
+		if(oldQueue->started) return false;
+		auto indexIterator = _index.find(key);
+		if(indexIterator == _index.end() || *indexIterator->second.queue != oldQueue) return false;
+		newQueue->pendingQueueID = _currentID++;
+		*indexIterator->second.queue = newQueue;
+		indexIterator->second.superseded++;
+		_superseded++;
+		changed();
+		return true;
+	}
+	catch(const std::exception& ex)
+    {
+    	GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    return false;
+}
+
 void PendingBidCoSQueues::remove(BidCoSQueueType type, std::string parameterName, int32_t channel)
 {
 	try
 	{
 		if(parameterName.empty()) return;
 		_queuesMutex.lock();
-		if(_queues.empty())
+		QueueKey key{type, channel, parameterName};
+		auto indexIterator = _index.find(key);
+		if(indexIterator != _index.end())
 		{
-			_queuesMutex.unlock();
-			return;
-		}
-		for(int32_t i = _queues.size() - 1; i >= 0; i--)
-		{
-			if(!_queues.at(i) || (_queues.at(i)->getQueueType() == type && _queues.at(i)->parameterName == parameterName && _queues.at(i)->channel == channel)) _queues.erase(_queues.begin() + i);
+			std::list<std::shared_ptr<BidCoSQueue>>::iterator queueIterator = indexIterator->second.queue;
+			_index.erase(indexIterator);
+			_queues.erase(queueIterator);
 		}
+		//An older queue for the same key can only be left at the front, when it was started before the newer one was pushed.
+		if(!_queues.empty() && _queues.front() && getKey(_queues.front()) == key) _queues.pop_front();
+		changed();
 	}
 	catch(const std::exception& ex)
     {
@@ -243,20 +334,9 @@ bool PendingBidCoSQueues::exists(BidCoSQueueType type, std::string parameterName
 	{
 		if(parameterName.empty()) return false;
 		_queuesMutex.lock();
-		if(_queues.empty())
-		{
-			_queuesMutex.unlock();
-			return false;
-		}
-		for(int32_t i = _queues.size() - 1; i >= 0; i--)
-		{
-			if(!_queues.at(i)) continue;
-			if(_queues.at(i)->getQueueType() == type && _queues.at(i)->parameterName == parameterName && _queues.at(i)->channel == channel)
-			{
-				_queuesMutex.unlock();
-				return true;
-			}
-		}
+		bool exists = _index.find(QueueKey{type, channel, parameterName}) != _index.end();
+		_queuesMutex.unlock();
+		return exists;
 	}
 	catch(const std::exception& ex)
     {
@@ -271,7 +351,7 @@ bool PendingBidCoSQueues::find(BidCoSQueueType queueType)
 	try
 	{
 		_queuesMutex.lock();
-		for(std::deque<std::shared_ptr<BidCoSQueue>>::iterator i = _queues.begin(); i != _queues.end(); ++i)
+		for(std::list<std::shared_ptr<BidCoSQueue>>::iterator i = _queues.begin(); i != _queues.end(); ++i)
 		{
 			if(*i && (*i)->getQueueType() == queueType)
 			{
@@ -304,16 +384,36 @@ void PendingBidCoSQueues::setWakeOnRadioBit()
 	_queuesMutex.unlock();
 }
 
+void PendingBidCoSQueues::setChangedCallback(std::function<void(bool)> callback)
+{
+	try
+	{
+		std::lock_guard<std::mutex> queuesGuard(_queuesMutex);
+		_changedCallback = callback;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
 void PendingBidCoSQueues::getInfoString(std::ostringstream& stringStream)
 {
 	try
 	{
 		_queuesMutex.lock();
 		stringStream << "Number of Pending queues: " << _queues.size() << std::endl;
+		stringStream << "Number of superseded queues: " << _superseded << std::endl;
 		int32_t j = 1;
-		for(std::deque<std::shared_ptr<BidCoSQueue>>::iterator i = _queues.begin(); i != _queues.end(); ++i)
+		for(std::list<std::shared_ptr<BidCoSQueue>>::iterator i = _queues.begin(); i != _queues.end(); ++i)
 		{
 			stringStream << std::dec << "Queue " << j << ":" << std::endl;
+			if(!(*i)->parameterName.empty())
+			{
+				stringStream << "  Parameter: " << (*i)->parameterName << " (channel " << (*i)->channel << ")" << std::endl;
+				auto indexIterator = _index.find(getKey(*i));
+				if(indexIterator != _index.end() && indexIterator->second.queue == i) stringStream << "  Replaces older queues: " << indexIterator->second.superseded << std::endl;
+			}
 			std::list<BidCoSQueueEntry>* queue = (*i)->getQueue();
 			stringStream << "  Number of packets: " << queue->size() << std::endl;
 			int32_t l = 1;
@@ -354,4 +454,25 @@ void PendingBidCoSQueues::getInfoString(std::ostringstream& stringStream)
 	}
 	_queuesMutex.unlock();
 }
+
+PendingBidCoSQueues::QueueKey PendingBidCoSQueues::getKey(const std::shared_ptr<BidCoSQueue>& queue)
+{
+	return QueueKey{queue->getQueueType(), queue->channel, queue->parameterName};
+}
+
+void PendingBidCoSQueues::addToIndex(std::list<std::shared_ptr<BidCoSQueue>>::iterator queueIterator)
+{
+	if(!*queueIterator || (*queueIterator)->parameterName.empty()) return;
+	IndexEntry& entry = _index[getKey(*queueIterator)];
+	entry.queue = queueIterator;
+	entry.superseded = 0;
+}
+
+void PendingBidCoSQueues::removeFromIndex(std::list<std::shared_ptr<BidCoSQueue>>::iterator queueIterator)
+{
+	if(!*queueIterator || (*queueIterator)->parameterName.empty()) return;
+	auto indexIterator = _index.find(getKey(*queueIterator));
+	if(indexIterator != _index.end() && indexIterator->second.queue == queueIterator) _index.erase(indexIterator);
+}
+
 }
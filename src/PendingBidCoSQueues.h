@@ -40,11 +40,19 @@
 #include <iostream>
 #include <memory>
 #include <queue>
+#include <functional>
+#include <list>
 #include <mutex>
+#include <unordered_map>
 
 namespace BidCoS
 {
 
+/**
+ * The queues waiting to be sent to a peer. Queues with a parameter name are indexed by type, parameter name and channel. A new PEER or
+ * GETVALUE queue replaces an older one for the same parameter at its position as long as the older one was not started yet, so a peer waking
+ * up only receives the latest value.
+ */
 class PendingBidCoSQueues
 {
 public:
@@ -59,17 +67,74 @@ public:
 	bool empty();
 	uint32_t size();
 	std::shared_ptr<BidCoSQueue> front();
+
+	/**
+	 * Returns the front queue and marks it as started. Started queues are never replaced.
+	 */
+	std::shared_ptr<BidCoSQueue> start();
+
+	/**
+	 * Returns the last queue matching type, parameter name and channel which was not started yet.
+	 */
+	std::shared_ptr<BidCoSQueue> findUnstarted(BidCoSQueueType type, std::string parameterName, int32_t channel);
+
+	/**
+	 * Replaces a queue which was not started yet at its position.
+	 *
+	 * @return Returns false when the queue was started or removed in the meantime.
+	 */
+	bool replace(std::shared_ptr<BidCoSQueue> oldQueue, std::shared_ptr<BidCoSQueue> newQueue);
 	void clear();
 	void remove(BidCoSQueueType type, std::string value, int32_t channel);
 	bool exists(BidCoSQueueType type, std::string value, int32_t channel);
 	bool find(BidCoSQueueType queueType);
 	void setWakeOnRadioBit();
 
+	/**
+	 * Sets a function called after every change of the queues with "true" when no queue is left. It is called with the queues locked, so it must
+	 * not access this object.
+	 */
+	void setChangedCallback(std::function<void(bool)> callback);
+
 	void getInfoString(std::ostringstream& stringStream);
 private:
+	struct QueueKey
+	{
+		BidCoSQueueType type = BidCoSQueueType::EMPTY;
+		int32_t channel = -1;
+		std::string parameterName;
+
+		bool operator==(const QueueKey& other) const { return type == other.type && channel == other.channel && parameterName == other.parameterName; }
+	};
+
+	struct QueueKeyHash
+	{
+		std::size_t operator()(const QueueKey& key) const { return std::hash<std::string>()(key.parameterName) ^ ((std::size_t)key.type << 24) ^ (std::size_t)(uint32_t)key.channel; }
+	};
+
+	struct IndexEntry
+	{
+		std::list<std::shared_ptr<BidCoSQueue>>::iterator queue;
+		uint32_t superseded = 0;
+	};
+
 	uint32_t _currentID = 0;
+	uint64_t _superseded = 0;
+	std::function<void(bool)> _changedCallback;
 	std::mutex _queuesMutex;
-    std::deque<std::shared_ptr<BidCoSQueue>> _queues;
+    std::list<std::shared_ptr<BidCoSQueue>> _queues;
+
+    /**
+     * Points to the latest queue of every key. Only the front queue can be an older queue with the same key, because queues are only
+     * superseded while they were not started.
+     */
+    std::unordered_map<QueueKey, IndexEntry, QueueKeyHash> _index;
+
+    static QueueKey getKey(const std::shared_ptr<BidCoSQueue>& queue);
+    static bool isSupersedable(BidCoSQueueType type) { return type == BidCoSQueueType::PEER || type == BidCoSQueueType::GETVALUE; }
+    void addToIndex(std::list<std::shared_ptr<BidCoSQueue>>::iterator queueIterator);
+    void removeFromIndex(std::list<std::shared_ptr<BidCoSQueue>>::iterator queueIterator);
+    void changed() { if(_changedCallback) _changedCallback(_queues.empty()); }
 };
 
 }
@@ -496,7 +496,7 @@ bool AesHandshake::checkAFrame(std::shared_ptr<BidCoSPacket> aFrame)
 
 bool AesHandshake::generateKeyChangePacket(std::shared_ptr<BidCoSPacket> keyChangeTemplate)
 {
-	std::vector<uint8_t>& payload = keyChangeTemplate->payload();
+	BidCoSPayload& payload = keyChangeTemplate->payload();
 	std::vector<uint8_t> oldRfKey;
 	try
 	{
@@ -646,11 +646,7 @@ void AesHandshake::appendSignature(std::shared_ptr<BidCoSPacket> packet)
 			return;
 		}
 
-		packet->payload().reserve(packet->payload().size() + 4);
-		packet->payload().push_back(signature.at(12));
-		packet->payload().push_back(signature.at(13));
-		packet->payload().push_back(signature.at(14));
-		packet->payload().push_back(signature.at(15));
+		packet->payload().insert(packet->payload().end(), signature.begin() + 12, signature.end());
 	}
 	catch(const std::exception& ex)
     {
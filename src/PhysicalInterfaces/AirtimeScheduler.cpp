@@ -0,0 +1,201 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "AirtimeScheduler.h"
+#include "../GD.h"
+
+namespace BidCoS
+{
+
+AirtimeScheduler::Slot::Slot(AirtimeScheduler& scheduler, TrafficClass trafficClass, uint32_t airtime) : _scheduler(scheduler)
+{
+	_scheduler.acquire(trafficClass, airtime);
+}
+
+AirtimeScheduler::Slot::~Slot()
+{
+	_scheduler.release();
+}
+
+AirtimeScheduler::AirtimeScheduler()
+{
+	_bucketMinutes.fill(-1);
+}
+
+AirtimeScheduler::TrafficClass AirtimeScheduler::classify(const std::shared_ptr<BidCoSPacket>& packet)
+{
+	//0x02: ACK and AES response, 0x03: AES reply
+	if(packet->messageType() == 0x02 || packet->messageType() == 0x03) return TrafficClass::acknowledgement;
+	//0x01: Configuration, 0xCA: Firmware update
+	if(packet->messageType() == 0x01 || packet->messageType() == 0xCA || packet->isUpdatePacket()) return TrafficClass::bulk;
+	return TrafficClass::interactive;
+}
+
+uint32_t AirtimeScheduler::estimateAirtime(const std::shared_ptr<BidCoSPacket>& packet)
+{
+	//4 bytes preamble, 4 bytes sync word, length byte, frame and 2 bytes CRC at 10 bits per millisecond
+	uint32_t bits = (4 + 4 + 1 + (uint32_t)packet->length() + 2) * 8;
+	uint32_t airtime = (bits + 9) / 10;
+	if(packet->controlByte() & 0x10) airtime += 360;
+	return airtime;
+}
+
+void AirtimeScheduler::acquire(TrafficClass trafficClass, uint32_t airtime)
+{
+	try
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		int32_t index = (int32_t)trafficClass;
+		uint64_t ticket = _nextTicket[index]++;
+		_waiting[index]++;
+		if(trafficClass == TrafficClass::bulk)
+		{
+			int64_t time = BaseLib::HelperFunctions::getTime();
+			LoadHint hint = loadHint(time);
+			if(hint != LoadHint::none || used(time) + _bulkReserve >= _budget)
+			{
+				//Pace bulk frames down to 1% duty cycle. The wait per frame is limited, so queues don't time out while waiting.
+				int64_t interval = hint == LoadHint::overload ? _maxDeferral : (int64_t)airtime * 99;
+				int64_t wait = std::min(std::max(_nextBulkTime - time, (int64_t)0), _maxDeferral);
+				_nextBulkTime = time + wait + interval;
+				if(wait > 0)
+				{
+					_deferredFrames++;
+					_conditionVariable.wait_for(lock, std::chrono::milliseconds(wait), []() { return false; });
+				}
+			}
+		}
+		_conditionVariable.wait(lock, [&]()
+		{
+			if(_busy || _servedTicket[index] != ticket) return false;
+			for(int32_t i = 0; i < index; i++)
+			{
+				if(_waiting[i] > 0) return false;
+			}
+			return true;
+		});
+		_waiting[index]--;
+		_servedTicket[index]++;
+		_busy = true;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void AirtimeScheduler::release()
+{
+	try
+	{
+		std::lock_guard<std::mutex> schedulerGuard(_mutex);
+		_busy = false;
+		_conditionVariable.notify_all();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void AirtimeScheduler::record(uint32_t airtime)
+{
+	try
+	{
+		std::lock_guard<std::mutex> schedulerGuard(_mutex);
+		int64_t minute = BaseLib::HelperFunctions::getTime() / _bucketLength;
+		uint32_t index = minute % _bucketCount;
+		if(_bucketMinutes[index] != minute)
+		{
+			_bucketMinutes[index] = minute;
+			_buckets[index] = 0;
+		}
+		_buckets[index] += airtime;
+		_frames++;
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void AirtimeScheduler::setLoadHint(LoadHint hint)
+{
+	try
+	{
+		std::lock_guard<std::mutex> schedulerGuard(_mutex);
+		_loadHint = hint;
+		_loadHintTime = BaseLib::HelperFunctions::getTime();
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+AirtimeScheduler::Statistics AirtimeScheduler::getStatistics()
+{
+	Statistics statistics;
+	try
+	{
+		std::lock_guard<std::mutex> schedulerGuard(_mutex);
+		int64_t time = BaseLib::HelperFunctions::getTime();
+		statistics.budget = _budget;
+		statistics.used = used(time);
+		statistics.remaining = statistics.used < _budget ? _budget - statistics.used : 0;
+		statistics.backlog = _waiting;
+		statistics.frames = _frames;
+		statistics.deferredFrames = _deferredFrames;
+		statistics.loadHint = loadHint(time);
+	}
+	catch(const std::exception& ex)
+	{
+		GD::out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return statistics;
+}
+
+uint32_t AirtimeScheduler::used(int64_t time)
+{
+	int64_t minute = time / _bucketLength;
+	uint32_t used = 0;
+	for(uint32_t i = 0; i < _bucketCount; i++)
+	{
+		if(_bucketMinutes[i] > minute - (int64_t)_bucketCount) used += _buckets[i];
+	}
+	return used;
+}
+
+AirtimeScheduler::LoadHint AirtimeScheduler::loadHint(int64_t time)
+{
+	if(_loadHint != LoadHint::none && time - _loadHintTime > _loadHintLifetime) _loadHint = LoadHint::none;
+	return _loadHint;
+}
+
+}
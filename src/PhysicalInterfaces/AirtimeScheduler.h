@@ -0,0 +1,147 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef AIRTIMESCHEDULER_H_
+#define AIRTIMESCHEDULER_H_
+
+#include <cstdint>
+
+#include "../BidCoSPacket.h"
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+
+namespace BidCoS
+{
+
+/**
+ * Accounts the airtime of the frames sent by one interface against the 1% duty cycle (36 seconds per rolling hour) and orders concurrent
+ * senders by traffic class. Acknowledgements and AES frames are always sent first, followed by interactive frames. Configuration and firmware
+ * frames are paced down to 1% duty cycle as soon as the remaining budget gets low, so they back off before the stick starts refusing frames.
+ */
+class AirtimeScheduler
+{
+public:
+	enum class TrafficClass : int32_t
+	{
+		acknowledgement = 0,
+		interactive = 1,
+		bulk = 2
+	};
+
+	enum class LoadHint : int32_t
+	{
+		none = 0,
+		highLoad = 1,
+		overload = 2
+	};
+
+	struct Statistics
+	{
+		uint32_t budget = 0;
+		uint32_t used = 0;
+		uint32_t remaining = 0;
+		std::array<uint32_t, 3> backlog{};
+		uint64_t frames = 0;
+		uint64_t deferredFrames = 0;
+		LoadHint loadHint = LoadHint::none;
+	};
+
+	/**
+	 * Holds the transmit slot of one sender. Waits for its turn on construction and passes the slot on on destruction.
+	 */
+	class Slot
+	{
+	public:
+		Slot(AirtimeScheduler& scheduler, TrafficClass trafficClass, uint32_t airtime);
+		virtual ~Slot();
+	private:
+		AirtimeScheduler& _scheduler;
+	};
+
+	AirtimeScheduler();
+	virtual ~AirtimeScheduler() = default;
+
+	/**
+	 * Returns the traffic class of a frame.
+	 */
+	static TrafficClass classify(const std::shared_ptr<BidCoSPacket>& packet);
+
+	/**
+	 * Estimates the airtime of a frame in milliseconds at 10 kbit/s including preamble, sync word and CRC. Burst frames add the 360 ms wake up
+	 * preamble.
+	 */
+	static uint32_t estimateAirtime(const std::shared_ptr<BidCoSPacket>& packet);
+
+	/**
+	 * Books the airtime of a frame which was handed to the stick.
+	 */
+	void record(uint32_t airtime);
+
+	/**
+	 * Passes on the load state reported by the stick. A hint expires after five minutes unless it is reported again.
+	 */
+	void setLoadHint(LoadHint hint);
+
+	Statistics getStatistics();
+private:
+	static constexpr uint32_t _budget = 36000;
+	static constexpr uint32_t _bulkReserve = 9000;
+	static constexpr int64_t _maxDeferral = 2000;
+	static constexpr int64_t _loadHintLifetime = 300000;
+	static constexpr int64_t _bucketLength = 60000;
+	static constexpr uint32_t _bucketCount = 60;
+
+	std::mutex _mutex;
+	std::condition_variable _conditionVariable;
+	bool _busy = false;
+	std::array<uint32_t, 3> _waiting{};
+	std::array<uint64_t, 3> _nextTicket{};
+	std::array<uint64_t, 3> _servedTicket{};
+	int64_t _nextBulkTime = 0;
+	uint64_t _frames = 0;
+	uint64_t _deferredFrames = 0;
+	LoadHint _loadHint = LoadHint::none;
+	int64_t _loadHintTime = 0;
+
+	/**
+	 * Booked airtime per minute of the last hour. The bucket of minute n is at index n % _bucketCount.
+	 */
+	std::array<uint32_t, _bucketCount> _buckets{};
+	std::array<int64_t, _bucketCount> _bucketMinutes{};
+
+	void acquire(TrafficClass trafficClass, uint32_t airtime);
+	void release();
+	uint32_t used(int64_t time);
+	LoadHint loadHint(int64_t time);
+};
+
+}
+#endif
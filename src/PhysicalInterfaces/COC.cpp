@@ -170,23 +170,24 @@ void COC::stopListening() {
 
 void COC::lineReceived(const std::string &data) {
   try {
-    std::string packetHex;
+    std::string_view packetHex(data);
     if (stackPrefix.empty()) {
       if (data.size() > 0 && data.at(0) == '*') return;
-      packetHex = data;
     } else {
       if (data.size() + 1 <= stackPrefix.size()) return;
-      if (data.substr(0, stackPrefix.size()) != stackPrefix || data.at(stackPrefix.size()) == '*') return;
-      else packetHex = data.substr(stackPrefix.size());
+      if (data.compare(0, stackPrefix.size(), stackPrefix) != 0 || data.at(stackPrefix.size()) == '*') return;
+      else packetHex = packetHex.substr(stackPrefix.size());
     }
     if (packetHex.size() > 21) //21 is minimal packet length (=10 Byte + COC "A" + "\n")
     {
-      std::shared_ptr<BidCoSPacket> packet(new BidCoSPacket(packetHex, BaseLib::HelperFunctions::getTime()));
+      std::shared_ptr<BidCoSPacket> packet = _packetPool.create(packetHex, BaseLib::HelperFunctions::getTime());
       processReceivedPacket(packet);
     } else if (!packetHex.empty()) {
-      if (packetHex.compare(0, 4, "LOVF") == 0) _out.printWarning("Warning: COC with id " + _settings->id + " reached 1% limit. You need to wait, before sending is allowed again.");
-      else if (packetHex == "A") return;
-      else _out.printInfo("Info: Ignoring too small packet: " + packetHex);
+      if (packetHex.compare(0, 4, "LOVF") == 0) {
+        _out.printWarning("Warning: COC with id " + _settings->id + " reached 1% limit. You need to wait, before sending is allowed again.");
+        _airtimeScheduler.setLoadHint(AirtimeScheduler::LoadHint::overload);
+      } else if (packetHex == "A") return;
+      else _out.printInfo("Info: Ignoring too small packet: " + std::string(packetHex));
     }
   }
   catch (const std::exception &ex) {
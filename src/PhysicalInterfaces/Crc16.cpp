@@ -33,7 +33,7 @@ namespace BidCoS
 {
 CRC16::CRC16()
 {
-	if(_crcTable.empty()) initCRCTable();
+	initCRCTable();
 }
 
 void CRC16::initCRCTable()
@@ -59,10 +59,10 @@ void CRC16::initCRCTable()
 uint16_t CRC16::calculate(const std::vector<char>& data, bool ignoreLastTwoBytes)
 {
 	int32_t size = ignoreLastTwoBytes ? data.size() - 2 : data.size();
-	uint16_t crc = 0xd77f;
+	uint16_t crc = initialValue;
 	for(int32_t i = 0; i < size; i++)
 	{
-		crc = (crc << 8) ^ _crcTable[((crc >> 8) & 0xff) ^ (uint8_t)data[i]];
+		crc = update(crc, (uint8_t)data[i]);
 	}
 
     return crc;
@@ -71,10 +71,10 @@ uint16_t CRC16::calculate(const std::vector<char>& data, bool ignoreLastTwoBytes
 uint16_t CRC16::calculate(const std::vector<uint8_t>& data, bool ignoreLastTwoBytes)
 {
 	int32_t size = ignoreLastTwoBytes ? data.size() - 2 : data.size();
-	uint16_t crc = 0xd77f;
+	uint16_t crc = initialValue;
 	for(int32_t i = 0; i < size; i++)
 	{
-		crc = (crc << 8) ^ _crcTable[((crc >> 8) & 0xff) ^ data[i]];
+		crc = update(crc, data[i]);
 	}
 
     return crc;
@@ -32,7 +32,7 @@
 
 #include <cstdint>
 #include <vector>
-#include <map>
+#include <array>
 
 namespace BidCoS
 {
@@ -44,8 +44,15 @@ public:
 	virtual ~CRC16() {}
 	uint16_t calculate(const std::vector<char>& data, bool ignoreLastTwoBytes = false);
 	uint16_t calculate(const std::vector<uint8_t>& data, bool ignoreLastTwoBytes = false);
+
+	static constexpr uint16_t initialValue = 0xd77f;
+
+	/**
+	 * Adds one byte to a running CRC started with "initialValue".
+	 */
+	uint16_t update(uint16_t crc, uint8_t byte) const { return (uint16_t)((crc << 8) ^ _crcTable[((crc >> 8) & 0xff) ^ byte]); }
 private:
-	std::map<uint16_t, uint16_t> _crcTable;
+	std::array<uint16_t, 256> _crcTable;
 	void initCRCTable();
 };
 
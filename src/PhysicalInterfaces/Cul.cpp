@@ -77,7 +77,7 @@ void Cul::forceSendPacket(std::shared_ptr<BidCoSPacket> packet)
 		}
 		std::string packetString = packet->hexString();
 		if(_bl->debugLevel >= 4) _out.printInfo("Info: Sending (" + _settings->id + "): " + packetString);
-		writeToDevice("As" + packet->hexString() + "\n" + (_updateMode ? "" : "Ar\n"));
+		writeToDevice("As" + packetString + "\n" + (_updateMode ? "" : "Ar\n"));
         if(packet->controlByte() & 0x10) std::this_thread::sleep_for(std::chrono::milliseconds(380)); //360ms preamble + 20ms sending
         else std::this_thread::sleep_for(std::chrono::milliseconds(20)); //20ms sending
 		_lastPacketSent = BaseLib::HelperFunctions::getTime();
@@ -409,12 +409,16 @@ void Cul::listen()
 			}
         	else if(packetHex.size() >= 21) //21 is minimal packet length (=10 bytes + CUL "A")
         	{
-        		std::shared_ptr<BidCoSPacket> packet(new BidCoSPacket(packetHex, BaseLib::HelperFunctions::getTime()));
+        		std::shared_ptr<BidCoSPacket> packet = _packetPool.create(packetHex, BaseLib::HelperFunctions::getTime());
 				processReceivedPacket(packet);
         	}
         	else if(!packetHex.empty())
         	{
-        		if(packetHex.compare(0, 4, "LOVF") == 0) _out.printWarning("Warning: CUL with id " + _settings->id + " reached 1% limit. You need to wait, before sending is allowed again.");
+        		if(packetHex.compare(0, 4, "LOVF") == 0)
+        		{
+        			_out.printWarning("Warning: CUL with id " + _settings->id + " reached 1% limit. You need to wait, before sending is allowed again.");
+        			_airtimeScheduler.setLoadHint(AirtimeScheduler::LoadHint::overload);
+        		}
         		else if(packetHex == "A") continue;
         		else
         		{
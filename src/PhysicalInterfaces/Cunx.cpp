@@ -74,7 +74,7 @@ void Cunx::forceSendPacket(std::shared_ptr<BidCoSPacket> packet) {
     std::lock_guard<std::mutex> sendGuard(_forceSendPacketMutex);
     std::string packetString = packet->hexString();
     if (_bl->debugLevel >= 4) _out.printInfo("Info: Sending (" + _settings->id + "): " + packetString);
-    send(stackPrefix + "As" + packet->hexString() + "\n" + (_updateMode ? "" : stackPrefix + "Ar\n"));
+    send(stackPrefix + "As" + packetString + "\n" + (_updateMode ? "" : stackPrefix + "Ar\n"));
     if (packet->controlByte() & 0x10) std::this_thread::sleep_for(std::chrono::milliseconds(380));
     else std::this_thread::sleep_for(std::chrono::milliseconds(20));
     _lastPacketSent = BaseLib::HelperFunctions::getTime();
@@ -260,12 +260,14 @@ void Cunx::listen() {
 void Cunx::processData(std::vector<uint8_t> &data) {
   try {
     if (data.empty()) return;
-    std::string packets;
-    packets.insert(packets.end(), data.begin(), data.end());
+    std::string_view packets((const char *)data.data(), data.size());
+
+    while (!packets.empty()) {
+      //Split lines in place like std::getline would, without copying the received data
+      std::string_view::size_type lineEnd = packets.find('\n');
+      std::string_view packetHex = packets.substr(0, lineEnd);
+      packets = (lineEnd == std::string_view::npos) ? std::string_view() : packets.substr(lineEnd + 1);
 
-    std::istringstream stringStream(packets);
-    std::string packetHex;
-    while (std::getline(stringStream, packetHex)) {
       if (stackPrefix.empty()) {
         if (packetHex.size() > 0 && packetHex.at(0) == '*') return;
       } else {
@@ -275,12 +277,14 @@ void Cunx::processData(std::vector<uint8_t> &data) {
       }
       if (packetHex.size() > 21) //21 is minimal packet length (=10 Byte + CUNX "A" + "\n")
       {
-        std::shared_ptr<BidCoSPacket> packet(new BidCoSPacket(packetHex, BaseLib::HelperFunctions::getTime()));
+        std::shared_ptr<BidCoSPacket> packet = _packetPool.create(packetHex, BaseLib::HelperFunctions::getTime());
         processReceivedPacket(packet);
       } else if (!packetHex.empty()) {
-        if (packetHex.compare(0, 4, "LOVF") == 0) _out.printWarning("Warning: CUNX with id " + _settings->id + " reached 1% limit. You need to wait, before sending is allowed again.");
-        else if (packetHex == "A") continue;
-        else _out.printInfo("Info: Ignoring too small packet: " + packetHex);
+        if (packetHex.compare(0, 4, "LOVF") == 0) {
+          _out.printWarning("Warning: CUNX with id " + _settings->id + " reached 1% limit. You need to wait, before sending is allowed again.");
+          _airtimeScheduler.setLoadHint(AirtimeScheduler::LoadHint::overload);
+        } else if (packetHex == "A") continue;
+        else _out.printInfo("Info: Ignoring too small packet: " + std::string(packetHex));
       }
     }
   }
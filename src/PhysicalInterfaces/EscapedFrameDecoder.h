@@ -0,0 +1,140 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef ESCAPEDFRAMEDECODER_H
+#define ESCAPEDFRAMEDECODER_H
+
+#include "Crc16.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BidCoS
+{
+
+/**
+ * Incremental decoder for the framing used by HM-LGW and HM-MOD-RPI-PCB: Frames start with 0xFD, followed by a two byte length, the
+ * payload and a CRC16. 0xFC escapes the next byte, which then needs to be ORed with 0x80.
+ *
+ * Data can be passed in chunks of any size. Each byte is unescaped directly into a frame buffer that is reused for all frames, and the CRC is
+ * calculated while the frame is assembled, so a frame is complete as soon as its last byte arrives.
+ */
+class EscapedFrameDecoder
+{
+public:
+	enum class Error
+	{
+		tooSmall,
+		tooLarge
+	};
+
+	/**
+	 * @param maxFrameSize The maximum size of an unescaped frame including start byte, length and CRC. Larger frames are dropped.
+	 */
+	explicit EscapedFrameDecoder(uint32_t maxFrameSize = 255);
+	virtual ~EscapedFrameDecoder() = default;
+
+	/**
+	 * Decodes a chunk of data.
+	 *
+	 * @param frameHandler Called as "void(std::vector<uint8_t>& frame, uint16_t crc)" for every complete frame and for frames that are cut off by
+	 * the start of the next frame. "crc" is the CRC of all bytes except the last two. "frame" is only valid until the handler returns.
+	 * @param errorHandler Called as "void(Error error, std::vector<uint8_t>& header)" when the length of a frame is invalid. The frame is dropped.
+	 */
+	template<typename FrameHandler, typename ErrorHandler>
+	void decode(const uint8_t* data, size_t size, FrameHandler&& frameHandler, ErrorHandler&& errorHandler)
+	{
+		for(const uint8_t* end = data + size; data != end; ++data)
+		{
+			uint8_t byte = *data;
+			if(byte == 0xFD)
+			{
+				if(_inFrame && _frame.size() >= minFrameSize) frameHandler(_frame, _crc.calculate(_frame, true));
+				_frame.clear();
+				_frame.push_back(byte);
+				_inFrame = true;
+				_escapeByte = false;
+				_frameSize = 0;
+				_runningCrc = _crc.update(CRC16::initialValue, byte);
+				continue;
+			}
+			if(!_inFrame) continue; //Garbage between frames
+			if(byte == 0xFC)
+			{
+				_escapeByte = true;
+				continue;
+			}
+			if(_escapeByte)
+			{
+				byte |= 0x80;
+				_escapeByte = false;
+			}
+
+			_frame.push_back(byte);
+			if(_frameSize == 0)
+			{
+				_runningCrc = _crc.update(_runningCrc, byte);
+				if(_frame.size() < 3) continue;
+				_frameSize = (((uint32_t)_frame[1]) << 8) + _frame[2] + 5;
+				if(_frameSize < minFrameSize || _frameSize > _maxFrameSize)
+				{
+					_inFrame = false;
+					errorHandler(_frameSize < minFrameSize ? Error::tooSmall : Error::tooLarge, _frame);
+				}
+				continue;
+			}
+			if(_frame.size() <= _frameSize - 2) _runningCrc = _crc.update(_runningCrc, byte);
+			if(_frame.size() == _frameSize)
+			{
+				_inFrame = false;
+				frameHandler(_frame, _runningCrc);
+			}
+		}
+	}
+
+	/**
+	 * Drops a partially received frame, e. g. after reconnecting.
+	 */
+	void reset();
+private:
+	static constexpr uint32_t minFrameSize = 8;
+
+	CRC16 _crc;
+	uint32_t _maxFrameSize = 255;
+	std::vector<uint8_t> _frame;
+	bool _inFrame = false;
+	bool _escapeByte = false;
+	uint32_t _frameSize = 0;
+	uint16_t _runningCrc = 0;
+};
+
+}
+
+#endif
@@ -204,7 +204,12 @@ void HM_CFG_LAN::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> packet) {
     std::string packetString = bidCoSPacket->hexString();
     if (_bl->debugLevel >= 4) _out.printInfo("Info: Sending (" + _settings->id + "): " + packetString);
     std::string hexString = "S" + BaseLib::HelperFunctions::getHexString(currentTime, 8) + ",00,00000000,01," + BaseLib::HelperFunctions::getHexString((uint32_t)(currentTimeMilliseconds - _startUpTime), 8) + "," + packetString.substr(2) + "\r\n";
-    send(hexString, false);
+    uint32_t airtime = AirtimeScheduler::estimateAirtime(bidCoSPacket);
+    {
+      AirtimeScheduler::Slot airtimeSlot(_airtimeScheduler, AirtimeScheduler::classify(bidCoSPacket), airtime);
+      send(hexString, false);
+    }
+    if (!_stopped) _airtimeScheduler.record(airtime);
     _lastPacketSent = BaseLib::HelperFunctions::getTime();
   }
   catch (const std::exception &ex) {
@@ -771,8 +776,13 @@ void HM_CFG_LAN::parsePacket(std::string &packet) {
       04: Overload
       */
       uint8_t statusByte = tempNumber >> 8;
-      if (statusByte & 4) _out.printError("Error: HM-CFG-LAN reached 1% rule.");
-      else if (statusByte & 2) _out.printWarning("Warning: HM-CFG-LAN nearly reached 1% rule.");
+      if (statusByte & 4) {
+        _out.printError("Error: HM-CFG-LAN reached 1% rule.");
+        _airtimeScheduler.setLoadHint(AirtimeScheduler::LoadHint::overload);
+      } else if (statusByte & 2) {
+        _out.printWarning("Warning: HM-CFG-LAN nearly reached 1% rule.");
+        _airtimeScheduler.setLoadHint(AirtimeScheduler::LoadHint::highLoad);
+      } else _airtimeScheduler.setLoadHint(AirtimeScheduler::LoadHint::none);
 
       /*
       00: Not set
@@ -798,7 +808,7 @@ void HM_CFG_LAN::parsePacket(std::string &packet) {
         else rssi = (rssi + 74) * 2;
         binaryPacket.push_back(rssi);
 
-        std::shared_ptr<BidCoSPacket> bidCoSPacket(new BidCoSPacket(binaryPacket, true, BaseLib::HelperFunctions::getTime()));
+        std::shared_ptr<BidCoSPacket> bidCoSPacket = _packetPool.create(binaryPacket, true, BaseLib::HelperFunctions::getTime());
         if (packet.at(0) == 'E' && (statusByte & 1)) {
           _out.printDebug("Debug: Waiting for AES handshake.");
           _lastPacketReceived = BaseLib::HelperFunctions::getTime();
@@ -43,6 +43,18 @@ HM_LGW::HM_LGW(std::shared_ptr<BaseLib::Systems::PhysicalInterfaceSettings> sett
   _socket = std::make_unique<C1Net::TcpSocket>(tcp_socket_info, dummy_socket);
   _socketKeepAlive = std::make_unique<C1Net::TcpSocket>(tcp_socket_info, dummy_socket);
 
+  _peerProvisioner = std::make_unique<PeerProvisioner>(_out,
+                                                       std::bind(&HM_LGW::sendRequest, this, std::placeholders::_1, 1, 4),
+                                                       std::bind(&HM_LGW::waitForResponse, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+                                                       std::bind(&HM_LGW::removeRequest, this, std::placeholders::_1),
+                                                       [this]() { return (bool)_stopped; },
+                                                       10000);
+
+  int32_t requestWindow = GD::settings->getNumber("lgwrequestwindow");
+  if (requestWindow <= 0) requestWindow = 4;
+  else if (requestWindow > 32) requestWindow = 32;
+  _requestWindow = requestWindow;
+
   if (!settings) {
     _out.printCritical("Critical: Error initializing HM-LGW. Settings pointer is empty.");
     return;
@@ -78,9 +90,7 @@ void HM_LGW::enableUpdateMode() {
       std::vector<uint8_t> responsePacket;
       std::vector<char> requestPacket;
       std::vector<char> payload{0, 6};
-      buildPacket(requestPacket, payload);
-      _packetIndex++;
-      getResponse(requestPacket, responsePacket, _packetIndex - 1, 0, 4);
+      getResponse(payload, requestPacket, responsePacket, 0, 4);
       if (responsePacket.size() >= 9 && responsePacket.at(6) == 1) {
         break;
       } else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
@@ -99,9 +109,7 @@ void HM_LGW::enableUpdateMode() {
       std::vector<char> payload{0, 7};
       payload.push_back(0xE9);
       payload.push_back(0xCA);
-      buildPacket(requestPacket, payload);
-      _packetIndex++;
-      getResponse(requestPacket, responsePacket, _packetIndex - 1, 0, 4);
+      getResponse(payload, requestPacket, responsePacket, 0, 4);
       if (responsePacket.size() >= 9 && responsePacket.at(6) == 1) {
         _out.printInfo("Info: Update mode enabled.");
         break;
@@ -129,9 +137,7 @@ void HM_LGW::disableUpdateMode() {
         std::vector<uint8_t> responsePacket;
         std::vector<char> requestPacket;
         std::vector<char> payload{ 0, 6 };
-        buildPacket(requestPacket, payload);
-        _packetIndex++;
-        getResponse(requestPacket, responsePacket, _packetIndex - 1, 0, 4);
+        getResponse(payload, requestPacket, responsePacket, 0, 4);
         if(responsePacket.size() >= 9  && responsePacket.at(6) == 1)
         {
             _out.printInfo("Info: Update mode disabled.");
@@ -183,11 +189,14 @@ void HM_LGW::addPeer(PeerInfo peerInfo) {
 void HM_LGW::addPeers(std::vector<PeerInfo> &peerInfos) {
   try {
     _peersMutex.lock();
+    std::vector<PeerInfo> newPeers;
+    newPeers.reserve(peerInfos.size());
     for (std::vector<PeerInfo>::iterator i = peerInfos.begin(); i != peerInfos.end(); ++i) {
       if (i->address == 0) continue;
       _peers[i->address] = *i;
-      if (_initComplete) sendPeer(*i);
+      if (_initComplete) newPeers.push_back(*i);
     }
+    if (!newPeers.empty()) _peerProvisioner->provision(newPeers, false);
   }
   catch (const std::exception &ex) {
     _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
@@ -209,9 +218,7 @@ void HM_LGW::processQueueEntry(int32_t index, int64_t id, std::shared_ptr<BaseLi
         payload.push_back(queueEntry->address >> 16);
         payload.push_back((queueEntry->address >> 8) & 0xFF);
         payload.push_back(queueEntry->address & 0xFF);
-        buildPacket(requestPacket, payload);
-        _packetIndex++;
-        getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
+        getResponse(payload, requestPacket, responsePacket, 1, 4);
         if (responsePacket.size() >= 13 && responsePacket.at(6) == 7) break;
         else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
           //Operation pending
@@ -235,9 +242,7 @@ void HM_LGW::processQueueEntry(int32_t index, int64_t id, std::shared_ptr<BaseLi
         payload.push_back(queueEntry->peerInfo.keyIndex);
         payload.push_back(queueEntry->peerInfo.wakeUp ? 1 : 0); //CCU2 sets this for wake up, too. No idea, what the meaning is.
         payload.push_back(0);
-        buildPacket(requestPacket, payload);
-        _packetIndex++;
-        getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
+        getResponse(payload, requestPacket, responsePacket, 1, 4);
         if (responsePacket.size() >= 21 && responsePacket.at(6) == 7) break;
         else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
           //Operation pending
@@ -262,9 +267,7 @@ void HM_LGW::processQueueEntry(int32_t index, int64_t id, std::shared_ptr<BaseLi
         payload.push_back(queueEntry->peerInfo.address & 0xFF);
         payload.push_back(0);
         payload.push_back(queueEntry->channel);
-        buildPacket(requestPacket, payload);
-        _packetIndex++;
-        getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
+        getResponse(payload, requestPacket, responsePacket, 1, 4);
         if (responsePacket.size() >= 9 && responsePacket.at(6) == 1) break;
         else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
           //Operation pending
@@ -286,9 +289,13 @@ void HM_LGW::processQueueEntry(int32_t index, int64_t id, std::shared_ptr<BaseLi
 void HM_LGW::sendPeers() {
   try {
     _peersMutex.lock();
+    std::vector<PeerInfo> peers;
+    peers.reserve(_peers.size());
     for (std::map<int32_t, PeerInfo>::iterator i = _peers.begin(); i != _peers.end(); ++i) {
-      sendPeer(i->second);
+      peers.push_back(i->second);
     }
+    //Peers already sent before the last reconnect are skipped unless the gateway was restarted (see doInit()).
+    _peerProvisioner->provision(peers, true);
     _initComplete = true; //Init complete is set here within _peersMutex, so there is no conflict with addPeer() and peers are not sent twice
     _out.printInfo("Info: Peer sending completed.");
   }
@@ -313,182 +320,7 @@ void HM_LGW::dutyCycleTest(int32_t destinationAddress) {
 
 void HM_LGW::sendPeer(PeerInfo &peerInfo) {
   try {
-    if (GD::bl->debugLevel > 4)
-      _out.printDebug(
-          "Debug: Sending peer to LGW \"" + _settings->id + "\": Address " + GD::bl->hf.getHexString(peerInfo.address, 6) + ", AES enabled " + std::to_string(peerInfo.aesEnabled) + ", AES map " + GD::bl->hf.getHexString(peerInfo.getAESChannelMap())
-              + ".");
-    for (int32_t i = 0; i < 2; i++) //The CCU sends this packet two or even more times, I don't know why
-    {
-      //Get current config
-      for (int32_t j = 0; j < 40; j++) {
-        std::vector<uint8_t> responsePacket;
-        std::vector<char> requestPacket;
-        std::vector<char> payload{1, 6};
-        payload.push_back(peerInfo.address >> 16);
-        payload.push_back((peerInfo.address >> 8) & 0xFF);
-        payload.push_back(peerInfo.address & 0xFF);
-        payload.push_back(0);
-        payload.push_back(0);
-        payload.push_back(0);
-        buildPacket(requestPacket, payload);
-        _packetIndex++;
-        getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-        if (responsePacket.size() >= 21 && responsePacket.at(6) == 7) break;
-        else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-          //Operation pending
-          std::this_thread::sleep_for(std::chrono::milliseconds(50));
-          continue;
-        }
-        if (j == 2) {
-          _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-          return;
-        }
-      }
-    }
-
-    //Reset all channels
-    for (int32_t j = 0; j < 40; j++) {
-      std::vector<uint8_t> responsePacket;
-      std::vector<char> requestPacket;
-      std::vector<char> payload{1, 0xA};
-      payload.push_back(peerInfo.address >> 16);
-      payload.push_back((peerInfo.address >> 8) & 0xFF);
-      payload.push_back(peerInfo.address & 0xFF);
-      payload.push_back(0);
-
-      for (std::map<int32_t, bool>::iterator k = peerInfo.aesChannels.begin(); k != peerInfo.aesChannels.end(); ++k) {
-        payload.push_back(k->first);
-      }
-      buildPacket(requestPacket, payload);
-      _packetIndex++;
-      getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-      if (responsePacket.size() >= 9 && responsePacket.at(6) == 1) break;
-      else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-        //Operation pending
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        continue;
-      }
-      if (j == 2) {
-        _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-        return;
-      }
-    }
-
-    //Get current config again
-    for (int32_t j = 0; j < 40; j++) {
-      std::vector<uint8_t> responsePacket;
-      std::vector<char> requestPacket;
-      std::vector<char> payload{1, 6};
-      payload.push_back(peerInfo.address >> 16);
-      payload.push_back((peerInfo.address >> 8) & 0xFF);
-      payload.push_back(peerInfo.address & 0xFF);
-      payload.push_back(0);
-      payload.push_back(0);
-      payload.push_back(0);
-      buildPacket(requestPacket, payload);
-      _packetIndex++;
-      getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-      if (responsePacket.size() >= 21 && responsePacket.at(6) == 7) break;
-      else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-        //Operation pending
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        continue;
-      }
-      if (j == 2) {
-        _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-        return;
-      }
-    }
-
-    if (peerInfo.wakeUp) {
-      //Enable sending of wake up packet or just request config again?
-      for (int32_t j = 0; j < 40; j++) {
-        std::vector<uint8_t> responsePacket;
-        std::vector<char> requestPacket;
-        std::vector<char> payload{1, 6};
-        payload.push_back(peerInfo.address >> 16);
-        payload.push_back((peerInfo.address >> 8) & 0xFF);
-        payload.push_back(peerInfo.address & 0xFF);
-        payload.push_back(0);
-        payload.push_back(1);
-        payload.push_back(0);
-        buildPacket(requestPacket, payload);
-        _packetIndex++;
-        getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-        if (responsePacket.size() >= 21 && responsePacket.at(6) == 7) break;
-        else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-          //Operation pending
-          std::this_thread::sleep_for(std::chrono::milliseconds(50));
-          continue;
-        }
-        if (j == 2) {
-          _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-          return;
-        }
-      }
-    }
-
-    //Set key index and enable sending of wake up packet.
-    for (int32_t j = 0; j < 40; j++) {
-      std::vector<uint8_t> responsePacket;
-      std::vector<char> requestPacket;
-      std::vector<char> payload{1, 6};
-      payload.push_back(peerInfo.address >> 16);
-      payload.push_back((peerInfo.address >> 8) & 0xFF);
-      payload.push_back(peerInfo.address & 0xFF);
-      payload.push_back(peerInfo.keyIndex);
-      payload.push_back(peerInfo.wakeUp ? 1 : 0);
-      payload.push_back(0);
-      buildPacket(requestPacket, payload);
-      _packetIndex++;
-      getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-      if (responsePacket.size() >= 21 && responsePacket.at(6) == 7) break;
-      else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-        //Operation pending
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        continue;
-      }
-      if (j == 2) {
-        _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-        return;
-      }
-    }
-
-    //Enable AES
-    if (peerInfo.aesEnabled) {
-      //Delete old configuration
-      for (int32_t j = 0; j < 40; j++) {
-        std::vector<uint8_t> responsePacket;
-        std::vector<char> requestPacket;
-        std::vector<char> payload{1, 9};
-        payload.push_back(peerInfo.address >> 16);
-        payload.push_back((peerInfo.address >> 8) & 0xFF);
-        payload.push_back(peerInfo.address & 0xFF);
-        payload.push_back(0);
-
-        bool aesEnabled = false;
-        for (std::map<int32_t, bool>::iterator k = peerInfo.aesChannels.begin(); k != peerInfo.aesChannels.end(); ++k) {
-          if (k->second) {
-            aesEnabled = true;
-            payload.push_back(k->first);
-          }
-        }
-        if (!aesEnabled) break;
-        buildPacket(requestPacket, payload);
-        _packetIndex++;
-        getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-        if (responsePacket.size() >= 9 && responsePacket.at(6) == 1) break;
-        else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-          //Operation pending
-          std::this_thread::sleep_for(std::chrono::milliseconds(50));
-          continue;
-        }
-        if (j == 2) {
-          _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-          return;
-        }
-      }
-    }
+    _peerProvisioner->provision(std::vector<PeerInfo>{peerInfo}, false);
   }
   catch (const std::exception &ex) {
     _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
@@ -549,6 +381,7 @@ void HM_LGW::removePeer(int32_t address) {
       return;
     }
     _peers.erase(address);
+    _peerProvisioner->remove(address);
 
     if (_initComplete) {
       int64_t id;
@@ -606,23 +439,43 @@ void HM_LGW::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> packet) {
       return;
     }
 
-    std::vector<char> packetBytes = bidCoSPacket->byteArraySigned();
-    if (_bl->debugLevel >= 4) _out.printInfo("Info: Sending (" + _settings->id + "): " + _bl->hf.getHexString(packetBytes));
+    BidCoSPacket::FrameBuffer packetBytes;
+    uint32_t packetSize = bidCoSPacket->byteArray(packetBytes.data(), packetBytes.size());
+    if (packetSize == 0) return;
+    if (_bl->debugLevel >= 4) _out.printInfo("Info: Sending (" + _settings->id + "): " + bidCoSPacket->hexString());
+
+    std::vector<char> payload;
+    payload.reserve(5 + packetSize - 1);
+    payload.push_back(1);
+    payload.push_back(2);
+    payload.push_back(0);
+    payload.push_back(0);
+    if (!_settings->sendFix) payload.push_back((bidCoSPacket->controlByte() & 0x10) ? 1 : 0);
+    payload.insert(payload.end(), packetBytes.begin() + 1, packetBytes.begin() + packetSize);
+
+    uint32_t airtime = AirtimeScheduler::estimateAirtime(bidCoSPacket);
+    AirtimeScheduler::TrafficClass trafficClass = AirtimeScheduler::classify(bidCoSPacket);
 
+    //Only packets to the same peer are serialized. Packets to other peers are sent while we are waiting for the response.
+    std::shared_ptr<std::mutex> destinationMutex = getDestinationMutex(bidCoSPacket->destinationAddress());
+    std::lock_guard<std::mutex> destinationGuard(*destinationMutex);
     for (int32_t j = 0; j < 40; j++) {
       std::vector<uint8_t> responsePacket;
-      std::vector<char> requestPacket;
-      std::vector<char> payload;
-      payload.reserve(5 + packetBytes.size() - 1);
-      payload.push_back(1);
-      payload.push_back(2);
-      payload.push_back(0);
-      payload.push_back(0);
-      if (!_settings->sendFix) payload.push_back((bidCoSPacket->controlByte() & 0x10) ? 1 : 0);
-      payload.insert(payload.end(), packetBytes.begin() + 1, packetBytes.end());
-      buildPacket(requestPacket, payload);
-      _packetIndex++;
-      getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
+      auto response = std::make_shared<std::promise<std::vector<uint8_t>>>();
+      std::future<std::vector<uint8_t>> responseFuture = response->get_future();
+      if (sendRequestAsync(payload, 1, 4, 10000, [response](std::vector<uint8_t> &result) { response->set_value(result); }, trafficClass, airtime) != -1) {
+        //The request is completed with an empty response by checkRequestTimeouts() when its deadline passed. The wait is limited by the deadline
+        //as well, so the sender doesn't hang if the callback is never called.
+        int64_t deadline = BaseLib::HelperFunctions::getTime() + 10000 + 1000;
+        std::future_status status = std::future_status::timeout;
+        while ((status = responseFuture.wait_for(std::chrono::milliseconds(100))) != std::future_status::ready && BaseLib::HelperFunctions::getTime() < deadline) {
+          checkRequestTimeouts();
+        }
+        if (status == std::future_status::ready) responsePacket = responseFuture.get();
+        if (responsePacket.empty()) _out.printError("Error: No response received to packet: " + bidCoSPacket->hexString());
+      }
+      //Everything but "operation pending" means the gateway put the frame on air.
+      if (responsePacket.size() >= 9 && responsePacket.at(6) != 8) _airtimeScheduler.record(airtime);
       if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
         //Resend
@@ -633,17 +486,17 @@ void HM_LGW::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> packet) {
           //0x0D is returned, when there is no response to the A003 packet and if the 8002
           //packet doesn't match
           //Example: FD000501BC040D025E14
-          _out.printInfo("Info: AES handshake failed for packet, because either the response data of the last handshake packet didn't match or the last handshake packet wasn't received: " + _bl->hf.getHexString(packetBytes));
+          _out.printInfo("Info: AES handshake failed for packet, because either the response data of the last handshake packet didn't match or the last handshake packet wasn't received: " + bidCoSPacket->hexString());
           return;
         } else if (responsePacket.at(6) == 0x03) {
           //Example: FD001001B3040302391A8002282BE6FD26EF00C54D
-          _out.printDebug("Debug: Packet was sent successfully: " + _bl->hf.getHexString(packetBytes));
+          _out.printDebug("Debug: Packet was sent successfully: " + bidCoSPacket->hexString());
         } else if (responsePacket.at(6) == 0x0C) {
           //Example: FD00140168040C0228128002282BE6FD26EF00938ABE1C163D
-          _out.printDebug("Debug: Packet was sent successfully and AES handshake was successful: " + _bl->hf.getHexString(packetBytes));
+          _out.printDebug("Debug: Packet was sent successfully and AES handshake was successful: " + bidCoSPacket->hexString());
         }
         if (responsePacket.size() == 9) {
-          _out.printDebug("Debug: Packet was sent successfully: " + _bl->hf.getHexString(packetBytes));
+          _out.printDebug("Debug: Packet was sent successfully: " + bidCoSPacket->hexString());
           break;
         }
         parsePacket(responsePacket);
@@ -653,11 +506,11 @@ void HM_LGW::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> packet) {
         //NACK (0404) is returned
         //NACK is sometimes also returned when the AES handshake wasn't successful (i. e.
         //the handshake after sending a wake up packet)
-        _out.printInfo("Info: No answer to packet " + _bl->hf.getHexString(packetBytes));
+        _out.printInfo("Info: No answer to packet " + bidCoSPacket->hexString());
         return;
       }
       if (j == 2) {
-        _out.printInfo("Info: No response from HM-LGW to packet " + _bl->hf.getHexString(packetBytes));
+        _out.printInfo("Info: No response from HM-LGW to packet " + bidCoSPacket->hexString());
         return;
       }
     }
@@ -669,31 +522,230 @@ void HM_LGW::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> packet) {
   }
 }
 
-void HM_LGW::getResponse(const std::vector<char> &packet, std::vector<uint8_t> &response, uint8_t messageCounter, uint8_t responseControlByte, uint8_t responseType) {
+void HM_LGW::getResponse(const std::vector<char> &payload, std::vector<char> &requestPacket, std::vector<uint8_t> &response, uint8_t responseControlByte, uint8_t responseType, int32_t requestIndex) {
   try {
-    if (packet.size() < 8 || _stopped) return;
+    if (payload.size() < 2 || _stopped) return;
     std::lock_guard<std::mutex> getResponseGuard(_getResponseMutex);
-    std::shared_ptr<Request> request(new Request(responseControlByte, responseType));
-    _requestsMutex.lock();
-    _requests[messageCounter] = request;
-    _requestsMutex.unlock();
-    std::unique_lock<std::mutex> lock(request->mutex);
+    std::shared_ptr<Request> request = std::make_shared<Request>(responseControlByte, responseType);
+    int32_t packetIndex = sendWithPacketIndex(payload, requestPacket, request, requestIndex);
+    if (packetIndex == -1) {
+      _out.printError("Error: Could not send packet, because no message counter is available.");
+      return;
+    }
+    {
+      std::unique_lock<std::mutex> lock(request->mutex);
+      if (!request->conditionVariable.wait_for(lock, std::chrono::milliseconds(10000), [&] { return request->mutexReady; })) {
+        _out.printError("Error: No response received to packet: " + _bl->hf.getHexString(requestPacket));
+      }
+      response = request->response;
+    }
+
+    std::lock_guard<std::mutex> requestsGuard(_requestsMutex);
+    auto requestIterator = _requests.find(requestIndex == -1 ? packetIndex : requestIndex);
+    if (requestIterator != _requests.end() && requestIterator->second == request) _requests.erase(requestIterator);
+  }
+  catch (const std::exception &ex) {
+    _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+int32_t HM_LGW::sendWithPacketIndex(const std::vector<char> &payload, std::vector<char> &packet, const std::shared_ptr<Request> &request, int32_t requestIndex) {
+  try {
+    std::lock_guard<std::mutex> packetIndexGuard(_packetIndexMutex);
+    uint8_t packetIndex = 0;
+    {
+      std::lock_guard<std::mutex> requestsGuard(_requestsMutex);
+      //Don't reuse the message counter of a request that is still in flight
+      int32_t i = 0;
+      for (; i < 256 && _requests.find(_packetIndex) != _requests.end(); i++) {
+        _packetIndex++;
+      }
+      if (i == 256) return -1;
+      packetIndex = _packetIndex;
+      if (request) {
+        uint8_t index = requestIndex == -1 ? packetIndex : (uint8_t)requestIndex;
+        if (_requests.find(index) != _requests.end()) return -1;
+        _requests.emplace(index, request);
+      }
+    }
+    buildPacket(packet, payload);
+    _packetIndex++;
     send(packet, false);
-    if (!request->conditionVariable.wait_for(lock, std::chrono::milliseconds(10000), [&] { return request->mutexReady; })) {
-      _out.printError("Error: No response received to packet: " + _bl->hf.getHexString(packet));
+    return packetIndex;
+  }
+  catch (const std::exception &ex) {
+    _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+  return -1;
+}
+
+uint8_t HM_LGW::sendRequest(const std::vector<char> &payload, uint8_t responseControlByte, uint8_t responseType) {
+  uint8_t packetIndex = 0;
+  try {
+    std::vector<char> requestPacket;
+    int32_t result = sendWithPacketIndex(payload, requestPacket, std::make_shared<Request>(responseControlByte, responseType));
+    if (result != -1) packetIndex = result;
+  }
+  catch (const std::exception &ex) {
+    _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+  return packetIndex;
+}
+
+bool HM_LGW::waitForResponse(uint8_t packetIndex, int64_t timeout, std::vector<uint8_t> &response) {
+  try {
+    std::shared_ptr<Request> request;
+    {
+      std::lock_guard<std::mutex> requestsGuard(_requestsMutex);
+      auto requestIterator = _requests.find(packetIndex);
+      if (requestIterator == _requests.end()) return false;
+      request = requestIterator->second;
     }
+    std::unique_lock<std::mutex> lock(request->mutex);
+    if (!request->conditionVariable.wait_for(lock, std::chrono::milliseconds(timeout), [&] { return request->mutexReady; })) return false;
     response = request->response;
+    return true;
+  }
+  catch (const std::exception &ex) {
+    _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+  return false;
+}
 
-    _requestsMutex.lock();
-    _requests.erase(messageCounter);
-    _requestsMutex.unlock();
+void HM_LGW::removeRequest(uint8_t packetIndex) {
+  try {
+    std::lock_guard<std::mutex> requestsGuard(_requestsMutex);
+    _requests.erase(packetIndex);
+  }
+  catch (const std::exception &ex) {
+    _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+int32_t HM_LGW::sendRequestAsync(const std::vector<char> &payload, uint8_t responseControlByte, uint8_t responseType, int64_t timeout, RequestCallback callback, AirtimeScheduler::TrafficClass trafficClass, uint32_t airtime) {
+  try {
+    {
+      std::unique_lock<std::mutex> requestWindowGuard(_requestWindowMutex);
+      while (_requestsInFlight >= _requestWindow) {
+        if (_stopped) return -1;
+        requestWindowGuard.unlock();
+        checkRequestTimeouts();
+        requestWindowGuard.lock();
+        _requestWindowConditionVariable.wait_for(requestWindowGuard, std::chrono::milliseconds(100), [&] { return _requestsInFlight < _requestWindow || _stopped; });
+      }
+      if (_stopped) return -1;
+      _requestsInFlight++;
+    }
+
+    std::shared_ptr<Request> request = std::make_shared<Request>(responseControlByte, responseType);
+    request->callback = std::move(callback);
+    request->deadline = BaseLib::HelperFunctions::getTime() + timeout;
+
+    std::vector<char> requestPacket;
+    int32_t packetIndex = -1;
+    if (airtime > 0) {
+      //The transmit slot is only held while the packet is written, not while waiting for the response.
+      AirtimeScheduler::Slot airtimeSlot(_airtimeScheduler, trafficClass, airtime);
+      packetIndex = sendWithPacketIndex(payload, requestPacket, request);
+    } else packetIndex = sendWithPacketIndex(payload, requestPacket, request);
+    if (packetIndex == -1) {
+      {
+        std::lock_guard<std::mutex> requestWindowGuard(_requestWindowMutex);
+        _requestsInFlight--;
+      }
+      _requestWindowConditionVariable.notify_one();
+    }
+    return packetIndex;
+  }
+  catch (const std::exception &ex) {
+    _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+  return -1;
+}
+
+void HM_LGW::finishRequest(uint8_t packetIndex, std::vector<uint8_t> &response) {
+  try {
+    std::shared_ptr<Request> request;
+    {
+      std::lock_guard<std::mutex> requestsGuard(_requestsMutex);
+      auto requestIterator = _requests.find(packetIndex);
+      if (requestIterator == _requests.end() || !requestIterator->second->callback) return;
+      request = requestIterator->second;
+      _requests.erase(requestIterator);
+    }
+    {
+      std::lock_guard<std::mutex> requestWindowGuard(_requestWindowMutex);
+      _requestsInFlight--;
+    }
+    _requestWindowConditionVariable.notify_one();
+    request->callback(response);
+  }
+  catch (const std::exception &ex) {
+    _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void HM_LGW::checkRequestTimeouts() {
+  try {
+    std::vector<std::shared_ptr<Request>> timedOutRequests;
+    int64_t time = BaseLib::HelperFunctions::getTime();
+    {
+      std::lock_guard<std::mutex> requestsGuard(_requestsMutex);
+      for (auto requestIterator = _requests.begin(); requestIterator != _requests.end();) {
+        if (requestIterator->second->callback && requestIterator->second->deadline <= time) {
+          timedOutRequests.push_back(requestIterator->second);
+          requestIterator = _requests.erase(requestIterator);
+        } else ++requestIterator;
+      }
+    }
+    if (timedOutRequests.empty()) return;
+    {
+      std::lock_guard<std::mutex> requestWindowGuard(_requestWindowMutex);
+      _requestsInFlight -= timedOutRequests.size();
+    }
+    _requestWindowConditionVariable.notify_all();
+    for (auto &request : timedOutRequests) {
+      std::vector<uint8_t> emptyResponse;
+      request->callback(emptyResponse);
+    }
+  }
+  catch (const std::exception &ex) {
+    _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
+void HM_LGW::cancelRequests() {
+  try {
+    std::vector<std::shared_ptr<Request>> asyncRequests;
+    {
+      std::lock_guard<std::mutex> requestsGuard(_requestsMutex);
+      for (auto &request : _requests) {
+        if (request.second->callback) asyncRequests.push_back(request.second);
+      }
+      _requests.clear();
+    }
+    {
+      std::lock_guard<std::mutex> requestWindowGuard(_requestWindowMutex);
+      _requestsInFlight -= asyncRequests.size();
+    }
+    _requestWindowConditionVariable.notify_all();
+    for (auto &request : asyncRequests) {
+      std::vector<uint8_t> emptyResponse;
+      request->callback(emptyResponse);
+    }
   }
   catch (const std::exception &ex) {
     _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
-    _requestsMutex.unlock();
   }
 }
 
+std::shared_ptr<std::mutex> HM_LGW::getDestinationMutex(int32_t address) {
+  std::lock_guard<std::mutex> destinationMutexesGuard(_destinationMutexesMutex);
+  std::shared_ptr<std::mutex> &destinationMutex = _destinationMutexes[address];
+  if (!destinationMutex) destinationMutex = std::make_shared<std::mutex>();
+  return destinationMutex;
+}
+
 void HM_LGW::send(std::string hexString, bool raw) {
   try {
     if (hexString.empty()) return;
@@ -816,15 +868,15 @@ void HM_LGW::doInit() {
     std::vector<uint8_t> responsePacket;
     std::vector<char> requestPacket;
     std::vector<char> payload{0, 3};
-    buildPacket(requestPacket, payload);
-    _packetIndex++;
-    getResponse(requestPacket, responsePacket, 0, 0, 0);
+    getResponse(payload, requestPacket, responsePacket, 0, 0, 0);
     if (responsePacket.size() == 17) {
       packetString.clear();
       packetString.insert(packetString.end(), responsePacket.begin() + 6, responsePacket.end() - 2);
       if (packetString == "Co_CPU_BL") {
         _out.printDebug("Debug: Co_CPU_BL packet received.");
         cpuBLPacket = true;
+        //The gateway was restarted and lost its peer table.
+        _peerProvisioner->reset();
       }
     } else if (responsePacket.size() == 18) {
       packetString.clear();
@@ -847,9 +899,7 @@ void HM_LGW::doInit() {
         if (_stopped) return;
         responsePacket.clear();
         requestPacket.clear();
-        buildPacket(requestPacket, payload);
-        _packetIndex++;
-        getResponse(requestPacket, responsePacket, 0, 0, 0);
+        getResponse(payload, requestPacket, responsePacket, 0, 0, 0);
         if (responsePacket.size() == 18) {
           packetString.clear();
           packetString.insert(packetString.end(), responsePacket.begin() + 6, responsePacket.end() - 2);
@@ -888,9 +938,7 @@ void HM_LGW::doInit() {
     payload.clear();
     payload.push_back(0);
     payload.push_back(2);
-    buildPacket(requestPacket, payload);
-    _packetIndex++;
-    getResponse(requestPacket, responsePacket, _packetIndex - 1, 0, 4);
+    getResponse(payload, requestPacket, responsePacket, 0, 4);
     if (responsePacket.size() < 9 || responsePacket.at(6) == 4) {
       if (responsePacket.size() >= 9)
         _out.printError("Error: NACK received in response to init sequence packet (" + BaseLib::HelperFunctions::getHexString(requestPacket) + "). Response was: " + BaseLib::HelperFunctions::getHexString(responsePacket) + ". Reconnecting...");
@@ -907,9 +955,7 @@ void HM_LGW::doInit() {
     payload.push_back(0);
     payload.push_back(0xA);
     payload.push_back(0);
-    buildPacket(requestPacket, payload);
-    _packetIndex++;
-    getResponse(requestPacket, responsePacket, _packetIndex - 1, 0, 4);
+    getResponse(payload, requestPacket, responsePacket, 0, 4);
     if (responsePacket.size() < 9 || responsePacket.at(6) == 4) {
       if (responsePacket.size() >= 9)
         _out.printError("Error: NACK received in response to init sequence packet (" + BaseLib::HelperFunctions::getHexString(requestPacket) + "). Response was: " + BaseLib::HelperFunctions::getHexString(responsePacket) + ". Reconnecting...");
@@ -925,9 +971,7 @@ void HM_LGW::doInit() {
     payload.reserve(2);
     payload.push_back(0);
     payload.push_back(0xB);
-    buildPacket(requestPacket, payload);
-    _packetIndex++;
-    getResponse(requestPacket, responsePacket, _packetIndex - 1, 0, 4);
+    getResponse(payload, requestPacket, responsePacket, 0, 4);
     if (responsePacket.size() < 19 || responsePacket.at(6) == 4) {
       if (responsePacket.size() >= 9)
         _out.printError("Error: NACK received in response to init sequence packet (" + BaseLib::HelperFunctions::getHexString(requestPacket) + "). Response was: " + BaseLib::HelperFunctions::getHexString(responsePacket) + ". Reconnecting...");
@@ -957,9 +1001,7 @@ void HM_LGW::doInit() {
     payload.push_back((time >> 8) & 0xFF);
     payload.push_back(time & 0xFF);
     payload.push_back(localTime.tm_gmtoff / 1800);
-    buildPacket(requestPacket, payload);
-    _packetIndex++;
-    getResponse(requestPacket, responsePacket, _packetIndex - 1, 0, 4);
+    getResponse(payload, requestPacket, responsePacket, 0, 4);
     if (responsePacket.size() < 9 || responsePacket.at(6) == 4) {
       if (responsePacket.size() >= 9)
         _out.printError("Error: NACK received in response to init sequence packet (" + BaseLib::HelperFunctions::getHexString(requestPacket) + "). Response was: " + BaseLib::HelperFunctions::getHexString(responsePacket) + ". Reconnecting...");
@@ -981,9 +1023,7 @@ void HM_LGW::doInit() {
       payload.insert(payload.end(), _rfKey.begin(), _rfKey.end());
       payload.push_back(_currentRfKeyIndex);
     }
-    buildPacket(requestPacket, payload);
-    _packetIndex++;
-    getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
+    getResponse(payload, requestPacket, responsePacket, 1, 4);
     if (responsePacket.size() < 9 || responsePacket.at(6) == 4) {
       if (responsePacket.size() >= 9)
         _out.printError("Error: NACK received in response to init sequence packet (" + BaseLib::HelperFunctions::getHexString(requestPacket) + "). Response was: " + BaseLib::HelperFunctions::getHexString(responsePacket) + ". Reconnecting...");
@@ -1001,9 +1041,7 @@ void HM_LGW::doInit() {
       payload.push_back(0xF);
       payload.insert(payload.end(), _oldRfKey.begin(), _oldRfKey.end());
       payload.push_back(_currentRfKeyIndex - 1);
-      buildPacket(requestPacket, payload);
-      _packetIndex++;
-      getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
+      getResponse(payload, requestPacket, responsePacket, 1, 4);
       if (responsePacket.size() < 9 || responsePacket.at(6) == 4) {
         if (responsePacket.size() >= 9)
           _out.printError("Error: NACK received in response to init sequence packet (" + BaseLib::HelperFunctions::getHexString(requestPacket) + "). Response was: " + BaseLib::HelperFunctions::getHexString(responsePacket) + ". Reconnecting...");
@@ -1023,9 +1061,7 @@ void HM_LGW::doInit() {
     payload.push_back(_myAddress >> 16);
     payload.push_back((_myAddress >> 8) & 0xFF);
     payload.push_back(_myAddress & 0xFF);
-    buildPacket(requestPacket, payload);
-    _packetIndex++;
-    getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
+    getResponse(payload, requestPacket, responsePacket, 1, 4);
     if (responsePacket.size() < 9 || responsePacket.at(6) == 4) {
       if (responsePacket.size() >= 9)
         _out.printError("Error: NACK received in response to init sequence packet (" + BaseLib::HelperFunctions::getHexString(requestPacket) + "). Response was: " + BaseLib::HelperFunctions::getHexString(responsePacket) + ". Reconnecting...");
@@ -1041,9 +1077,7 @@ void HM_LGW::doInit() {
     payload.reserve(2);
     payload.push_back(0);
     payload.push_back(6);
-    buildPacket(requestPacket, payload);
-    _packetIndex++;
-    getResponse(requestPacket, responsePacket, _packetIndex - 1, 0, 4);
+    getResponse(payload, requestPacket, responsePacket, 0, 4);
     if (responsePacket.size() < 9 || responsePacket.at(6) == 4) {
       if (responsePacket.size() >= 9)
         _out.printError("Error: NACK received in response to init sequence packet (" + BaseLib::HelperFunctions::getHexString(requestPacket) + "). Response was: " + BaseLib::HelperFunctions::getHexString(responsePacket) + ". Reconnecting...");
@@ -1115,9 +1149,8 @@ void HM_LGW::reconnect() {
     _socketKeepAlive->Shutdown();
     GD::bl->threadManager.join(_initThread);
     aesInit();
-    _requestsMutex.lock();
-    _requests.clear();
-    _requestsMutex.unlock();
+    cancelRequests();
+    _frameDecoder.reset();
     _initStarted = false;
     _initComplete = false;
     _initCompleteKeepAlive = false;
@@ -1153,9 +1186,7 @@ void HM_LGW::stopListening() {
     _stopped = true;
     _sendMutex.unlock(); //In case it is deadlocked - shouldn't happen of course
     _sendMutexKeepAlive.unlock();
-    _requestsMutex.lock();
-    _requests.clear();
-    _requestsMutex.unlock();
+    cancelRequests();
     _initStarted = false;
     _initComplete = false;
     _initCompleteKeepAlive = false;
@@ -1292,16 +1323,16 @@ std::vector<char> HM_LGW::encrypt(const std::vector<char> &data) {
   return encryptedData;
 }
 
-std::vector<uint8_t> HM_LGW::decrypt(std::vector<uint8_t> &data) {
-  std::vector<uint8_t> decryptedData(data.size());
-  if (!_decryptHandle) return decryptedData;
+bool HM_LGW::decrypt(std::vector<uint8_t> &data) {
+  if (!_decryptHandle || data.empty()) return false;
   gcry_error_t result;
-  if ((result = gcry_cipher_decrypt(_decryptHandle, &decryptedData.at(0), data.size(), &data.at(0), data.size())) != GPG_ERR_NO_ERROR) {
+  //Decrypt in place
+  if ((result = gcry_cipher_decrypt(_decryptHandle, data.data(), data.size(), nullptr, 0)) != GPG_ERR_NO_ERROR) {
     _out.printError("Error decrypting data: " + BaseLib::Security::Gcrypt::getError(result));
     _stopCallbackThread = true;
-    return std::vector<uint8_t>();
+    return false;
   }
-  return decryptedData;
+  return true;
 }
 
 std::vector<char> HM_LGW::encryptKeepAlive(std::vector<char> &data) {
@@ -1345,9 +1376,7 @@ void HM_LGW::sendKeepAlivePacket1() {
       _lastKeepAlive1 = BaseLib::HelperFunctions::getTimeSeconds();
       std::vector<char> packet;
       std::vector<char> payload{0, 8};
-      buildPacket(packet, payload);
-      _packetIndex++;
-      send(packet, false);
+      sendWithPacketIndex(payload, packet);
     }
   }
   catch (const std::exception &ex) {
@@ -1380,7 +1409,6 @@ void HM_LGW::sendKeepAlivePacket2() {
 
 void HM_LGW::sendTimePacket() {
   try {
-    std::lock_guard<std::mutex> getResponseGuard(_getResponseMutex);
     const auto timePoint = std::chrono::system_clock::now();
     time_t t = std::chrono::system_clock::to_time_t(timePoint);
     std::tm localTime;
@@ -1393,9 +1421,7 @@ void HM_LGW::sendTimePacket() {
     payload.push_back(time & 0xFF);
     payload.push_back(localTime.tm_gmtoff / 1800);
     std::vector<char> packet;
-    buildPacket(packet, payload);
-    _packetIndex++;
-    send(packet, false);
+    sendWithPacketIndex(payload, packet);
     _lastTimePacket = BaseLib::HelperFunctions::getTimeSeconds();
   }
   catch (const std::exception &ex) {
@@ -1427,6 +1453,7 @@ void HM_LGW::listen() {
           reconnect();
           continue;
         }
+        checkRequestTimeouts();
         try {
           do {
             if (BaseLib::HelperFunctions::getTimeSeconds() - _lastTimePacket > 1800) sendTimePacket();
@@ -1773,11 +1800,10 @@ void HM_LGW::escapePacket(const std::vector<char> &unescapedPacket, std::vector<
   }
 }
 
-void HM_LGW::processPacket(std::vector<uint8_t> &packet) {
+void HM_LGW::processPacket(std::vector<uint8_t> &packet, uint16_t crc) {
   try {
     _out.printDebug(std::string("Debug: Packet received from HM-LGW on port " + _settings->port + ": " + _bl->hf.getHexString(packet)));
     if (packet.size() < 8) return;
-    uint16_t crc = _crc.calculate(packet, true);
     if ((packet.at(packet.size() - 2) != (crc >> 8) || packet.at(packet.size() - 1) != (crc & 0xFF))) {
       if (_firstPacket) {
         _firstPacket = false;
@@ -1793,6 +1819,10 @@ void HM_LGW::processPacket(std::vector<uint8_t> &packet) {
         std::shared_ptr<Request> request = _requests.at(packet.at(4));
         _requestsMutex.unlock();
         if (packet.at(3) == request->getResponseControlByte() && packet.at(5) == request->getResponseType()) {
+          if (request->callback) {
+            finishRequest(packet.at(4), packet);
+            return;
+          }
           request->response = packet;
           {
             std::lock_guard<std::mutex> lock(request->mutex);
@@ -1804,6 +1834,10 @@ void HM_LGW::processPacket(std::vector<uint8_t> &packet) {
           //E. g.: FD0004000004001938
         else if (packet.size() == 9 && packet.at(6) == 0 && packet.at(5) == 4 && packet.at(3) == 0) {
           _out.printError("Error: Something is wrong with your HM-LGW. You probably need to replace it. Check if it works with a CCU.");
+          if (request->callback) {
+            finishRequest(packet.at(4), packet);
+            return;
+          }
           request->response = packet;
           {
             std::lock_guard<std::mutex> lock(request->mutex);
@@ -1828,20 +1862,20 @@ void HM_LGW::processData(std::vector<uint8_t> &data) {
       aesKeyExchange(data);
       return;
     }
-    std::vector<uint8_t> decryptedData = _settings->lanKey.empty() ? data : decrypt(data);
-    if (decryptedData.size() < 8) //8 is minimum size fd
+    if (!_settings->lanKey.empty() && !decrypt(data)) return;
+    if (data.size() < 8) //8 is minimum size fd
     {
-      _out.printWarning("Warning: Too small packet received on port " + _settings->port + ": " + _bl->hf.getHexString(decryptedData));
+      _out.printWarning("Warning: Too small packet received on port " + _settings->port + ": " + _bl->hf.getHexString(data));
       return;
     }
     if (!_initComplete && _packetIndex == 0) {
-      if (decryptedData.at(0) == 'H') {
-        std::string initPacket(decryptedData.begin(), decryptedData.end());
+      if (data.at(0) == 'H') {
+        std::string initPacket(data.begin(), data.end());
         BaseLib::HelperFunctions::trim(initPacket);
         _out.printInfo("Info: Init packet received: " + initPacket);
         return;
-      } else if (decryptedData.at(0) == 'S') {
-        std::string packetString((char *)&decryptedData.at(0), decryptedData.size());
+      } else if (data.at(0) == 'S') {
+        std::string packetString((char *)&data.at(0), data.size());
         if (_bl->debugLevel >= 5) {
           std::string temp = packetString;
           _bl->hf.stringReplace(temp, "\r\n", "\\r\\n");
@@ -1849,7 +1883,7 @@ void HM_LGW::processData(std::vector<uint8_t> &data) {
         }
         _requestsMutex.lock();
         if (_requests.find(0) != _requests.end()) {
-          _requests.at(0)->response = decryptedData;
+          _requests.at(0)->response = data;
           {
             std::lock_guard<std::mutex> lock(_requests.at(0)->mutex);
             _requests.at(0)->mutexReady = true;
@@ -1861,33 +1895,10 @@ void HM_LGW::processData(std::vector<uint8_t> &data) {
       }
     }
 
-    std::vector<uint8_t> packet;
-    if (!_packetBuffer.empty()) packet = _packetBuffer;
-    for (std::vector<uint8_t>::iterator i = decryptedData.begin(); i != decryptedData.end(); ++i) {
-      if (!packet.empty() && *i == 0xfd) {
-        processPacket(packet);
-        packet.clear();
-        _escapeByte = false;
-      }
-      if (*i == 0xfc) {
-        _escapeByte = true;
-        continue;
-      }
-      if (_escapeByte) {
-        packet.push_back(*i | 0x80);
-        _escapeByte = false;
-      } else packet.push_back(*i);
-    }
-    int32_t size = (packet.size() > 5) ? (((int32_t)packet.at(1)) << 8) + packet.at(2) + 5 : 0;
-    if (size < 0) size = 0;
-    if (size > 0 && size < 8) _out.printInfo("Info: Ignoring too small packet on port " + _settings->port + ": " + _bl->hf.getHexString(data));
-    else if (size > 255) _out.printWarning("Warning: Too large packet received: " + _bl->hf.getHexString(data));
-    else if (packet.size() < 8 || packet.size() < (unsigned)size) _packetBuffer = packet;
-    else {
-      processPacket(packet);
-      _packetBuffer.clear();
-      _escapeByte = false;
-    }
+    _frameDecoder.decode(data.data(), data.size(), [&](std::vector<uint8_t> &packet, uint16_t crc) { processPacket(packet, crc); }, [&](EscapedFrameDecoder::Error error, std::vector<uint8_t> &header) {
+      if (error == EscapedFrameDecoder::Error::tooSmall) _out.printInfo("Info: Ignoring too small packet on port " + _settings->port + ": " + _bl->hf.getHexString(header));
+      else _out.printWarning("Warning: Too large packet received: " + _bl->hf.getHexString(header));
+    });
   }
   catch (const std::exception &ex) {
     _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
@@ -1952,26 +1963,32 @@ void HM_LGW::parsePacket(std::vector<uint8_t> &packet) {
       if (_bl->debugLevel >= 5) _out.printDebug("Debug: Keep alive response received on port " + _settings->port + ".");
       _lastKeepAliveResponse1 = BaseLib::HelperFunctions::getTimeSeconds();
     } else if ((packet.at(5) == 5 || (packet.at(5) == 4 && packet.at(6) != 7)) && packet.at(3) == 1 && packet.size() >= 20) {
-      std::vector<uint8_t> binaryPacket({(uint8_t)(packet.size() - 11)});
-      binaryPacket.insert(binaryPacket.end(), packet.begin() + 9, packet.end() - 2);
+      uint32_t binaryPacketSize = packet.size() - 9; //Length byte + packet + RSSI byte
+      if (binaryPacketSize > BidCoSPacket::maxFrameSize) {
+        _out.printWarning("Warning: Too large packet received: " + BaseLib::HelperFunctions::getHexString(packet));
+        return;
+      }
+      BidCoSPacket::FrameBuffer binaryPacket;
+      binaryPacket[0] = (uint8_t)(packet.size() - 11);
+      std::copy(packet.begin() + 9, packet.end() - 2, binaryPacket.begin() + 1);
       int32_t rssi = packet.at(8); //Range should be from 0x0B to 0x8A. 0x0B is -11dBm 0x8A -138dBm.
       rssi *= -1;
       //Convert to TI CC1101 format
       if (rssi <= -75) rssi = ((rssi + 74) * 2) + 256;
       else rssi = (rssi + 74) * 2;
-      binaryPacket.push_back(rssi);
-      std::shared_ptr<BidCoSPacket> bidCoSPacket(new BidCoSPacket(binaryPacket, true, BaseLib::HelperFunctions::getTime()));
+      binaryPacket[binaryPacketSize - 1] = rssi;
+      std::shared_ptr<BidCoSPacket> bidCoSPacket = _packetPool.create(binaryPacket.data(), binaryPacketSize, true, BaseLib::HelperFunctions::getTime());
       //Don't use (packet.at(6) & 1) here. That bit is set for non-AES packets, too
       //packet.at(6) == 3 and packet.at(7) == 0 is set on pairing packets: FD0020018A0503002494840026219BFD00011000AD4C4551303030333835365803FFFFCB99
       if (packet.at(5) == 5 && ((packet.at(6) & 3) == 3 || (packet.at(6) & 5) == 5)) {
         //Accept pairing packets from HM-TC-IT-WM-W-EU (version 1.0) and maybe other devices.
         //For these devices the handshake is never executed, but the "failed bit" set anyway: Bug
         if (!(bidCoSPacket->controlByte() & 0x4) || bidCoSPacket->messageType() != 0 || bidCoSPacket->payload().size() != 17) {
-          _out.printWarning("Warning: AES handshake failed for packet: " + _bl->hf.getHexString(binaryPacket));
+          _out.printWarning("Warning: AES handshake failed for packet: " + bidCoSPacket->hexString());
           return;
         }
       } else if (_bl->debugLevel >= 5 && packet.at(5) == 5 && (packet.at(6) & 3) == 2) {
-        _out.printDebug("Debug: AES handshake was successful for packet: " + _bl->hf.getHexString(binaryPacket));
+        _out.printDebug("Debug: AES handshake was successful for packet: " + bidCoSPacket->hexString());
       }
       _lastPacketReceived = BaseLib::HelperFunctions::getTime();
       bool wakeUp = packet.at(5) == 5 && (packet.at(6) & 0x10);
@@ -1992,7 +2009,7 @@ void HM_LGW::parsePacket(std::vector<uint8_t> &packet) {
         _out.printInfo("Info: Detected wake-up packet.");
         std::vector<uint8_t> payload;
         payload.push_back(0x00);
-        std::shared_ptr<BidCoSPacket> ok(new BidCoSPacket(bidCoSPacket->messageCounter(), 0x80, 0x02, bidCoSPacket->senderAddress(), _myAddress, payload));
+        std::shared_ptr<BidCoSPacket> ok = _packetPool.create(bidCoSPacket->messageCounter(), 0x80, 0x02, bidCoSPacket->senderAddress(), _myAddress, payload);
         ok->setTimeReceived(bidCoSPacket->getTimeReceived() + 1);
         std::this_thread::sleep_for(std::chrono::milliseconds(30));
         raisePacketReceived(ok);
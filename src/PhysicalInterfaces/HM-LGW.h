@@ -34,7 +34,9 @@
 
 #include "../BidCoSPacket.h"
 #include "IBidCoSInterface.h"
+#include "PeerProvisioner.h"
 #include "Crc16.h"
+#include "EscapedFrameDecoder.h"
 
 #include <thread>
 #include <iostream>
@@ -43,6 +45,8 @@
 #include <list>
 #include <mutex>
 #include <condition_variable>
+#include <future>
+#include <functional>
 #include <chrono>
 #include <ctime>
 #include <iomanip>
@@ -71,6 +75,7 @@ class HM_LGW : public IBidCoSInterface {
   virtual void setWakeUp(PeerInfo peerInfo);
   virtual void setAES(PeerInfo peerInfo, int32_t channel);
   virtual void removePeer(int32_t address);
+  PeerProvisioner *getPeerProvisioner() override { return _peerProvisioner.get(); }
 
   void enableUpdateMode();
   void disableUpdateMode();
@@ -106,12 +111,20 @@ class HM_LGW : public IBidCoSInterface {
     PeerInfo peerInfo;
   };
 
+  /**
+   * Called with the gateway's response to a request sent with sendRequestAsync(). The response is empty when the gateway didn't respond in time or
+   * the connection was closed.
+   */
+  typedef std::function<void(std::vector<uint8_t> &response)> RequestCallback;
+
   class Request {
    public:
     std::mutex mutex;
     std::condition_variable conditionVariable;
     bool mutexReady = false;
     std::vector<uint8_t> response;
+    RequestCallback callback;
+    int64_t deadline = 0;
     uint8_t getResponseControlByte() { return _responseControlByte; }
     uint8_t getResponseType() { return _responseType; }
 
@@ -131,8 +144,15 @@ class HM_LGW : public IBidCoSInterface {
   std::unique_ptr<C1Net::TcpSocket> _socket;
   std::unique_ptr<C1Net::TcpSocket> _socketKeepAlive;
   std::mutex _getResponseMutex;
+  std::mutex _packetIndexMutex;
   std::mutex _requestsMutex;
   std::map<uint8_t, std::shared_ptr<Request>> _requests;
+  std::mutex _requestWindowMutex;
+  std::condition_variable _requestWindowConditionVariable;
+  uint32_t _requestWindow = 4;
+  uint32_t _requestsInFlight = 0;
+  std::mutex _destinationMutexesMutex;
+  std::map<int32_t, std::shared_ptr<std::mutex>> _destinationMutexes;
   std::mutex _sendMutex;
   std::mutex _sendMutexKeepAlive;
   bool _initStarted = false;
@@ -146,11 +166,11 @@ class HM_LGW : public IBidCoSInterface {
   int32_t _missedKeepAliveResponses2 = 0;
   int32_t _lastTimePacket = 0;
   int64_t _startUpTime = 0;
-  bool _escapeByte = false;
-  std::vector<uint8_t> _packetBuffer;
+  EscapedFrameDecoder _frameDecoder;
   uint8_t _packetIndex = 0;
   uint8_t _packetIndexKeepAlive = 0;
   CRC16 _crc;
+  std::unique_ptr<PeerProvisioner> _peerProvisioner;
 
   //AES stuff
   bool _aesInitialized = false;
@@ -167,7 +187,7 @@ class HM_LGW : public IBidCoSInterface {
   gcry_cipher_hd_t _decryptHandleKeepAlive = nullptr;
 
   std::vector<char> encrypt(const std::vector<char> &data);
-  std::vector<uint8_t> decrypt(std::vector<uint8_t> &data);
+  bool decrypt(std::vector<uint8_t> &data);
   std::vector<char> encryptKeepAlive(std::vector<char> &data);
   std::vector<uint8_t> decryptKeepAlive(std::vector<uint8_t> &data);
   bool aesKeyExchange(std::vector<uint8_t> &data);
@@ -182,13 +202,64 @@ class HM_LGW : public IBidCoSInterface {
   void sendPeer(PeerInfo &peerInfo);
   void processData(std::vector<uint8_t> &data);
   void processDataKeepAlive(std::vector<uint8_t> &data);
-  void processPacket(std::vector<uint8_t> &packet);
+  void processPacket(std::vector<uint8_t> &packet, uint16_t crc);
   void processInitKeepAlive(std::string &packet);
   void parsePacket(std::vector<uint8_t> &packet);
   void parsePacketKeepAlive(std::string &packet);
   void buildPacket(std::vector<char> &packet, const std::vector<char> &payload);
   void escapePacket(const std::vector<char> &unescapedPacket, std::vector<char> &escapedPacket);
-  void getResponse(const std::vector<char> &packet, std::vector<uint8_t> &response, uint8_t messageCounter, uint8_t responseControlByte, uint8_t responseType);
+
+  /**
+   * Sends a packet and waits for the response.
+   *
+   * @param requestPacket Is set to the packet that was sent.
+   * @param requestIndex The message counter the response is expected with, or -1 to expect the response with the message counter of the request.
+   */
+  void getResponse(const std::vector<char> &payload, std::vector<char> &requestPacket, std::vector<uint8_t> &response, uint8_t responseControlByte, uint8_t responseType, int32_t requestIndex = -1);
+
+  /**
+   * Builds a packet with the next free message counter and sends it. If "request" is set, it is registered under the message counter (or under
+   * "requestIndex" if it is not -1) before the packet is sent. All packets to the main port are sent through this method, so a message counter
+   * is never used by two requests at the same time.
+   *
+   * @param packet Is set to the packet that was sent.
+   * @return Returns the message counter of the packet or -1 when no message counter is available.
+   */
+  int32_t sendWithPacketIndex(const std::vector<char> &payload, std::vector<char> &packet, const std::shared_ptr<Request> &request = std::shared_ptr<Request>(), int32_t requestIndex = -1);
+
+  /**
+   * Sends a packet without waiting for the response, so multiple requests can be in flight. The response needs to be fetched with waitForResponse()
+   * and the request needs to be removed with removeRequest() afterwards.
+   *
+   * @return Returns the packet index of the request.
+   */
+  uint8_t sendRequest(const std::vector<char> &payload, uint8_t responseControlByte, uint8_t responseType);
+  bool waitForResponse(uint8_t packetIndex, int64_t timeout, std::vector<uint8_t> &response);
+  void removeRequest(uint8_t packetIndex);
+
+  /**
+   * Sends a packet and returns without waiting for the response. Up to "lgwRequestWindow" of these requests can be in flight at the same time; when
+   * the window is full, this method blocks until a slot is free.
+   *
+   * @param callback Called exactly once with the response, or with an empty response on timeout. It is executed on the listen thread, so it must
+   * not block.
+   * @param airtime The estimated airtime of the radio frame in the payload or 0 if the payload is no radio frame. When set, the transmit slot of
+   * "trafficClass" is held while the packet is written.
+   * @return Returns the packet index of the request or -1 on error. In this case the callback is not called.
+   */
+  int32_t sendRequestAsync(const std::vector<char> &payload, uint8_t responseControlByte, uint8_t responseType, int64_t timeout, RequestCallback callback, AirtimeScheduler::TrafficClass trafficClass = AirtimeScheduler::TrafficClass::bulk, uint32_t airtime = 0);
+
+  /**
+   * Completes an asynchronous request: Removes it, frees its window slot and calls its callback. Does nothing if the request was completed already.
+   */
+  void finishRequest(uint8_t packetIndex, std::vector<uint8_t> &response);
+  void checkRequestTimeouts();
+  void cancelRequests();
+
+  /**
+   * Returns the mutex serializing packets to one destination address, so packets to the same peer keep their order.
+   */
+  std::shared_ptr<std::mutex> getDestinationMutex(int32_t address);
   void send(std::string hexString, bool raw = false);
   void send(const std::vector<char> &data, bool raw);
   void sendKeepAlive(std::vector<char> &data, bool raw);
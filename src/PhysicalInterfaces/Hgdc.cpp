@@ -98,7 +98,7 @@ void Hgdc::processPacket(int64_t familyId, const std::string& serialNumber, cons
     try
     {
         if(serialNumber != _settings->serialNumber) return;
-        std::shared_ptr<BidCoSPacket> packet = std::make_shared<BidCoSPacket>(data, true, BaseLib::HelperFunctions::getTime());
+        std::shared_ptr<BidCoSPacket> packet = _packetPool.create(data, true, BaseLib::HelperFunctions::getTime());
         processReceivedPacket(packet);
     }
     catch(const std::exception& ex)
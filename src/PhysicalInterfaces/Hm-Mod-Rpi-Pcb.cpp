@@ -43,6 +43,13 @@ Hm_Mod_Rpi_Pcb::Hm_Mod_Rpi_Pcb(std::shared_ptr<BaseLib::Systems::PhysicalInterfa
   _packetIndex = 0;
   memset(&_termios, 0, sizeof(termios));
 
+  _peerProvisioner = std::make_unique<PeerProvisioner>(_out,
+                                                       std::bind(&Hm_Mod_Rpi_Pcb::sendRequest, this, std::placeholders::_1, 1, 4),
+                                                       std::bind(&Hm_Mod_Rpi_Pcb::waitForResponse, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+                                                       std::bind(&Hm_Mod_Rpi_Pcb::removeRequest, this, std::placeholders::_1),
+                                                       [this]() { return (bool)_stopped; },
+                                                       5000);
+
   if (!settings) {
     _out.printCritical("Critical: Error initializing HM-MOD-RPI-PCB. Settings pointer is empty.");
     return;
@@ -242,11 +249,14 @@ void Hm_Mod_Rpi_Pcb::addPeer(PeerInfo peerInfo) {
 void Hm_Mod_Rpi_Pcb::addPeers(std::vector<PeerInfo> &peerInfos) {
   try {
     _peersMutex.lock();
+    std::vector<PeerInfo> newPeers;
+    newPeers.reserve(peerInfos.size());
     for (std::vector<PeerInfo>::iterator i = peerInfos.begin(); i != peerInfos.end(); ++i) {
       if (i->address == 0) continue;
       _peers[i->address] = *i;
-      if (_initComplete) sendPeer(*i);
+      if (_initComplete) newPeers.push_back(*i);
     }
+    if (!newPeers.empty()) _peerProvisioner->provision(newPeers, false);
   }
   catch (const std::exception &ex) {
     _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
@@ -345,9 +355,12 @@ void Hm_Mod_Rpi_Pcb::processQueueEntry(int32_t index, int64_t id, std::shared_pt
 void Hm_Mod_Rpi_Pcb::sendPeers() {
   try {
     _peersMutex.lock();
+    std::vector<PeerInfo> peers;
+    peers.reserve(_peers.size());
     for (std::map<int32_t, PeerInfo>::iterator i = _peers.begin(); i != _peers.end(); ++i) {
-      sendPeer(i->second);
+      peers.push_back(i->second);
     }
+    _peerProvisioner->provision(peers, true);
     _initComplete = true; //Init complete is set here within _peersMutex, so there is no conflict with addPeer() and peers are not sent twice
     _out.printInfo("Info: Peer sending completed.");
   }
@@ -363,177 +376,7 @@ void Hm_Mod_Rpi_Pcb::sendPeers() {
 
 void Hm_Mod_Rpi_Pcb::sendPeer(PeerInfo &peerInfo) {
   try {
-    if (GD::bl->debugLevel > 4)
-      GD::out.printDebug(
-          "Debug: Sending peer to LGW \"" + _settings->id + "\": Address " + GD::bl->hf.getHexString(peerInfo.address, 6) + ", AES enabled " + std::to_string(peerInfo.aesEnabled) + ", AES map " + GD::bl->hf.getHexString(peerInfo.getAESChannelMap())
-              + ".");
-    for (int32_t i = 0; i < 2; i++) //The CCU sends this packet two times, I don't know why
-    {
-      //Get current config
-      for (int32_t j = 0; j < 40; j++) {
-        std::vector<uint8_t> responsePacket;
-        std::vector<char> requestPacket;
-        std::vector<char> payload{1, 6};
-        payload.push_back(peerInfo.address >> 16);
-        payload.push_back((peerInfo.address >> 8) & 0xFF);
-        payload.push_back(peerInfo.address & 0xFF);
-        payload.push_back(0);
-        payload.push_back(0);
-        payload.push_back(0);
-        buildPacket(requestPacket, payload);
-        _packetIndex++;
-        getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-        if (responsePacket.size() >= 21 && responsePacket.at(6) == 7) break;
-        else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-          //Operation pending
-          std::this_thread::sleep_for(std::chrono::milliseconds(50));
-          continue;
-        }
-        if (j == 2) {
-          _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-          return;
-        }
-      }
-    }
-    //Reset all channels
-    for (int32_t j = 0; j < 40; j++) {
-      std::vector<uint8_t> responsePacket;
-      std::vector<char> requestPacket;
-      std::vector<char> payload{1, 0xA};
-      payload.push_back(peerInfo.address >> 16);
-      payload.push_back((peerInfo.address >> 8) & 0xFF);
-      payload.push_back(peerInfo.address & 0xFF);
-      payload.push_back(0);
-
-      for (std::map<int32_t, bool>::iterator k = peerInfo.aesChannels.begin(); k != peerInfo.aesChannels.end(); ++k) {
-        payload.push_back(k->first);
-      }
-      buildPacket(requestPacket, payload);
-      _packetIndex++;
-      getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-      if (responsePacket.size() >= 9 && responsePacket.at(6) == 1) break;
-      else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-        //Operation pending
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        continue;
-      }
-      if (j == 2) {
-        _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-        return;
-      }
-    }
-    //Get current config again
-    for (int32_t j = 0; j < 40; j++) {
-      std::vector<uint8_t> responsePacket;
-      std::vector<char> requestPacket;
-      std::vector<char> payload{1, 6};
-      payload.push_back(peerInfo.address >> 16);
-      payload.push_back((peerInfo.address >> 8) & 0xFF);
-      payload.push_back(peerInfo.address & 0xFF);
-      payload.push_back(0);
-      payload.push_back(0);
-      payload.push_back(0);
-      buildPacket(requestPacket, payload);
-      _packetIndex++;
-      getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-      if (responsePacket.size() >= 21 && responsePacket.at(6) == 7) break;
-      else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-        //Operation pending
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        continue;
-      }
-      if (j == 2) {
-        _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-        return;
-      }
-    }
-    if (peerInfo.wakeUp) {
-      //Enable sending of wake up packet or just request config again?
-      for (int32_t j = 0; j < 40; j++) {
-        std::vector<uint8_t> responsePacket;
-        std::vector<char> requestPacket;
-        std::vector<char> payload{1, 6};
-        payload.push_back(peerInfo.address >> 16);
-        payload.push_back((peerInfo.address >> 8) & 0xFF);
-        payload.push_back(peerInfo.address & 0xFF);
-        payload.push_back(0);
-        payload.push_back(1);
-        payload.push_back(0);
-        buildPacket(requestPacket, payload);
-        _packetIndex++;
-        getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-        if (responsePacket.size() >= 21 && responsePacket.at(6) == 7) break;
-        else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-          //Operation pending
-          std::this_thread::sleep_for(std::chrono::milliseconds(50));
-          continue;
-        }
-        if (j == 2) {
-          _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-          return;
-        }
-      }
-    }
-    //Set key index and enable sending of wake up packet.
-    for (int32_t j = 0; j < 40; j++) {
-      std::vector<uint8_t> responsePacket;
-      std::vector<char> requestPacket;
-      std::vector<char> payload{1, 6};
-      payload.push_back(peerInfo.address >> 16);
-      payload.push_back((peerInfo.address >> 8) & 0xFF);
-      payload.push_back(peerInfo.address & 0xFF);
-      payload.push_back(peerInfo.keyIndex);
-      payload.push_back(peerInfo.wakeUp ? 1 : 0);
-      payload.push_back(0);
-      buildPacket(requestPacket, payload);
-      _packetIndex++;
-      getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-      if (responsePacket.size() >= 21 && responsePacket.at(6) == 7) break;
-      else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-        //Operation pending
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        continue;
-      }
-      if (j == 2) {
-        _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-        return;
-      }
-    }
-    //Enable AES
-    if (peerInfo.aesEnabled) {
-      //Delete old configuration
-      for (int32_t j = 0; j < 40; j++) {
-        std::vector<uint8_t> responsePacket;
-        std::vector<char> requestPacket;
-        std::vector<char> payload{1, 9};
-        payload.push_back(peerInfo.address >> 16);
-        payload.push_back((peerInfo.address >> 8) & 0xFF);
-        payload.push_back(peerInfo.address & 0xFF);
-        payload.push_back(0);
-
-        bool aesEnabled = false;
-        for (std::map<int32_t, bool>::iterator k = peerInfo.aesChannels.begin(); k != peerInfo.aesChannels.end(); ++k) {
-          if (k->second) {
-            aesEnabled = true;
-            payload.push_back(k->first);
-          }
-        }
-        if (!aesEnabled) break;
-        buildPacket(requestPacket, payload);
-        _packetIndex++;
-        getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
-        if (responsePacket.size() >= 9 && responsePacket.at(6) == 1) break;
-        else if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
-          //Operation pending
-          std::this_thread::sleep_for(std::chrono::milliseconds(50));
-          continue;
-        }
-        if (j == 2) {
-          _out.printError("Error: Could not add peer with address 0x" + _bl->hf.getHexString(peerInfo.address, 6));
-          return;
-        }
-      }
-    }
+    _peerProvisioner->provision(std::vector<PeerInfo>{peerInfo}, false);
   }
   catch (const std::exception &ex) {
     _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
@@ -594,6 +437,7 @@ void Hm_Mod_Rpi_Pcb::removePeer(int32_t address) {
       return;
     }
     _peers.erase(address);
+    _peerProvisioner->remove(address);
 
     if (_initComplete) {
       int64_t id;
@@ -653,23 +497,31 @@ void Hm_Mod_Rpi_Pcb::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> packet
       return;
     }
 
-    std::vector<char> packetBytes = bidCoSPacket->byteArraySigned();
-    if (_bl->debugLevel >= 4) _out.printInfo("Info: Sending (" + _settings->id + "): " + _bl->hf.getHexString(packetBytes));
+    BidCoSPacket::FrameBuffer packetBytes;
+    uint32_t packetSize = bidCoSPacket->byteArray(packetBytes.data(), packetBytes.size());
+    if (packetSize == 0) return;
+    if (_bl->debugLevel >= 4) _out.printInfo("Info: Sending (" + _settings->id + "): " + bidCoSPacket->hexString());
+
+    std::vector<char> payload;
+    payload.reserve(5 + packetSize - 1);
+    payload.push_back(1);
+    payload.push_back(2);
+    payload.push_back(0);
+    payload.push_back(0);
+    payload.push_back((bidCoSPacket->controlByte() & 0x10) ? 1 : 0);
+    payload.insert(payload.end(), packetBytes.begin() + 1, packetBytes.begin() + packetSize);
+
+    uint32_t airtime = AirtimeScheduler::estimateAirtime(bidCoSPacket);
+    AirtimeScheduler::TrafficClass trafficClass = AirtimeScheduler::classify(bidCoSPacket);
 
     for (int32_t j = 0; j < 40; j++) {
       std::vector<uint8_t> responsePacket;
       std::vector<char> requestPacket;
-      std::vector<char> payload;
-      payload.reserve(5 + packetBytes.size() - 1);
-      payload.push_back(1);
-      payload.push_back(2);
-      payload.push_back(0);
-      payload.push_back(0);
-      payload.push_back((bidCoSPacket->controlByte() & 0x10) ? 1 : 0);
-      payload.insert(payload.end(), packetBytes.begin() + 1, packetBytes.end());
       buildPacket(requestPacket, payload);
       _packetIndex++;
-      getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4);
+      getResponse(requestPacket, responsePacket, _packetIndex - 1, 1, 4, trafficClass, airtime);
+      //Everything but "operation pending" means the module put the frame on air.
+      if (responsePacket.size() >= 9 && responsePacket.at(6) != 8) _airtimeScheduler.record(airtime);
       if (responsePacket.size() == 9 && responsePacket.at(6) == 8) {
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
         //Resend
@@ -680,17 +532,17 @@ void Hm_Mod_Rpi_Pcb::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> packet
           //0x0D is returned, when there is no response to the A003 packet and if the 8002
           //packet doesn't match
           //Example: FD000501BC040D025E14
-          _out.printInfo("Info: AES handshake failed for packet, because either the response data of the last handshake packet didn't match or the last handshake packet wasn't received: " + _bl->hf.getHexString(packetBytes));
+          _out.printInfo("Info: AES handshake failed for packet, because either the response data of the last handshake packet didn't match or the last handshake packet wasn't received: " + bidCoSPacket->hexString());
           return;
         } else if (responsePacket.at(6) == 0x03) {
           //Example: FD001001B3040302391A8002282BE6FD26EF00C54D
-          _out.printDebug("Debug: Packet was sent successfully: " + _bl->hf.getHexString(packetBytes));
+          _out.printDebug("Debug: Packet was sent successfully: " + bidCoSPacket->hexString());
         } else if (responsePacket.at(6) == 0x0C) {
           //Example: FD00140168040C0228128002282BE6FD26EF00938ABE1C163D
-          _out.printDebug("Debug: Packet was sent successfully and AES handshake was successful: " + _bl->hf.getHexString(packetBytes));
+          _out.printDebug("Debug: Packet was sent successfully and AES handshake was successful: " + bidCoSPacket->hexString());
         }
         if (responsePacket.size() == 9) {
-          _out.printDebug("Debug: Packet was sent successfully: " + _bl->hf.getHexString(packetBytes));
+          _out.printDebug("Debug: Packet was sent successfully: " + bidCoSPacket->hexString());
           break;
         }
         parsePacket(responsePacket);
@@ -700,11 +552,11 @@ void Hm_Mod_Rpi_Pcb::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> packet
         //NACK (0404) is returned
         //NACK is sometimes also returned when the AES handshake wasn't successful (i. e.
         //the handshake after sending a wake up packet)
-        _out.printInfo("Info: No answer to packet " + _bl->hf.getHexString(packetBytes));
+        _out.printInfo("Info: No answer to packet " + bidCoSPacket->hexString());
         return;
       }
       if (j == 2) {
-        _out.printInfo("Info: No response from HM-MOD-RPI-PCB to packet " + _bl->hf.getHexString(packetBytes));
+        _out.printInfo("Info: No response from HM-MOD-RPI-PCB to packet " + bidCoSPacket->hexString());
         return;
       }
     }
@@ -716,7 +568,7 @@ void Hm_Mod_Rpi_Pcb::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> packet
   }
 }
 
-void Hm_Mod_Rpi_Pcb::getResponse(const std::vector<char> &packet, std::vector<uint8_t> &response, uint8_t messageCounter, uint8_t responseControlByte, uint8_t responseType) {
+void Hm_Mod_Rpi_Pcb::getResponse(const std::vector<char> &packet, std::vector<uint8_t> &response, uint8_t messageCounter, uint8_t responseControlByte, uint8_t responseType, AirtimeScheduler::TrafficClass trafficClass, uint32_t airtime) {
   try {
     if (packet.size() < 8 || _stopped) return;
     std::lock_guard<std::mutex> getResponseGuard(_getResponseMutex);
@@ -725,7 +577,11 @@ void Hm_Mod_Rpi_Pcb::getResponse(const std::vector<char> &packet, std::vector<ui
     _requests[messageCounter] = request;
     _requestsMutex.unlock();
     std::unique_lock<std::mutex> lock(request->mutex);
-    send(packet);
+    if (airtime > 0) {
+      //The transmit slot is only held while the packet is written, not while waiting for the response.
+      AirtimeScheduler::Slot airtimeSlot(_airtimeScheduler, trafficClass, airtime);
+      send(packet);
+    } else send(packet);
     if (!request->conditionVariable.wait_for(lock, std::chrono::milliseconds(5000), [&] { return request->mutexReady; })) {
       _out.printError("Error: No response received to packet: " + _bl->hf.getHexString(packet));
     }
@@ -741,6 +597,55 @@ void Hm_Mod_Rpi_Pcb::getResponse(const std::vector<char> &packet, std::vector<ui
   }
 }
 
+uint8_t Hm_Mod_Rpi_Pcb::sendRequest(const std::vector<char> &payload, uint8_t responseControlByte, uint8_t responseType) {
+  uint8_t packetIndex = 0;
+  try {
+    std::lock_guard<std::mutex> getResponseGuard(_getResponseMutex);
+    std::vector<char> requestPacket;
+    buildPacket(requestPacket, payload);
+    packetIndex = _packetIndex++;
+    {
+      std::lock_guard<std::mutex> requestsGuard(_requestsMutex);
+      _requests[packetIndex] = std::make_shared<Request>(responseControlByte, responseType);
+    }
+    send(requestPacket);
+  }
+  catch (const std::exception &ex) {
+    _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+  return packetIndex;
+}
+
+bool Hm_Mod_Rpi_Pcb::waitForResponse(uint8_t packetIndex, int64_t timeout, std::vector<uint8_t> &response) {
+  try {
+    std::shared_ptr<Request> request;
+    {
+      std::lock_guard<std::mutex> requestsGuard(_requestsMutex);
+      auto requestIterator = _requests.find(packetIndex);
+      if (requestIterator == _requests.end()) return false;
+      request = requestIterator->second;
+    }
+    std::unique_lock<std::mutex> lock(request->mutex);
+    if (!request->conditionVariable.wait_for(lock, std::chrono::milliseconds(timeout), [&] { return request->mutexReady; })) return false;
+    response = request->response;
+    return true;
+  }
+  catch (const std::exception &ex) {
+    _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+  return false;
+}
+
+void Hm_Mod_Rpi_Pcb::removeRequest(uint8_t packetIndex) {
+  try {
+    std::lock_guard<std::mutex> requestsGuard(_requestsMutex);
+    _requests.erase(packetIndex);
+  }
+  catch (const std::exception &ex) {
+    _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+  }
+}
+
 void Hm_Mod_Rpi_Pcb::send(std::string hexString) {
   try {
     if (hexString.empty()) return;
@@ -784,6 +689,8 @@ void Hm_Mod_Rpi_Pcb::send(const std::vector<char> &data) {
 void Hm_Mod_Rpi_Pcb::doInit() {
   try {
     _packetIndex = 0;
+    //The module is always reset on init, so it lost its peer table.
+    _peerProvisioner->reset();
 
     if (!GD::family->getCentral()) {
       _stopCallbackThread = true;
@@ -1156,6 +1063,7 @@ void Hm_Mod_Rpi_Pcb::listen() {
           std::this_thread::sleep_for(std::chrono::milliseconds(1000));
           if (_stopCallbackThread) return;
           _out.printWarning("Warning: Connection closed (1). Trying to reconnect...");
+          _frameDecoder.reset();
           reconnect();
           continue;
         }
@@ -1261,11 +1169,10 @@ void Hm_Mod_Rpi_Pcb::escapePacket(const std::vector<char> &unescapedPacket, std:
   }
 }
 
-void Hm_Mod_Rpi_Pcb::processPacket(std::vector<uint8_t> &packet) {
+void Hm_Mod_Rpi_Pcb::processPacket(std::vector<uint8_t> &packet, uint16_t crc) {
   try {
     _out.printDebug(std::string("Debug: Packet received from HM-MOD-RPI-PCB: " + _bl->hf.getHexString(packet)));
     if (packet.size() < 8) return;
-    uint16_t crc = _crc.calculate(packet, true);
 
     if (packet.at(3) == 0xFE && packet.at(5) == 0) {
       std::string packetString;
@@ -1315,33 +1222,10 @@ void Hm_Mod_Rpi_Pcb::processPacket(std::vector<uint8_t> &packet) {
 
 void Hm_Mod_Rpi_Pcb::processData(std::vector<uint8_t> &data) {
   try {
-    std::vector<uint8_t> packet;
-    if (!_packetBuffer.empty()) packet = _packetBuffer;
-    for (std::vector<uint8_t>::iterator i = data.begin(); i != data.end(); ++i) {
-      if (!packet.empty() && *i == 0xfd) {
-        processPacket(packet);
-        packet.clear();
-        _escapeByte = false;
-      }
-      if (*i == 0xfc) {
-        _escapeByte = true;
-        continue;
-      }
-      if (_escapeByte) {
-        packet.push_back(*i | 0x80);
-        _escapeByte = false;
-      } else packet.push_back(*i);
-    }
-    int32_t size = (packet.size() > 5) ? (((int32_t)packet.at(1)) << 8) + packet.at(2) + 5 : 0;
-    if (size < 0) size = 0;
-    if (size > 0 && size < 8) _out.printInfo("Info: Ignoring too small packet: " + _bl->hf.getHexString(data));
-    else if (size > 255) _out.printWarning("Warning: Too large packet received: " + _bl->hf.getHexString(data));
-    else if (packet.size() < 8 || packet.size() < (unsigned)size) _packetBuffer = packet;
-    else {
-      processPacket(packet);
-      _packetBuffer.clear();
-      _escapeByte = false;
-    }
+    _frameDecoder.decode(data.data(), data.size(), [&](std::vector<uint8_t> &packet, uint16_t crc) { processPacket(packet, crc); }, [&](EscapedFrameDecoder::Error error, std::vector<uint8_t> &header) {
+      if (error == EscapedFrameDecoder::Error::tooSmall) _out.printInfo("Info: Ignoring too small packet: " + _bl->hf.getHexString(header));
+      else _out.printWarning("Warning: Too large packet received: " + _bl->hf.getHexString(header));
+    });
   }
   catch (const std::exception &ex) {
     _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
@@ -1352,26 +1236,32 @@ void Hm_Mod_Rpi_Pcb::parsePacket(std::vector<uint8_t> &packet) {
   try {
     if (packet.empty()) return;
     if ((packet.at(5) == 5 || (packet.at(5) == 4 && packet.at(6) != 7)) && packet.at(3) == 1 && packet.size() >= 20) {
-      std::vector<uint8_t> binaryPacket({(uint8_t)(packet.size() - 11)});
-      binaryPacket.insert(binaryPacket.end(), packet.begin() + 9, packet.end() - 2);
+      uint32_t binaryPacketSize = packet.size() - 9; //Length byte + packet + RSSI byte
+      if (binaryPacketSize > BidCoSPacket::maxFrameSize) {
+        _out.printWarning("Warning: Too large packet received: " + BaseLib::HelperFunctions::getHexString(packet));
+        return;
+      }
+      BidCoSPacket::FrameBuffer binaryPacket;
+      binaryPacket[0] = (uint8_t)(packet.size() - 11);
+      std::copy(packet.begin() + 9, packet.end() - 2, binaryPacket.begin() + 1);
       int32_t rssi = packet.at(8); //Range should be from 0x0B to 0x8A. 0x0B is -11dBm 0x8A -138dBm.
       rssi *= -1;
       //Convert to TI CC1101 format
       if (rssi <= -75) rssi = ((rssi + 74) * 2) + 256;
       else rssi = (rssi + 74) * 2;
-      binaryPacket.push_back(rssi);
-      std::shared_ptr<BidCoSPacket> bidCoSPacket(new BidCoSPacket(binaryPacket, true, BaseLib::HelperFunctions::getTime()));
+      binaryPacket[binaryPacketSize - 1] = rssi;
+      std::shared_ptr<BidCoSPacket> bidCoSPacket = _packetPool.create(binaryPacket.data(), binaryPacketSize, true, BaseLib::HelperFunctions::getTime());
       //Don't use (packet.at(6) & 1) here. That bit is set for non-AES packets, too
       //packet.at(6) == 3 and packet.at(7) == 0 is set on pairing packets: FD0020018A0503002494840026219BFD00011000AD4C4551303030333835365803FFFFCB99
       if (packet.at(5) == 5 && ((packet.at(6) & 3) == 3 || (packet.at(6) & 5) == 5)) {
         //Accept pairing packets from HM-TC-IT-WM-W-EU (version 1.0) and maybe other devices.
         //For these devices the handshake is never executed, but the "failed bit" set anyway: Bug
         if (!(bidCoSPacket->controlByte() & 0x4) || bidCoSPacket->messageType() != 0 || bidCoSPacket->payload().size() != 17) {
-          _out.printWarning("Warning: AES handshake failed for packet: " + _bl->hf.getHexString(binaryPacket));
+          _out.printWarning("Warning: AES handshake failed for packet: " + bidCoSPacket->hexString());
           return;
         }
       } else if (_bl->debugLevel >= 5 && packet.at(5) == 5 && (packet.at(6) & 3) == 2) {
-        _out.printDebug("Debug: AES handshake was successful for packet: " + _bl->hf.getHexString(binaryPacket));
+        _out.printDebug("Debug: AES handshake was successful for packet: " + bidCoSPacket->hexString());
       }
       _lastPacketReceived = BaseLib::HelperFunctions::getTime();
       bool wakeUp = packet.at(5) == 5 && (packet.at(6) & 0x10);
@@ -1392,7 +1282,7 @@ void Hm_Mod_Rpi_Pcb::parsePacket(std::vector<uint8_t> &packet) {
         _out.printInfo("Info: Detected wake-up packet.");
         std::vector<uint8_t> payload;
         payload.push_back(0x00);
-        std::shared_ptr<BidCoSPacket> ok(new BidCoSPacket(bidCoSPacket->messageCounter(), 0x80, 0x02, bidCoSPacket->senderAddress(), _myAddress, payload));
+        std::shared_ptr<BidCoSPacket> ok = _packetPool.create(bidCoSPacket->messageCounter(), 0x80, 0x02, bidCoSPacket->senderAddress(), _myAddress, payload);
         ok->setTimeReceived(bidCoSPacket->getTimeReceived() + 1);
         std::this_thread::sleep_for(std::chrono::milliseconds(30));
         raisePacketReceived(ok);
@@ -34,7 +34,9 @@
 
 #include "../BidCoSPacket.h"
 #include "IBidCoSInterface.h"
+#include "PeerProvisioner.h"
 #include "Crc16.h"
+#include "EscapedFrameDecoder.h"
 
 #include <thread>
 #include <iostream>
@@ -74,6 +76,7 @@ class Hm_Mod_Rpi_Pcb  : public IBidCoSInterface
         virtual void setWakeUp(PeerInfo peerInfo);
         virtual void setAES(PeerInfo peerInfo, int32_t channel);
         virtual void removePeer(int32_t address);
+        PeerProvisioner* getPeerProvisioner() override { return _peerProvisioner.get(); }
 
         void enableUpdateMode();
         void disableUpdateMode();
@@ -129,10 +132,10 @@ class Hm_Mod_Rpi_Pcb  : public IBidCoSInterface
         bool _initStarted = false;
         int32_t _lastTimePacket = 0;
         int64_t _startUpTime = 0;
-        bool _escapeByte = false;
-        std::vector<uint8_t> _packetBuffer;
+        EscapedFrameDecoder _frameDecoder;
         std::atomic<uint8_t> _packetIndex;
         CRC16 _crc;
+        std::unique_ptr<PeerProvisioner> _peerProvisioner;
 
         void openDevice();
         void closeDevice();
@@ -143,11 +146,14 @@ class Hm_Mod_Rpi_Pcb  : public IBidCoSInterface
         void sendPeers();
         void sendPeer(PeerInfo& peerInfo);
         void processData(std::vector<uint8_t>& data);
-        void processPacket(std::vector<uint8_t>& packet);
+        void processPacket(std::vector<uint8_t>& packet, uint16_t crc);
         void parsePacket(std::vector<uint8_t>& packet);
         void buildPacket(std::vector<char>& packet, const std::vector<char>& payload);
         void escapePacket(const std::vector<char>& unescapedPacket, std::vector<char>& escapedPacket);
-        void getResponse(const std::vector<char>& packet, std::vector<uint8_t>& response, uint8_t messageCounter, uint8_t responseControlByte, uint8_t responseType);
+        void getResponse(const std::vector<char>& packet, std::vector<uint8_t>& response, uint8_t messageCounter, uint8_t responseControlByte, uint8_t responseType, AirtimeScheduler::TrafficClass trafficClass = AirtimeScheduler::TrafficClass::bulk, uint32_t airtime = 0);
+        uint8_t sendRequest(const std::vector<char>& payload, uint8_t responseControlByte, uint8_t responseType);
+        bool waitForResponse(uint8_t packetIndex, int64_t timeout, std::vector<uint8_t>& response);
+        void removeRequest(uint8_t packetIndex);
         void send(std::string hexString);
         void send(const std::vector<char>& data);
         void sendTimePacket();
@@ -312,7 +312,7 @@ PVariable HomegearGateway::invoke(std::string methodName, PArray &parameters) {
 
 void HomegearGateway::processPacket(std::string &data) {
   try {
-    std::shared_ptr<BidCoSPacket> packet = std::make_shared<BidCoSPacket>(data, BaseLib::HelperFunctions::getTime());
+    std::shared_ptr<BidCoSPacket> packet = _packetPool.create(data, BaseLib::HelperFunctions::getTime());
     processReceivedPacket(packet);
   }
   catch (const std::exception &ex) {
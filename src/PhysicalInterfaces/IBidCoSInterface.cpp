@@ -30,6 +30,7 @@
 #include "IBidCoSInterface.h"
 #include "../GD.h"
 #include "../BidCoSPacket.h"
+#include "../BidCoSLatencyStatistics.h"
 
 namespace BidCoS {
 
@@ -197,6 +198,7 @@ void IBidCoSInterface::processQueueEntry(int32_t index, int64_t id, std::shared_
     queueEntry = std::dynamic_pointer_cast<QueueEntry>(entry);
     if (!queueEntry || !queueEntry->packet) return;
     forceSendPacket(queueEntry->packet);
+    _airtimeScheduler.record(AirtimeScheduler::estimateAirtime(queueEntry->packet));
 
     if (queueEntry->packet->controlByte() & 0x10) queueEntry->packet->setTimeSending(queueEntry->packet->getTimeSending() + 560);
     else queueEntry->packet->setTimeSending(queueEntry->packet->getTimeSending() + 200);
@@ -237,6 +239,7 @@ void IBidCoSInterface::queuePacket(std::shared_ptr<BidCoSPacket> packet, int64_t
 
 void IBidCoSInterface::processReceivedPacket(std::shared_ptr<BidCoSPacket> packet) {
   try {
+    if (GD::latencyStatistics) GD::latencyStatistics->recordSince(_settings->id, BidCoSLatencyStatistics::Stage::interfaceReceive, packet->monotonicTimeReceived());
     if (packet->destinationAddress() == _myAddress) {
       bool aesHandshake = false;
       bool wakeUp = false;
@@ -344,7 +347,7 @@ void IBidCoSInterface::processReceivedPacket(std::shared_ptr<BidCoSPacket> packe
           std::vector<uint8_t> payload{0};
           uint8_t controlByte = 0x80;
           if ((packet->controlByte() & 2) && wakeUp && packet->messageType() != 0) controlByte |= 1;
-          std::shared_ptr<BidCoSPacket> ackPacket(new BidCoSPacket(packet->messageCounter(), controlByte, 0x02, _myAddress, packet->senderAddress(), payload));
+          std::shared_ptr<BidCoSPacket> ackPacket = _packetPool.create(packet->messageCounter(), controlByte, 0x02, _myAddress, packet->senderAddress(), payload);
           queuePacket(ackPacket);
         }
         raisePacketReceived(packet);
@@ -368,7 +371,7 @@ void IBidCoSInterface::processReceivedPacket(std::shared_ptr<BidCoSPacket> packe
         std::map<int32_t, PeerInfo>::iterator peerIterator = _peers.find(packet->senderAddress());
         if (peerIterator != _peers.end() && peerIterator->second.wakeUp) {
           std::vector<uint8_t> payload;
-          std::shared_ptr<BidCoSPacket> wakeUpPacket(new BidCoSPacket(packet->messageCounter(), 0xA1, 0x12, _myAddress, packet->senderAddress(), payload));
+          std::shared_ptr<BidCoSPacket> wakeUpPacket = _packetPool.create(packet->messageCounter(), 0xA1, 0x12, _myAddress, packet->senderAddress(), payload);
           queuePacket(wakeUpPacket);
         }
         raisePacketReceived(packet);
@@ -403,7 +406,6 @@ void IBidCoSInterface::processReceivedPacket(std::shared_ptr<BidCoSPacket> packe
 
 void IBidCoSInterface::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> packet) {
   try {
-    std::lock_guard<std::mutex> sendPacketGuard(_sendPacketMutex);
     if (!packet) {
       _out.printWarning("Warning: Packet was nullptr.");
       return;
@@ -414,7 +416,6 @@ void IBidCoSInterface::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> pack
       _out.printError("Error: Tried to send packet larger than 64 bytes. That is not supported.");
       return;
     }
-
     // {{{ Remove packet from queue id map
     {
       std::lock_guard<std::mutex> idGuard(_queueIdsMutex);
@@ -466,7 +467,12 @@ void IBidCoSInterface::sendPacket(std::shared_ptr<BaseLib::Systems::Packet> pack
       return;
     }
 
-    forceSendPacket(bidCoSPacket);
+    uint32_t airtime = AirtimeScheduler::estimateAirtime(bidCoSPacket);
+    {
+      AirtimeScheduler::Slot airtimeSlot(_airtimeScheduler, AirtimeScheduler::classify(bidCoSPacket), airtime);
+      forceSendPacket(bidCoSPacket);
+    }
+    _airtimeScheduler.record(airtime);
     _aesHandshake->setMFrame(bidCoSPacket);
     if (!_updateMode &&
         (bidCoSPacket->controlByte() & 0x20) &&
@@ -33,12 +33,16 @@
 #include <cstdint>
 
 #include "AesHandshake.h"
+#include "AirtimeScheduler.h"
+#include "../BidCoSPacketPool.h"
 #include <homegear-base/BaseLib.h>
 
 #include <random>
 
 namespace BidCoS {
 
+class PeerProvisioner;
+
 class IBidCoSInterface : public BaseLib::Systems::IPhysicalInterface, public BaseLib::ITimedQueue
 {
 public:
@@ -76,6 +80,21 @@ public:
 
 	void appendSignature(std::shared_ptr<BidCoSPacket> packet);
 
+	/**
+	 * Returns the pool received packets of this interface are allocated from.
+	 */
+	BidCoSPacketPool& getPacketPool() { return _packetPool; }
+
+	/**
+	 * Returns the scheduler accounting the airtime of the frames sent by this interface.
+	 */
+	AirtimeScheduler& getAirtimeScheduler() { return _airtimeScheduler; }
+
+	/**
+	 * Returns the provisioner sending the peers to the gateway or nullptr when the interface doesn't keep a peer table.
+	 */
+	virtual PeerProvisioner* getPeerProvisioner() { return nullptr; }
+
 	virtual void sendPacket(std::shared_ptr<BaseLib::Systems::Packet> packet);
 	virtual void sendTest() {}
 protected:
@@ -96,7 +115,8 @@ protected:
 	std::map<int32_t, std::set<int64_t>> _queueIds;
 	std::mutex _peersMutex;
 	std::map<int32_t, PeerInfo> _peers;
-	std::mutex _sendPacketMutex;
+	AirtimeScheduler _airtimeScheduler;
+	BidCoSPacketPool _packetPool;
 
 	BaseLib::Output _out;
 	bool _initComplete = false;
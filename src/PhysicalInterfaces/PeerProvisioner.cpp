@@ -0,0 +1,339 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#include "PeerProvisioner.h"
+#include "../GD.h"
+
+#include <deque>
+#include <thread>
+
+namespace BidCoS
+{
+
+PeerProvisioner::PeerProvisioner(BaseLib::Output& out, std::function<uint8_t(const std::vector<char>&)> sendRequest, std::function<bool(uint8_t, int64_t, std::vector<uint8_t>&)> waitForResponse, std::function<void(uint8_t)> removeRequest, std::function<bool()> stopped, int64_t responseTimeout) : _out(out)
+{
+	_sendRequest = sendRequest;
+	_waitForResponse = waitForResponse;
+	_removeRequest = removeRequest;
+	_stopped = stopped;
+	_responseTimeout = responseTimeout;
+	//Packet indexes are 8 bit, so the window needs to be much smaller than 256.
+	int32_t window = GD::settings->getNumber("peerprovisioningwindow");
+	if(window <= 0) window = 4;
+	else if(window > 32) window = 32;
+	_window = window;
+}
+
+uint64_t PeerProvisioner::getHash(const IBidCoSInterface::PeerInfo& peerInfo)
+{
+	//FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	auto add = [&hash](int64_t value)
+	{
+		for(int32_t i = 0; i < 8; i++)
+		{
+			hash ^= (uint8_t)(value >> (i * 8));
+			hash *= 1099511628211ull;
+		}
+	};
+	add(peerInfo.address);
+	add(peerInfo.keyIndex);
+	add(peerInfo.wakeUp);
+	add(peerInfo.aesEnabled);
+	for(auto& channel : peerInfo.aesChannels)
+	{
+		add(channel.first);
+		add(channel.second);
+	}
+	return hash;
+}
+
+uint64_t PeerProvisioner::getPeerListHash()
+{
+	uint64_t hash = 14695981039346656037ull;
+	for(auto& peer : _provisionedPeers)
+	{
+		hash ^= peer.second;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+std::vector<PeerProvisioner::Command> PeerProvisioner::getCommands(const IBidCoSInterface::PeerInfo& peerInfo)
+{
+	std::vector<Command> commands;
+	commands.reserve(7);
+	std::vector<char> address{ (char)(peerInfo.address >> 16), (char)((peerInfo.address >> 8) & 0xFF), (char)(peerInfo.address & 0xFF) };
+	auto addCommand = [&](std::vector<char> payload, uint32_t minimumResponseSize, uint8_t responseCode)
+	{
+		Command command;
+		command.payload = std::move(payload);
+		command.minimumResponseSize = minimumResponseSize;
+		command.responseCode = responseCode;
+		commands.push_back(std::move(command));
+	};
+
+	//Get current config. The CCU sends this packet two or even more times, I don't know why.
+	std::vector<char> getConfig{ 1, 6 };
+	getConfig.insert(getConfig.end(), address.begin(), address.end());
+	getConfig.insert(getConfig.end(), { 0, 0, 0 });
+	addCommand(getConfig, 21, 7);
+	addCommand(getConfig, 21, 7);
+
+	//Reset all channels
+	std::vector<char> payload{ 1, 0xA };
+	payload.insert(payload.end(), address.begin(), address.end());
+	payload.push_back(0);
+	for(auto& channel : peerInfo.aesChannels)
+	{
+		payload.push_back(channel.first);
+	}
+	addCommand(payload, 9, 1);
+
+	//Get current config again
+	addCommand(getConfig, 21, 7);
+
+	if(peerInfo.wakeUp)
+	{
+		//Enable sending of wake up packet or just request config again?
+		payload = std::vector<char>{ 1, 6 };
+		payload.insert(payload.end(), address.begin(), address.end());
+		payload.insert(payload.end(), { 0, 1, 0 });
+		addCommand(payload, 21, 7);
+	}
+
+	//Set key index and enable sending of wake up packet.
+	payload = std::vector<char>{ 1, 6 };
+	payload.insert(payload.end(), address.begin(), address.end());
+	payload.insert(payload.end(), { (char)peerInfo.keyIndex, (char)(peerInfo.wakeUp ? 1 : 0), 0 });
+	addCommand(payload, 21, 7);
+
+	//Enable AES
+	if(peerInfo.aesEnabled)
+	{
+		payload = std::vector<char>{ 1, 9 };
+		payload.insert(payload.end(), address.begin(), address.end());
+		payload.push_back(0);
+		bool aesEnabled = false;
+		for(auto& channel : peerInfo.aesChannels)
+		{
+			if(!channel.second) continue;
+			aesEnabled = true;
+			payload.push_back(channel.first);
+		}
+		if(aesEnabled) addCommand(payload, 9, 1);
+	}
+
+	return commands;
+}
+
+void PeerProvisioner::provision(const std::vector<IBidCoSInterface::PeerInfo>& peers, bool skipUnchanged)
+{
+	try
+	{
+		std::lock_guard<std::mutex> provisionGuard(_provisionMutex);
+		int64_t startTime = BaseLib::HelperFunctions::getTime();
+
+		std::vector<PeerState> states;
+		states.reserve(peers.size());
+		uint32_t skippedPeers = 0;
+		for(auto& peerInfo : peers)
+		{
+			if(peerInfo.address == 0) continue;
+			if(skipUnchanged)
+			{
+				auto provisionedPeersIterator = _provisionedPeers.find(peerInfo.address);
+				if(provisionedPeersIterator != _provisionedPeers.end() && provisionedPeersIterator->second == getHash(peerInfo))
+				{
+					skippedPeers++;
+					continue;
+				}
+			}
+			PeerState state;
+			state.peerInfo = peerInfo;
+			state.commands = getCommands(peerInfo);
+			states.push_back(std::move(state));
+		}
+
+		if(skipUnchanged)
+		{
+			std::lock_guard<std::mutex> statisticsGuard(_statisticsMutex);
+			_statistics = Statistics();
+			_statistics.running = true;
+			_statistics.peers = skippedPeers + states.size();
+			_statistics.skippedPeers = skippedPeers;
+			if(skippedPeers > 0) _out.printInfo("Info: Skipping " + std::to_string(skippedPeers) + " unchanged peers already known to the gateway.");
+			_out.printInfo("Info: Sending " + std::to_string(states.size()) + " peers with up to " + std::to_string(_window) + " peers in flight...");
+		}
+
+		//Peers waiting for their next command, oldest first
+		std::deque<uint32_t> readyPeers;
+		uint32_t nextPeer = 0;
+		std::deque<InFlightCommand> inFlightCommands;
+		uint32_t finishedPeers = 0;
+		uint32_t progressStep = states.size() >= 20 ? states.size() / 10 : 0;
+		uint64_t commands = 0;
+		uint64_t retries = 0;
+		uint32_t failedPeers = 0;
+
+		while(finishedPeers < states.size() && !_stopped())
+		{
+			// {{{ Fill the window
+				int64_t time = BaseLib::HelperFunctions::getTime();
+				while(inFlightCommands.size() < _window)
+				{
+					uint32_t peer = 0;
+					if(!readyPeers.empty() && states.at(readyPeers.front()).notBefore <= time)
+					{
+						peer = readyPeers.front();
+						readyPeers.pop_front();
+					}
+					else if(nextPeer < states.size()) peer = nextPeer++;
+					else break;
+
+					PeerState& state = states.at(peer);
+					if(state.attempts == 0 && state.commandIndex == 0 && GD::bl->debugLevel > 4) _out.printDebug("Debug: Sending peer to gateway: Address " + BaseLib::HelperFunctions::getHexString(state.peerInfo.address, 6) + ", AES enabled " + std::to_string(state.peerInfo.aesEnabled) + ", AES map " + BaseLib::HelperFunctions::getHexString(state.peerInfo.getAESChannelMap()) + ".");
+					InFlightCommand command;
+					command.packetIndex = _sendRequest(state.commands.at(state.commandIndex).payload);
+					command.peer = peer;
+					command.deadline = BaseLib::HelperFunctions::getTime() + _responseTimeout;
+					inFlightCommands.push_back(command);
+					commands++;
+				}
+			// }}}
+
+			if(inFlightCommands.empty())
+			{
+				//Only peers waiting for a retry are left.
+				std::this_thread::sleep_for(std::chrono::milliseconds(_pendingRetryDelay));
+				continue;
+			}
+
+			// {{{ Process the oldest command. The gateway answers in order, so the responses to the other commands are not delayed by this.
+				InFlightCommand command = inFlightCommands.front();
+				inFlightCommands.pop_front();
+				std::vector<uint8_t> response;
+				int64_t timeout = command.deadline - BaseLib::HelperFunctions::getTime();
+				if(!_waitForResponse(command.packetIndex, timeout > 0 ? timeout : 0, response)) _out.printError("Error: No response received to peer command with packet index " + std::to_string(command.packetIndex) + ".");
+				_removeRequest(command.packetIndex);
+
+				PeerState& state = states.at(command.peer);
+				const Command& currentCommand = state.commands.at(state.commandIndex);
+				state.attempts++;
+				if(response.size() >= currentCommand.minimumResponseSize && response.size() >= 7 && response.at(6) == currentCommand.responseCode)
+				{
+					state.commandIndex++;
+					state.attempts = 0;
+					state.failures = 0;
+					if(state.commandIndex < state.commands.size())
+					{
+						state.notBefore = 0;
+						readyPeers.push_back(command.peer);
+						continue;
+					}
+					_provisionedPeers[state.peerInfo.address] = getHash(state.peerInfo);
+				}
+				else
+				{
+					bool pending = response.size() == 9 && response.at(6) == 8;
+					if(!pending) state.failures++;
+					if(state.attempts < _maxAttempts && state.failures < _maxFailures)
+					{
+						//Operation pending or no valid response => resend
+						retries++;
+						state.notBefore = pending ? BaseLib::HelperFunctions::getTime() + _pendingRetryDelay : 0;
+						readyPeers.push_back(command.peer);
+						continue;
+					}
+					_out.printError("Error: Could not add peer with address 0x" + BaseLib::HelperFunctions::getHexString(state.peerInfo.address, 6));
+					_provisionedPeers.erase(state.peerInfo.address);
+					failedPeers++;
+				}
+				finishedPeers++;
+			// }}}
+
+			if(skipUnchanged)
+			{
+				std::lock_guard<std::mutex> statisticsGuard(_statisticsMutex);
+				_statistics.completedPeers = skippedPeers + finishedPeers - failedPeers;
+				_statistics.failedPeers = failedPeers;
+				_statistics.commands = commands;
+				_statistics.retries = retries;
+				_statistics.duration = BaseLib::HelperFunctions::getTime() - startTime;
+				if(progressStep > 0 && finishedPeers % progressStep == 0) _out.printInfo("Info: Sent " + std::to_string(finishedPeers) + " of " + std::to_string(states.size()) + " peers.");
+			}
+		}
+
+		//Wait for the responses of commands still in flight when provisioning was aborted, so their packet indexes are not reused too early.
+		for(auto& command : inFlightCommands)
+		{
+			std::vector<uint8_t> response;
+			int64_t timeout = command.deadline - BaseLib::HelperFunctions::getTime();
+			_waitForResponse(command.packetIndex, timeout > 0 ? timeout : 0, response);
+			_removeRequest(command.packetIndex);
+		}
+
+		if(skipUnchanged)
+		{
+			std::lock_guard<std::mutex> statisticsGuard(_statisticsMutex);
+			_statistics.running = false;
+			_statistics.completedPeers = skippedPeers + finishedPeers - failedPeers;
+			_statistics.failedPeers = failedPeers;
+			_statistics.commands = commands;
+			_statistics.retries = retries;
+			_statistics.duration = BaseLib::HelperFunctions::getTime() - startTime;
+			_statistics.peerListHash = getPeerListHash();
+			_out.printInfo("Info: Sent " + std::to_string(finishedPeers - failedPeers) + " of " + std::to_string(states.size()) + " peers in " + std::to_string(_statistics.duration) + " ms (" + std::to_string(commands) + " commands, " + std::to_string(retries) + " retries, " + std::to_string(failedPeers) + " failed). Peer list hash: " + BaseLib::HelperFunctions::getHexString((int32_t)(_statistics.peerListHash >> 32), 8) + BaseLib::HelperFunctions::getHexString((int32_t)(_statistics.peerListHash & 0xFFFFFFFF), 8));
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		_out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void PeerProvisioner::reset()
+{
+	std::lock_guard<std::mutex> provisionGuard(_provisionMutex);
+	_provisionedPeers.clear();
+}
+
+void PeerProvisioner::remove(int32_t address)
+{
+	std::lock_guard<std::mutex> provisionGuard(_provisionMutex);
+	_provisionedPeers.erase(address);
+}
+
+PeerProvisioner::Statistics PeerProvisioner::getStatistics()
+{
+	std::lock_guard<std::mutex> statisticsGuard(_statisticsMutex);
+	return _statistics;
+}
+
+}
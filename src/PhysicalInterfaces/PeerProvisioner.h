@@ -0,0 +1,160 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+#ifndef PEERPROVISIONER_H_
+#define PEERPROVISIONER_H_
+
+#include <cstdint>
+
+#include "IBidCoSInterface.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace BidCoS
+{
+
+/**
+ * Sends the peers to gateways keeping their own peer table (HM-LGW and HM-MOD-RPI-PCB). Each peer needs a sequence of commands which are
+ * sent one after another, but the commands of up to "window" peers are in flight at the same time. This way provisioning hundreds of peers
+ * doesn't take one round trip per command.
+ *
+ * The provisioner remembers which peers were sent successfully. As long as the gateway keeps its peer table (see "reset()"), peers that
+ * didn't change are skipped.
+ */
+class PeerProvisioner
+{
+public:
+	struct Statistics
+	{
+		bool running = false;
+		uint32_t peers = 0;
+		uint32_t completedPeers = 0;
+		uint32_t skippedPeers = 0;
+		uint32_t failedPeers = 0;
+		uint64_t commands = 0;
+		uint64_t retries = 0;
+		int64_t duration = 0;
+		uint64_t peerListHash = 0;
+	};
+
+	/**
+	 * @param out The output of the interface.
+	 * @param sendRequest Sends a command and returns the packet index its response is expected with.
+	 * @param waitForResponse Waits at most the given number of milliseconds for the response to a packet index. Returns false on timeout.
+	 * @param removeRequest Called when a packet index is not waited for anymore.
+	 * @param stopped Returns true when the interface is stopped and provisioning needs to be aborted.
+	 * @param responseTimeout The time in milliseconds to wait for the response to a command.
+	 */
+	PeerProvisioner(BaseLib::Output& out, std::function<uint8_t(const std::vector<char>&)> sendRequest, std::function<bool(uint8_t, int64_t, std::vector<uint8_t>&)> waitForResponse, std::function<void(uint8_t)> removeRequest, std::function<bool()> stopped, int64_t responseTimeout);
+	virtual ~PeerProvisioner() = default;
+
+	/**
+	 * Sends the peers to the gateway.
+	 *
+	 * @param peers The peers to send.
+	 * @param skipUnchanged Skip peers which were sent before and didn't change since.
+	 */
+	void provision(const std::vector<IBidCoSInterface::PeerInfo>& peers, bool skipUnchanged);
+
+	/**
+	 * Forgets all sent peers. Needs to be called when the gateway lost its peer table, e. g. after it was restarted.
+	 */
+	void reset();
+
+	/**
+	 * Forgets a peer that was removed from the gateway.
+	 */
+	void remove(int32_t address);
+
+	/**
+	 * Returns the counters of the current or last run of "provision()" with "skipUnchanged" set, i. e. of the provisioning after (re)connecting.
+	 */
+	Statistics getStatistics();
+
+	static uint64_t getHash(const IBidCoSInterface::PeerInfo& peerInfo);
+private:
+	struct Command
+	{
+		std::vector<char> payload;
+		uint32_t minimumResponseSize = 0;
+		uint8_t responseCode = 0;
+	};
+
+	struct PeerState
+	{
+		IBidCoSInterface::PeerInfo peerInfo;
+		std::vector<Command> commands;
+		uint32_t commandIndex = 0;
+		int32_t attempts = 0;
+		int32_t failures = 0;
+		int64_t notBefore = 0;
+	};
+
+	struct InFlightCommand
+	{
+		uint8_t packetIndex = 0;
+		uint32_t peer = 0;
+		int64_t deadline = 0;
+	};
+
+	static constexpr int32_t _maxAttempts = 40;
+	static constexpr int32_t _maxFailures = 3;
+	static constexpr int64_t _pendingRetryDelay = 50;
+
+	BaseLib::Output& _out;
+	std::function<uint8_t(const std::vector<char>&)> _sendRequest;
+	std::function<bool(uint8_t, int64_t, std::vector<uint8_t>&)> _waitForResponse;
+	std::function<void(uint8_t)> _removeRequest;
+	std::function<bool()> _stopped;
+	int64_t _responseTimeout = 10000;
+	uint32_t _window = 4;
+
+	std::mutex _provisionMutex;
+	std::mutex _statisticsMutex;
+	Statistics _statistics;
+
+	/**
+	 * The hash of each peer as it was last sent successfully.
+	 */
+	std::map<int32_t, uint64_t> _provisionedPeers;
+
+	static std::vector<Command> getCommands(const IBidCoSInterface::PeerInfo& peerInfo);
+
+	/**
+	 * Hash over "_provisionedPeers". "_provisionMutex" must be locked.
+	 */
+	uint64_t getPeerListHash();
+};
+
+}
+#endif
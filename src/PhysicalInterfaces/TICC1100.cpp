@@ -446,8 +446,10 @@ void TICC1100::forceSendPacket(std::shared_ptr<BidCoSPacket> packet)
 		if(_fileDescriptor->descriptor == -1 || _gpioDescriptors[1]->descriptor == -1 || _stopped) return;
 		if(!packet) return;
         bool burst = packet->controlByte() & 0x10;
-		std::vector<uint8_t> decodedPacket = packet->byteArray();
-		std::vector<uint8_t> encodedPacket(decodedPacket.size());
+		BidCoSPacket::FrameBuffer decodedPacket;
+		uint32_t frameSize = packet->byteArray(decodedPacket.data(), decodedPacket.size());
+		if(frameSize == 0) return;
+		std::vector<uint8_t> encodedPacket(frameSize);
 		encodedPacket[0] = decodedPacket[0];
 		encodedPacket[1] = (~decodedPacket[1]) ^ 0x89;
 		uint32_t i = 2;
@@ -955,8 +957,8 @@ void TICC1100::mainThread()
 						{
 							uint8_t firstByte = readRegister(Registers::Enum::FIFO);
 							std::vector<uint8_t> encodedData = readRegisters(Registers::Enum::FIFO, firstByte + 1); //Read packet + RSSI
-							std::vector<uint8_t> decodedData(encodedData.size());
-							if(decodedData.size() > 200)
+							BidCoSPacket::FrameBuffer decodedData;
+							if(encodedData.size() > 200)
 							{
 								if(!_firstPacket)
 								{
@@ -978,7 +980,7 @@ void TICC1100::mainThread()
 								decodedData[i] = encodedData[i] ^ decodedData[2];
 								decodedData[i + 1] = encodedData[i + 1]; //RSSI_DEVICE
 
-								packet.reset(new BidCoSPacket(decodedData, true, BaseLib::HelperFunctions::getTime()));
+								packet = _packetPool.create(decodedData.data(), encodedData.size(), true, BaseLib::HelperFunctions::getTime());
 							}
 							else _out.printInfo("Info: Ignoring too small packet: " + BaseLib::HelperFunctions::getHexString(encodedData));
 						}
@@ -0,0 +1,199 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+//Checks the airtime accounting of AirtimeScheduler, the order in which concurrent senders get the transmit slot and the pacing of bulk frames.
+
+#include "../src/PhysicalInterfaces/AirtimeScheduler.h"
+#include "../src/GD.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define CHECK(condition) if(!(condition)) { std::cerr << __FILE__ << ":" << __LINE__ << ": Check failed: " #condition << std::endl; std::exit(1); }
+
+using namespace BidCoS;
+
+namespace
+{
+typedef AirtimeScheduler::TrafficClass TrafficClass;
+
+std::shared_ptr<BidCoSPacket> createPacket(uint8_t controlByte, uint8_t messageType, uint32_t payloadSize)
+{
+	std::vector<uint8_t> payload(payloadSize, 0x01);
+	return std::make_shared<BidCoSPacket>(0, controlByte, messageType, 0x1, 0x2, payload);
+}
+
+void waitForBacklog(AirtimeScheduler& scheduler, std::array<uint32_t, 3> backlog)
+{
+	for(int32_t i = 0; i < 5000 && scheduler.getStatistics().backlog != backlog; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	CHECK(scheduler.getStatistics().backlog == backlog);
+}
+
+void testClassification()
+{
+	CHECK(AirtimeScheduler::classify(createPacket(0x80, 0x02, 1)) == TrafficClass::acknowledgement);
+	CHECK(AirtimeScheduler::classify(createPacket(0x80, 0x03, 1)) == TrafficClass::acknowledgement);
+	CHECK(AirtimeScheduler::classify(createPacket(0xA0, 0x01, 1)) == TrafficClass::bulk);
+	CHECK(AirtimeScheduler::classify(createPacket(0x00, 0xCA, 1)) == TrafficClass::bulk);
+	CHECK(AirtimeScheduler::classify(createPacket(0xB0, 0x11, 1)) == TrafficClass::interactive);
+	CHECK(AirtimeScheduler::classify(createPacket(0x84, 0x40, 1)) == TrafficClass::interactive);
+
+	//Preamble, sync word, length byte, 9 header bytes, payload and CRC at 10 bits per millisecond
+	CHECK(AirtimeScheduler::estimateAirtime(createPacket(0xA0, 0x11, 2)) == 18);
+	CHECK(AirtimeScheduler::estimateAirtime(createPacket(0xA0, 0x11, 3)) == 19);
+	//Burst frames add the wake up preamble.
+	CHECK(AirtimeScheduler::estimateAirtime(createPacket(0xB0, 0x11, 2)) == 378);
+}
+
+void testBudget()
+{
+	AirtimeScheduler scheduler;
+	AirtimeScheduler::Statistics statistics = scheduler.getStatistics();
+	CHECK(statistics.budget == 36000 && statistics.used == 0 && statistics.remaining == 36000 && statistics.frames == 0);
+	scheduler.record(1000);
+	scheduler.record(500);
+	statistics = scheduler.getStatistics();
+	CHECK(statistics.used == 1500 && statistics.remaining == 34500 && statistics.frames == 2);
+	scheduler.record(40000);
+	statistics = scheduler.getStatistics();
+	CHECK(statistics.used == 41500 && statistics.remaining == 0 && statistics.frames == 3);
+
+	CHECK(statistics.loadHint == AirtimeScheduler::LoadHint::none);
+	scheduler.setLoadHint(AirtimeScheduler::LoadHint::highLoad);
+	CHECK(scheduler.getStatistics().loadHint == AirtimeScheduler::LoadHint::highLoad);
+}
+
+void testPriority()
+{
+	AirtimeScheduler scheduler;
+	std::mutex orderMutex;
+	std::vector<int32_t> order;
+	auto send = [&](TrafficClass trafficClass, int32_t id)
+	{
+		AirtimeScheduler::Slot slot(scheduler, trafficClass, 10);
+		std::lock_guard<std::mutex> orderGuard(orderMutex);
+		order.push_back(id);
+	};
+
+	std::vector<std::thread> threads;
+	{
+		//Hold the slot, so all senders below have to wait.
+		AirtimeScheduler::Slot slot(scheduler, TrafficClass::interactive, 10);
+		threads.emplace_back(send, TrafficClass::bulk, 5);
+		waitForBacklog(scheduler, {0, 0, 1});
+		threads.emplace_back(send, TrafficClass::interactive, 3);
+		waitForBacklog(scheduler, {0, 1, 1});
+		threads.emplace_back(send, TrafficClass::bulk, 6);
+		waitForBacklog(scheduler, {0, 1, 2});
+		threads.emplace_back(send, TrafficClass::interactive, 4);
+		waitForBacklog(scheduler, {0, 2, 2});
+		threads.emplace_back(send, TrafficClass::acknowledgement, 1);
+		waitForBacklog(scheduler, {1, 2, 2});
+		threads.emplace_back(send, TrafficClass::acknowledgement, 2);
+		waitForBacklog(scheduler, {2, 2, 2});
+	}
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	//Higher classes first, each class in the order the senders arrived.
+	CHECK(order == std::vector<int32_t>({1, 2, 3, 4, 5, 6}));
+	CHECK(scheduler.getStatistics().backlog == (std::array<uint32_t, 3>{0, 0, 0}));
+}
+
+void testBulkPacing()
+{
+	{
+		//Enough budget left: Bulk frames are not deferred.
+		AirtimeScheduler scheduler;
+		for(int32_t i = 0; i < 3; i++)
+		{
+			AirtimeScheduler::Slot slot(scheduler, TrafficClass::bulk, 10);
+		}
+		CHECK(scheduler.getStatistics().deferredFrames == 0);
+	}
+
+	{
+		//Less than the bulk reserve left: The second bulk frame waits for 99 times the airtime of the first one.
+		AirtimeScheduler scheduler;
+		scheduler.record(27000);
+		auto startTime = std::chrono::steady_clock::now();
+		{
+			AirtimeScheduler::Slot slot(scheduler, TrafficClass::bulk, 5);
+		}
+		{
+			AirtimeScheduler::Slot slot(scheduler, TrafficClass::bulk, 5);
+		}
+		int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+		CHECK(scheduler.getStatistics().deferredFrames == 1);
+		CHECK(elapsed >= 480);
+		{
+			//Interactive frames are never paced.
+			AirtimeScheduler::Slot slot(scheduler, TrafficClass::interactive, 5);
+		}
+		CHECK(scheduler.getStatistics().deferredFrames == 1);
+	}
+
+	{
+		//A load hint of the stick paces bulk frames even with enough budget left.
+		AirtimeScheduler scheduler;
+		scheduler.setLoadHint(AirtimeScheduler::LoadHint::highLoad);
+		{
+			AirtimeScheduler::Slot slot(scheduler, TrafficClass::bulk, 2);
+		}
+		{
+			AirtimeScheduler::Slot slot(scheduler, TrafficClass::bulk, 2);
+		}
+		CHECK(scheduler.getStatistics().deferredFrames == 1);
+	}
+}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+	bl.debugLevel = 1;
+	GD::bl = &bl;
+	GD::out.init(&bl);
+
+	testClassification();
+	testBudget();
+	testPriority();
+	testBulkPacing();
+	std::cout << "AirtimeScheduler: All checks passed." << std::endl;
+	return 0;
+}
@@ -0,0 +1,134 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+//Compares the hex decoding and encoding of BidCoSPacket, which use lookup tables, with the std::stoi and std::ostringstream based code used before.
+
+#include "../src/BidCoSPacket.h"
+#include "../src/GD.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace BidCoS;
+
+namespace
+{
+/**
+ * The former BidCoSPacket::import(std::string&, bool) without RSSI handling.
+ */
+void referenceDecode(const std::string& packet, std::vector<uint8_t>& result)
+{
+	result.clear();
+	for(uint32_t i = 1; i + 1 < packet.size(); i += 2)
+	{
+		result.push_back(std::stoi(packet.substr(i, 2), nullptr, 16));
+	}
+}
+
+/**
+ * The former BidCoSPacket::hexString().
+ */
+std::string referenceEncode(const std::vector<uint8_t>& packet)
+{
+	std::ostringstream stringStream;
+	stringStream << std::hex << std::uppercase << std::setfill('0');
+	std::for_each(packet.begin(), packet.end(), [&](uint8_t element) { stringStream << std::setw(2) << (int32_t)element; });
+	return stringStream.str();
+}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+	GD::bl = &bl;
+	GD::out.init(&bl);
+
+	std::mt19937 random(1);
+	std::vector<std::vector<uint8_t>> packets;
+	std::vector<std::string> hexPackets;
+	for(int32_t i = 0; i < 100000; i++)
+	{
+		std::vector<uint8_t> payload(random() % 40 + 1);
+		for(uint8_t& byte : payload)
+		{
+			byte = random() & 0xFF;
+		}
+		BidCoSPacket packet(random() & 0xFF, random() & 0xFF, random() & 0xFF, random() & 0xFFFFFF, random() & 0xFFFFFF, payload);
+		packets.push_back(packet.byteArray());
+		hexPackets.push_back('A' + packet.hexString());
+		if(hexPackets.back() != 'A' + referenceEncode(packets.back()))
+		{
+			std::cerr << "Encoding differs from reference: " << hexPackets.back() << std::endl;
+			return 1;
+		}
+		if(BidCoSPacket(hexPackets.back()).byteArray() != packets.back())
+		{
+			std::cerr << "Decoding differs from reference: " << hexPackets.back() << std::endl;
+			return 1;
+		}
+	}
+
+	for(int32_t run = 0; run < 3; run++)
+	{
+		size_t checksum = 0;
+		auto startTime = std::chrono::steady_clock::now();
+		for(const std::string& hexPacket : hexPackets)
+		{
+			BidCoSPacket packet(hexPacket);
+			checksum += packet.payload().size();
+		}
+		auto decodeTime = std::chrono::steady_clock::now();
+		std::vector<uint8_t> decodedPacket;
+		for(const std::string& hexPacket : hexPackets)
+		{
+			referenceDecode(hexPacket, decodedPacket);
+			checksum += decodedPacket.size();
+		}
+		auto referenceDecodeTime = std::chrono::steady_clock::now();
+		for(const std::vector<uint8_t>& binaryPacket : packets)
+		{
+			BidCoSPacket packet(binaryPacket, false);
+			checksum += packet.hexString().size();
+		}
+		auto encodeTime = std::chrono::steady_clock::now();
+		for(const std::vector<uint8_t>& binaryPacket : packets)
+		{
+			checksum += referenceEncode(binaryPacket).size();
+		}
+		auto referenceEncodeTime = std::chrono::steady_clock::now();
+
+		auto nanosecondsPerPacket = [&](std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+		{
+			return std::chrono::duration<double, std::nano>(end - start).count() / hexPackets.size();
+		};
+		std::cout << "BidCoSPacket hex: decode " << nanosecondsPerPacket(startTime, decodeTime) << " ns/packet (reference " << nanosecondsPerPacket(decodeTime, referenceDecodeTime) << " ns), encode including import " << nanosecondsPerPacket(referenceDecodeTime, encodeTime) << " ns/packet (reference " << nanosecondsPerPacket(encodeTime, referenceEncodeTime) << " ns) [" << checksum << "]" << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,254 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+//Compares the precompiled packet positions (BidCoSPacketPosition) with the floating point based getPosition() and setPosition() used before,
+//using random packets, indexes, sizes, masks and values.
+
+#include "../src/BidCoSPacket.h"
+#include "../src/GD.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#define CHECK(condition) if(!(condition)) { std::cerr << __FILE__ << ":" << __LINE__ << ": Check failed: " #condition << " (index " << index << ", size " << size << ", mask " << mask << ")" << std::endl; std::exit(1); }
+
+using namespace BidCoS;
+
+namespace
+{
+const std::array<uint8_t, 9> bitmask{0xFF, 0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF};
+
+/**
+ * The fields of a packet and the former BidCoSPacket::getPosition() and setPosition(), which calculated byte index, shift and mask on every
+ * call.
+ */
+struct ReferencePacket
+{
+	uint8_t messageCounter = 0;
+	uint8_t controlByte = 0;
+	uint8_t messageType = 0;
+	int32_t senderAddress = 0;
+	int32_t destinationAddress = 0;
+	std::vector<uint8_t> payload;
+
+	std::vector<uint8_t> getPosition(double index, double size, int32_t mask)
+	{
+		std::vector<uint8_t> result;
+		if(size < 0 || index < 0)
+		{
+			result.push_back(0);
+			return result;
+		}
+		if(index < 9)
+		{
+			if(size > 0.8)
+			{
+				result.push_back(0);
+				return result;
+			}
+			uint32_t bitSize = std::lround(size * 10);
+			uint32_t intIndex = std::lround(std::floor(index));
+			uint32_t shift = std::lround(index * 10) % 10;
+			if(intIndex == 0) result.push_back((messageCounter >> shift) & bitmask[bitSize]);
+			else if(intIndex == 1) result.push_back((controlByte >> shift) & bitmask[bitSize]);
+			else if(intIndex == 2) result.push_back((messageType >> shift) & bitmask[bitSize]);
+			else if(intIndex == 3) result.push_back(((senderAddress >> 16) >> shift) & bitmask[bitSize]);
+			else if(intIndex == 4) result.push_back(((senderAddress >> 8) >> shift) & bitmask[bitSize]);
+			else if(intIndex == 5) result.push_back((senderAddress >> shift) & bitmask[bitSize]);
+			else if(intIndex == 6) result.push_back(((destinationAddress >> 16) >> shift) & bitmask[bitSize]);
+			else if(intIndex == 7) result.push_back(((destinationAddress >> 8) >> shift) & bitmask[bitSize]);
+			else if(intIndex == 8) result.push_back((destinationAddress >> shift) & bitmask[bitSize]);
+			return result;
+		}
+		index -= 9;
+		double byteIndex = std::floor(index);
+		int32_t intByteIndex = byteIndex;
+		if(byteIndex >= payload.size())
+		{
+			result.push_back(0);
+			return result;
+		}
+		if(byteIndex != index || size < 0.8)
+		{
+			if(size > 1)
+			{
+				result.push_back(0);
+				return result;
+			}
+			uint32_t bitSize = std::lround(size * 10);
+			if(bitSize > 8) bitSize = 8;
+			result.push_back((payload.at(intByteIndex) >> (std::lround(index * 10) % 10)) & bitmask[bitSize]);
+		}
+		else
+		{
+			uint32_t bytes = (uint32_t)std::ceil(size);
+			uint32_t bitSize = std::lround(size * 10) % 10;
+			if(bitSize > 8) bitSize = 8;
+			if(bytes == 0) bytes = 1;
+			uint8_t currentByte = payload.at(intByteIndex) & bitmask[bitSize];
+			if(mask != -1 && bytes <= 4) currentByte &= (mask >> ((bytes - 1) * 8));
+			result.push_back(currentByte);
+			for(uint32_t i = 1; i < bytes; i++)
+			{
+				if((intByteIndex + i) >= payload.size()) result.push_back(0);
+				else
+				{
+					currentByte = payload.at(intByteIndex + i);
+					if(mask != -1 && bytes <= 4) currentByte &= (mask >> ((bytes - i - 1) * 8));
+					result.push_back(currentByte);
+				}
+			}
+		}
+		if(result.empty()) result.push_back(0);
+		return result;
+	}
+
+	void setPosition(double index, double size, std::vector<uint8_t>& value)
+	{
+		if(size < 0 || index < 9) return;
+		index -= 9;
+		double byteIndex = std::floor(index);
+		if(byteIndex != index || size < 0.8)
+		{
+			if(value.empty()) value.push_back(0);
+			int32_t intByteIndex = byteIndex;
+			if(size > 1.0) return;
+			while((signed)payload.size() - 1 < intByteIndex)
+			{
+				payload.push_back(0);
+			}
+			payload.at(intByteIndex) |= value.at(value.size() - 1) << (std::lround(index * 10) % 10);
+		}
+		else
+		{
+			uint32_t intByteIndex = byteIndex;
+			uint32_t bytes = (uint32_t)std::ceil(size);
+			while(payload.size() < intByteIndex + bytes)
+			{
+				payload.push_back(0);
+			}
+			if(value.empty()) return;
+			uint32_t bitSize = std::lround(size * 10) % 10;
+			if(bitSize > 8) bitSize = 8;
+			if(bytes == 0) bytes = 1;
+			if(bytes <= value.size())
+			{
+				payload.at(intByteIndex) |= value.at(0) & bitmask[bitSize];
+				for(uint32_t i = 1; i < bytes; i++)
+				{
+					payload.at(intByteIndex + i) |= value.at(i);
+				}
+			}
+			else
+			{
+				uint32_t missingBytes = bytes - value.size();
+				for(uint32_t i = 0; i < value.size(); i++)
+				{
+					payload.at(intByteIndex + missingBytes + i) |= value.at(i);
+				}
+			}
+		}
+	}
+};
+
+/**
+ * Returns an index or size in the bit notation of device descriptions, e.g. 10.4.
+ */
+double randomPosition(std::mt19937& random, uint32_t maxByte)
+{
+	return (random() % maxByte) + (random() % 8) / 10.0;
+}
+
+double randomSize(std::mt19937& random)
+{
+	if(random() % 3) return (random() % 9) / 10.0;
+	return (random() % 5) + (random() % 9) / 10.0;
+}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+	bl.debugLevel = 1; //Invalid positions are expected and print errors otherwise.
+	GD::bl = &bl;
+	GD::out.init(&bl);
+
+	std::mt19937 random(1);
+	for(int32_t iteration = 0; iteration < 200000; iteration++)
+	{
+		ReferencePacket reference;
+		reference.payload.resize(random() % 12);
+		for(uint8_t& byte : reference.payload)
+		{
+			byte = random() & 0xFF;
+		}
+		reference.messageCounter = random() & 0xFF;
+		reference.controlByte = random() & 0xFF;
+		reference.messageType = random() & 0xFF;
+		reference.senderAddress = random() & 0xFFFFFF;
+		reference.destinationAddress = random() & 0xFFFFFF;
+		BidCoSPacket packet(reference.messageCounter, reference.controlByte, reference.messageType, reference.senderAddress, reference.destinationAddress, reference.payload);
+
+		double index = randomPosition(random, 25);
+		if(random() % 50 == 0) index = -1;
+		double size = randomSize(random);
+		int32_t mask = (random() % 3) ? -1 : (int32_t)(random() & 0xFFFFFF);
+
+		std::vector<uint8_t> expected = reference.getPosition(index, size, mask);
+		CHECK(packet.getPosition(index, size, mask) == expected);
+
+		BidCoSPacketPosition position(index, size, mask);
+		BidCoSPayload result;
+		packet.getPosition(position, result);
+		CHECK(result.toVector() == expected);
+
+		int32_t expectedInteger = 0;
+		for(uint32_t i = 0; i < expected.size() && i < 4; i++)
+		{
+			expectedInteger = (expectedInteger << 8) | expected[i];
+		}
+		CHECK(packet.getPositionInteger(position) == expectedInteger);
+
+		index = randomPosition(random, 16);
+		size = randomSize(random);
+		std::vector<uint8_t> value(random() % 4);
+		for(uint8_t& byte : value)
+		{
+			byte = random() & 0xFF;
+		}
+		std::vector<uint8_t> referenceValue = value;
+		reference.setPosition(index, size, referenceValue);
+		packet.setPosition(BidCoSPacketPosition(index, size), value);
+		CHECK(packet.payload().toVector() == reference.payload);
+	}
+
+	std::cout << "BidCoSPacketPosition: All checks passed." << std::endl;
+	return 0;
+}
@@ -0,0 +1,187 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+//Compares BidCoSPeerIndex with std::unordered_map, using random adds and removes. Addresses are removed with backward shift deletion, so
+//every address has to stay reachable from its home slot after any removal, also when a probe sequence wraps around the end of the table.
+
+#include "../src/BidCoSPeerIndex.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#define CHECK(condition) if(!(condition)) { std::cerr << __FILE__ << ":" << __LINE__ << ": Check failed: " #condition << std::endl; std::exit(1); }
+
+using namespace BidCoS;
+
+namespace
+{
+/**
+ * BidCoSPeer can't be created without the module, but the index only stores and returns the pointers. The peers are distinct addresses in
+ * "storage", which are never dereferenced.
+ */
+class Peers
+{
+public:
+	explicit Peers(uint32_t count) : _storage(count)
+	{
+		for(uint32_t i = 0; i < count; i++)
+		{
+			_peers.emplace_back(reinterpret_cast<BidCoSPeer*>(&_storage[i]), [](BidCoSPeer*) {});
+		}
+	}
+
+	const std::shared_ptr<BidCoSPeer>& at(uint32_t index) const { return _peers.at(index); }
+private:
+	std::vector<uint64_t> _storage;
+	std::vector<std::shared_ptr<BidCoSPeer>> _peers;
+};
+
+/**
+ * Returns the home slot of an address in the initial table with 64 slots. Same hash as BidCoSPeerIndex::homeSlot().
+ */
+uint32_t initialHomeSlot(int32_t address)
+{
+	return ((uint32_t)address * 2654435769u) >> 26;
+}
+
+void checkAddresses(BidCoSPeerIndex& index, const std::unordered_map<int32_t, std::shared_ptr<BidCoSPeer>>& reference, const std::vector<int32_t>& addresses)
+{
+	for(int32_t address : addresses)
+	{
+		auto referenceIterator = reference.find(address);
+		CHECK(index.getByAddress(address) == (referenceIterator == reference.end() ? std::shared_ptr<BidCoSPeer>() : referenceIterator->second));
+	}
+}
+
+void testRandom(std::mt19937& random, const Peers& peers)
+{
+	for(int32_t iteration = 0; iteration < 500; iteration++)
+	{
+		//Few addresses make collisions, growing and removing the same addresses again likely.
+		std::vector<int32_t> addresses(random() % 300 + 1);
+		for(int32_t& address : addresses)
+		{
+			address = random() & 0xFFFFFF;
+		}
+
+		BidCoSPeerIndex index;
+		std::unordered_map<int32_t, std::shared_ptr<BidCoSPeer>> reference;
+		std::unordered_map<uint64_t, std::shared_ptr<BidCoSPeer>> referenceById;
+		for(int32_t step = 0; step < 1000; step++)
+		{
+			int32_t address = addresses.at(random() % addresses.size());
+			const std::shared_ptr<BidCoSPeer>& peer = peers.at(random() % 1000);
+			uint64_t id = random() % 100;
+			uint32_t operation = random() % 10;
+			if(operation < 5)
+			{
+				index.addByAddress(address, peer);
+				reference[address] = peer;
+				index.addById(id, peer);
+				referenceById[id] = peer;
+			}
+			else
+			{
+				index.removeByAddress(address);
+				reference.erase(address);
+				index.removeById(id);
+				referenceById.erase(id);
+			}
+			CHECK(index.getById(id) == (referenceById.count(id) ? referenceById.at(id) : std::shared_ptr<BidCoSPeer>()));
+			if(step % 50 == 0) checkAddresses(index, reference, addresses);
+		}
+		checkAddresses(index, reference, addresses);
+	}
+}
+
+void testWrapAround(std::mt19937& random, const Peers& peers)
+{
+	//Collect addresses with their home slot at the end of the table, so their probe sequences wrap around. 20 addresses don't make the table
+	//grow.
+	std::vector<int32_t> addresses;
+	while(addresses.size() < 20)
+	{
+		int32_t address = random() & 0xFFFFFF;
+		if(initialHomeSlot(address) >= 60) addresses.push_back(address);
+	}
+
+	for(int32_t iteration = 0; iteration < 10000; iteration++)
+	{
+		BidCoSPeerIndex index;
+		std::unordered_map<int32_t, std::shared_ptr<BidCoSPeer>> reference;
+		std::shuffle(addresses.begin(), addresses.end(), random);
+		for(uint32_t i = 0; i < addresses.size(); i++)
+		{
+			index.addByAddress(addresses[i], peers.at(i));
+			reference[addresses[i]] = peers.at(i);
+		}
+		checkAddresses(index, reference, addresses);
+
+		std::shuffle(addresses.begin(), addresses.end(), random);
+		for(int32_t address : addresses)
+		{
+			index.removeByAddress(address);
+			reference.erase(address);
+			checkAddresses(index, reference, addresses);
+		}
+	}
+}
+
+void testSerialNumbers(const Peers& peers)
+{
+	BidCoSPeerIndex index;
+	index.addBySerial("", peers.at(0));
+	CHECK(!index.getBySerial(""));
+	index.addBySerial("MEQ0000001", peers.at(1));
+	index.addBySerial("MEQ0000002", peers.at(2));
+	index.addBySerial("MEQ0000001", peers.at(3));
+	CHECK(index.getBySerial("MEQ0000001") == peers.at(3));
+	CHECK(index.getBySerial("MEQ0000002") == peers.at(2));
+	index.removeBySerial("MEQ0000001");
+	CHECK(!index.getBySerial("MEQ0000001"));
+	CHECK(index.getBySerial("MEQ0000002") == peers.at(2));
+	index.addByAddress(-1, peers.at(4));
+	CHECK(!index.getByAddress(-1));
+}
+}
+
+int main()
+{
+	std::mt19937 random(1);
+	Peers peers(1000);
+	testRandom(random, peers);
+	testWrapAround(random, peers);
+	testSerialNumbers(peers);
+	std::cout << "BidCoSPeerIndex: All checks passed." << std::endl;
+	return 0;
+}
@@ -0,0 +1,89 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+//Measures the throughput of EscapedFrameDecoder for a stream of valid frames received in chunks of 2048 bytes.
+
+#include "../src/PhysicalInterfaces/EscapedFrameDecoder.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace BidCoS;
+
+int main()
+{
+	CRC16 crc;
+	std::mt19937 random(1);
+	std::vector<uint8_t> stream;
+	size_t frameCount = 0;
+	while(stream.size() < 64 * 1024 * 1024)
+	{
+		uint32_t payloadSize = random() % 30 + 10;
+		std::vector<uint8_t> frame{ 0xFD, (uint8_t)((payloadSize + 1) >> 8), (uint8_t)((payloadSize + 1) & 0xFF) };
+		for(uint32_t i = 0; i < payloadSize + 1; i++)
+		{
+			frame.push_back(random() & 0xFF);
+		}
+		uint16_t frameCrc = crc.calculate(frame);
+		frame.push_back(frameCrc >> 8);
+		frame.push_back(frameCrc & 0xFF);
+
+		stream.push_back(frame.at(0));
+		for(size_t i = 1; i < frame.size(); i++)
+		{
+			if(frame[i] == 0xFC || frame[i] == 0xFD)
+			{
+				stream.push_back(0xFC);
+				stream.push_back(frame[i] & 0x7F);
+			}
+			else stream.push_back(frame[i]);
+		}
+		frameCount++;
+	}
+
+	for(int32_t run = 0; run < 3; run++)
+	{
+		EscapedFrameDecoder decoder;
+		size_t validFrames = 0;
+		auto startTime = std::chrono::steady_clock::now();
+		for(size_t position = 0; position < stream.size(); position += 2048)
+		{
+			decoder.decode(stream.data() + position, std::min<size_t>(2048, stream.size() - position), [&](std::vector<uint8_t>& frame, uint16_t frameCrc)
+			{
+				if(frame.at(frame.size() - 2) == (frameCrc >> 8) && frame.at(frame.size() - 1) == (frameCrc & 0xFF)) validFrames++;
+			}, [](EscapedFrameDecoder::Error, std::vector<uint8_t>&) {});
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		std::cout << "EscapedFrameDecoder: " << (stream.size() / 1048576.0) / seconds << " MB/s, " << frameCount / seconds << " frames/s (" << validFrames << " of " << frameCount << " frames valid)" << std::endl;
+		if(validFrames != frameCount) return 1;
+	}
+	return 0;
+}
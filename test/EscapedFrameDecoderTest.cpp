@@ -0,0 +1,198 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+//Checks EscapedFrameDecoder with random streams split into random chunks and with random garbage.
+
+#include "../src/PhysicalInterfaces/EscapedFrameDecoder.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#define CHECK(condition) if(!(condition)) { std::cerr << __FILE__ << ":" << __LINE__ << ": Check failed: " #condition << std::endl; std::exit(1); }
+
+using namespace BidCoS;
+
+namespace
+{
+CRC16 crc;
+
+std::vector<uint8_t> createFrame(std::mt19937& random, uint32_t payloadSize)
+{
+	std::vector<uint8_t> frame{ 0xFD, (uint8_t)((payloadSize + 1) >> 8), (uint8_t)((payloadSize + 1) & 0xFF) };
+	for(uint32_t i = 0; i < payloadSize + 1; i++)
+	{
+		frame.push_back(random() & 0xFF);
+	}
+	uint16_t frameCrc = crc.calculate(frame);
+	frame.push_back(frameCrc >> 8);
+	frame.push_back(frameCrc & 0xFF);
+	return frame;
+}
+
+void escape(const std::vector<uint8_t>& frame, std::vector<uint8_t>& stream)
+{
+	stream.push_back(frame.at(0));
+	for(size_t i = 1; i < frame.size(); i++)
+	{
+		if(frame[i] == 0xFC || frame[i] == 0xFD)
+		{
+			stream.push_back(0xFC);
+			stream.push_back(frame[i] & 0x7F);
+		}
+		else stream.push_back(frame[i]);
+	}
+}
+
+/**
+ * The decoding loop HM-MOD-RPI-PCB used before EscapedFrameDecoder. Used as reference.
+ */
+class ReferenceDecoder
+{
+public:
+	std::vector<std::vector<uint8_t>> frames;
+
+	void process(const std::vector<uint8_t>& data)
+	{
+		std::vector<uint8_t> packet;
+		if(!_buffer.empty()) packet = _buffer;
+		for(std::vector<uint8_t>::const_iterator i = data.begin(); i != data.end(); ++i)
+		{
+			if(!packet.empty() && *i == 0xFD)
+			{
+				if(packet.size() >= 8) frames.push_back(packet);
+				packet.clear();
+				_escapeByte = false;
+			}
+			if(*i == 0xFC)
+			{
+				_escapeByte = true;
+				continue;
+			}
+			if(_escapeByte)
+			{
+				packet.push_back(*i | 0x80);
+				_escapeByte = false;
+			}
+			else packet.push_back(*i);
+		}
+		int32_t size = (packet.size() > 5) ? (((int32_t)packet.at(1)) << 8) + packet.at(2) + 5 : 0;
+		if(size > 0 && size < 8) return;
+		if(size > 255) return;
+		if(packet.size() < 8 || packet.size() < (unsigned)size) _buffer = packet;
+		else
+		{
+			frames.push_back(packet);
+			_buffer.clear();
+			_escapeByte = false;
+		}
+	}
+private:
+	std::vector<uint8_t> _buffer;
+	bool _escapeByte = false;
+};
+
+void testRandomChunks(std::mt19937& random)
+{
+	for(int32_t iteration = 0; iteration < 20000; iteration++)
+	{
+		std::vector<std::vector<uint8_t>> frames;
+		std::vector<uint8_t> stream;
+		int32_t frameCount = random() % 8 + 1;
+		for(int32_t i = 0; i < frameCount; i++)
+		{
+			frames.push_back(createFrame(random, random() % 60 + 2));
+			escape(frames.back(), stream);
+		}
+
+		EscapedFrameDecoder decoder;
+		ReferenceDecoder referenceDecoder;
+		std::vector<std::vector<uint8_t>> decodedFrames;
+		size_t position = 0;
+		while(position < stream.size())
+		{
+			size_t chunkSize = std::min<size_t>(stream.size() - position, random() % 40 + 1);
+			decoder.decode(stream.data() + position, chunkSize, [&](std::vector<uint8_t>& frame, uint16_t frameCrc)
+			{
+				CHECK(frame.at(frame.size() - 2) == (frameCrc >> 8) && frame.at(frame.size() - 1) == (frameCrc & 0xFF));
+				decodedFrames.push_back(frame);
+			}, [&](EscapedFrameDecoder::Error, std::vector<uint8_t>&)
+			{
+				CHECK(false);
+			});
+			referenceDecoder.process(std::vector<uint8_t>(stream.begin() + position, stream.begin() + position + chunkSize));
+			position += chunkSize;
+		}
+		CHECK(decodedFrames == frames);
+		CHECK(referenceDecoder.frames == frames);
+	}
+}
+
+void testGarbage(std::mt19937& random)
+{
+	for(int32_t iteration = 0; iteration < 200000; iteration++)
+	{
+		std::vector<uint8_t> data(random() % 300);
+		for(uint8_t& byte : data)
+		{
+			uint32_t value = random();
+			if(value % 11 == 0) byte = 0;
+			else if(value % 5 == 0) byte = 0xFD;
+			else if(value % 7 == 0) byte = 0xFC;
+			else byte = (value >> 8) & 0xFF;
+		}
+
+		EscapedFrameDecoder decoder(255);
+		size_t position = 0;
+		while(position < data.size())
+		{
+			size_t chunkSize = std::min<size_t>(data.size() - position, random() % 64 + 1);
+			decoder.decode(data.data() + position, chunkSize, [&](std::vector<uint8_t>& frame, uint16_t frameCrc)
+			{
+				CHECK(frame.size() >= 8 && frame.size() <= 255);
+				CHECK(frameCrc == crc.calculate(frame, true));
+			}, [&](EscapedFrameDecoder::Error, std::vector<uint8_t>& header)
+			{
+				CHECK(header.size() == 3);
+			});
+			position += chunkSize;
+		}
+	}
+}
+}
+
+int main()
+{
+	std::mt19937 random(1);
+	testRandomChunks(random);
+	testGarbage(random);
+	std::cout << "EscapedFrameDecoder: All checks passed." << std::endl;
+	return 0;
+}
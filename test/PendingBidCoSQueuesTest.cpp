@@ -0,0 +1,228 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * Homegear is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Homegear is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Homegear.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+
+//Compares PendingBidCoSQueues with a list which is searched linearly, using random pushes, starts, pops, replaces and removes. PEER and GETVALUE
+//queues which were not started yet are replaced at their position by newer queues for the same parameter and channel.
+
+#include "../src/PendingBidCoSQueues.h"
+#include "../src/GD.h"
+
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <random>
+
+#define CHECK(condition) if(!(condition)) { std::cerr << __FILE__ << ":" << __LINE__ << ": Check failed: " #condition << " (iteration " << iteration << ")" << std::endl; std::exit(1); }
+
+using namespace BidCoS;
+
+namespace
+{
+const std::array<std::string, 3> parameterNames{"STATE", "LEVEL", ""};
+
+struct ReferenceQueue
+{
+	uint32_t id = 0;
+	BidCoSQueueType type = BidCoSQueueType::EMPTY;
+	int32_t channel = -1;
+	std::string parameterName;
+	bool started = false;
+};
+
+/**
+ * The expected order of the queues. A new queue replaces the last queue for the same parameter, when that one is supersedable and was not
+ * started yet.
+ */
+class ReferenceQueues
+{
+public:
+	std::list<ReferenceQueue> queues;
+
+	std::list<ReferenceQueue>::iterator findLast(BidCoSQueueType type, const std::string& parameterName, int32_t channel)
+	{
+		if(parameterName.empty()) return queues.end();
+		for(auto i = queues.rbegin(); i != queues.rend(); ++i)
+		{
+			if(i->type == type && i->parameterName == parameterName && i->channel == channel) return std::prev(i.base());
+		}
+		return queues.end();
+	}
+
+	void push(const ReferenceQueue& queue)
+	{
+		if(queue.type == BidCoSQueueType::PEER || queue.type == BidCoSQueueType::GETVALUE)
+		{
+			auto queueIterator = findLast(queue.type, queue.parameterName, queue.channel);
+			if(queueIterator != queues.end() && !queueIterator->started)
+			{
+				*queueIterator = queue;
+				return;
+			}
+		}
+		queues.push_back(queue);
+	}
+
+	void remove(BidCoSQueueType type, const std::string& parameterName, int32_t channel)
+	{
+		if(parameterName.empty()) return;
+		auto queueIterator = findLast(type, parameterName, channel);
+		if(queueIterator != queues.end()) queues.erase(queueIterator);
+		//A started queue at the front can be an older queue for the same parameter.
+		if(!queues.empty() && queues.front().type == type && queues.front().parameterName == parameterName && queues.front().channel == channel) queues.pop_front();
+	}
+};
+
+std::shared_ptr<BidCoSQueue> createQueue(const ReferenceQueue& reference)
+{
+	std::shared_ptr<BidCoSQueue> queue = std::make_shared<BidCoSQueue>(std::shared_ptr<IBidCoSInterface>(), reference.type);
+	queue->noSending = true;
+	queue->id = reference.id;
+	queue->channel = reference.channel;
+	queue->parameterName = reference.parameterName;
+	std::vector<uint8_t> payload{0x01, (uint8_t)reference.channel, (uint8_t)(reference.id & 0xFF)};
+	queue->push(std::make_shared<BidCoSPacket>(0, 0xA0, 0x11, 0x1, 0x2, payload));
+	return queue;
+}
+
+ReferenceQueue createReference(std::mt19937& random, uint32_t id)
+{
+	ReferenceQueue reference;
+	reference.id = id;
+	uint32_t type = random() % 3;
+	reference.type = type == 0 ? BidCoSQueueType::PEER : (type == 1 ? BidCoSQueueType::GETVALUE : BidCoSQueueType::CONFIG);
+	reference.channel = random() % 3;
+	//CONFIG queues don't have a parameter name.
+	if(reference.type != BidCoSQueueType::CONFIG) reference.parameterName = parameterNames.at(random() % parameterNames.size());
+	return reference;
+}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+	bl.debugLevel = 1;
+	GD::bl = &bl;
+	GD::out.init(&bl);
+
+	std::mt19937 random(1);
+	uint32_t id = 1;
+	for(int32_t iteration = 0; iteration < 2000; iteration++)
+	{
+		PendingBidCoSQueues pendingQueues;
+		ReferenceQueues reference;
+		bool empty = true;
+		pendingQueues.setChangedCallback([&](bool queuesEmpty) { empty = queuesEmpty; });
+
+		for(int32_t step = 0; step < 200; step++)
+		{
+			uint32_t operation = random() % 100;
+			if(operation < 55)
+			{
+				ReferenceQueue queue = createReference(random, id++);
+				pendingQueues.push(createQueue(queue));
+				reference.push(queue);
+			}
+			else if(operation < 65)
+			{
+				std::shared_ptr<BidCoSQueue> queue = pendingQueues.start();
+				CHECK(reference.queues.empty() == !queue);
+				if(queue)
+				{
+					CHECK(queue->id == reference.queues.front().id);
+					reference.queues.front().started = true;
+				}
+			}
+			else if(operation < 80)
+			{
+				pendingQueues.pop();
+				if(!reference.queues.empty()) reference.queues.pop_front();
+			}
+			else if(operation < 92)
+			{
+				ReferenceQueue queue = createReference(random, id++);
+				std::shared_ptr<BidCoSQueue> oldQueue = pendingQueues.findUnstarted(queue.type, queue.parameterName, queue.channel);
+				auto referenceIterator = reference.findLast(queue.type, queue.parameterName, queue.channel);
+				bool replaceable = referenceIterator != reference.queues.end() && !referenceIterator->started;
+				CHECK((bool)oldQueue == replaceable);
+				if(oldQueue)
+				{
+					CHECK(oldQueue->id == referenceIterator->id);
+					CHECK(pendingQueues.replace(oldQueue, createQueue(queue)));
+					*referenceIterator = queue;
+					//The old queue is not in the queues anymore.
+					CHECK(!pendingQueues.replace(oldQueue, createQueue(queue)));
+				}
+				if(!reference.queues.empty() && reference.queues.front().started && !reference.queues.front().parameterName.empty())
+				{
+					ReferenceQueue front = reference.queues.front();
+					front.id = id++;
+					CHECK(!pendingQueues.replace(pendingQueues.front(), createQueue(front)));
+				}
+			}
+			else if(operation < 99)
+			{
+				ReferenceQueue queue = createReference(random, 0);
+				pendingQueues.remove(queue.type, queue.parameterName, queue.channel);
+				reference.remove(queue.type, queue.parameterName, queue.channel);
+			}
+			else
+			{
+				pendingQueues.clear();
+				reference.queues.clear();
+			}
+
+			CHECK(pendingQueues.size() == reference.queues.size());
+			CHECK(pendingQueues.empty() == reference.queues.empty());
+			if(!reference.queues.empty()) CHECK(pendingQueues.front()->id == reference.queues.front().id);
+			CHECK(empty == reference.queues.empty());
+			for(uint32_t channel = 0; channel < 3; channel++)
+			{
+				for(const std::string& parameterName : parameterNames)
+				{
+					for(BidCoSQueueType type : {BidCoSQueueType::PEER, BidCoSQueueType::GETVALUE})
+					{
+						CHECK(pendingQueues.exists(type, parameterName, channel) == (reference.findLast(type, parameterName, channel) != reference.queues.end()));
+					}
+				}
+			}
+		}
+
+		while(!reference.queues.empty())
+		{
+			CHECK(pendingQueues.front()->id == reference.queues.front().id);
+			pendingQueues.pop();
+			reference.queues.pop_front();
+		}
+		CHECK(pendingQueues.empty() && empty);
+	}
+
+	std::cout << "PendingBidCoSQueues: All checks passed." << std::endl;
+	return 0;
+}